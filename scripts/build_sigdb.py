@@ -0,0 +1,160 @@
+"""
+Build a Flock-You signature database file.
+
+    python scripts/build_sigdb.py signatures.json sigdb.bin [--version N]
+
+The input uses the same shape /api/patterns returns, so the easiest start is
+to save that from a running unit and edit it:
+
+    {
+      "version": 20261016,
+      "macs":  ["58:8e:81", ...],
+      "names": ["Flock", ...],
+      "mfr":   [2504, ...],
+      "raven": ["00003100-0000-1000-8000-00805f9b34fb", ...]
+    }
+
+A "raven" entry may also be {"uuid": "...", "bit": N} to pick the service's
+bit in the firmware's FY_SVC_* mask. Plain strings get the bit of the matching
+compiled-in Raven service, or FY_SVC_OTHER for anything new.
+
+Upload the result from the dashboard (TOOLS > SIGNATURE DATABASE) or with:
+
+    curl -F file=@sigdb.bin http://192.168.4.1/api/patterns/upload
+
+The layout must match FYSigHeader / FYSigService in src/raw/flockyou.cpp.
+"""
+
+import argparse
+import json
+import re
+import struct
+import sys
+import zlib
+
+MAGIC = 0x47535946  # "FYSG"
+FORMAT = 1
+MAX_BYTES = 65536
+
+# Compiled-in Raven services and their FY_SVC_* bits
+KNOWN_SERVICES = {
+    "0000180a-0000-1000-8000-00805f9b34fb": 0,  # device info
+    "00003100-0000-1000-8000-00805f9b34fb": 1,  # GPS
+    "00003200-0000-1000-8000-00805f9b34fb": 2,  # power
+    "00003300-0000-1000-8000-00805f9b34fb": 3,  # network
+    "00003400-0000-1000-8000-00805f9b34fb": 4,  # upload
+    "00003500-0000-1000-8000-00805f9b34fb": 5,  # error
+    "00001809-0000-1000-8000-00805f9b34fb": 6,  # old health
+    "00001819-0000-1000-8000-00805f9b34fb": 7,  # old location
+}
+FY_SVC_OTHER = 8
+
+OUI = re.compile(r"^([0-9a-f]{2})[:-]?([0-9a-f]{2})[:-]?([0-9a-f]{2})$")
+UUID128 = re.compile(r"^[0-9a-f]{8}-?[0-9a-f]{4}-?[0-9a-f]{4}-?[0-9a-f]{4}-?[0-9a-f]{12}$")
+
+
+def fail(msg):
+    sys.exit("build_sigdb: " + msg)
+
+
+def parse_ouis(items):
+    out = set()
+    for item in items:
+        m = OUI.match(str(item).strip().lower())
+        if not m:
+            fail("bad MAC prefix %r" % item)
+        out.add(int(m.group(1) + m.group(2) + m.group(3), 16))
+    return sorted(out)
+
+
+def parse_services(items):
+    out = {}
+    for item in items:
+        if isinstance(item, dict):
+            uuid, bit = str(item.get("uuid", "")), item.get("bit")
+        else:
+            uuid, bit = str(item), None
+        uuid = uuid.strip().lower()
+        if not UUID128.match(uuid):
+            fail("bad 128-bit UUID %r" % uuid)
+        uuid = uuid.replace("-", "")
+        uuid = "-".join((uuid[:8], uuid[8:12], uuid[12:16], uuid[16:20], uuid[20:]))
+        if bit is None:
+            bit = KNOWN_SERVICES.get(uuid, FY_SVC_OTHER)
+        if not 0 <= int(bit) < 32:
+            fail("bit for %s out of range" % uuid)
+        # NimBLE native order: least significant byte first
+        native = bytes.fromhex(uuid.replace("-", ""))[::-1]
+        out[native] = int(bit)
+    return sorted(out.items())
+
+
+def parse_mfr(items):
+    out = set()
+    for item in items:
+        value = int(item, 0) if isinstance(item, str) else int(item)
+        if not 0 <= value <= 0xFFFF:
+            fail("manufacturer ID %r out of range" % item)
+        out.add(value)
+    return sorted(out)
+
+
+def parse_names(items):
+    out = []
+    for item in items:
+        name = str(item)
+        if not name:
+            continue
+        if any(ord(c) < 0x20 or ord(c) > 0x7E or c in '"\\' for c in name):
+            fail("name %r must be printable ASCII without quotes or backslashes" % name)
+        if name not in out:
+            out.append(name)
+    return out
+
+
+def build(sig, version):
+    ouis = parse_ouis(sig.get("macs", []))
+    services = parse_services(sig.get("raven", []))
+    mfr = parse_mfr(sig.get("mfr", []))
+    names = parse_names(sig.get("names", []))
+    for label, items in (("macs", ouis), ("raven", services), ("mfr", mfr), ("names", names)):
+        if len(items) > 0xFFFF:
+            fail("too many %s entries" % label)
+
+    body = b"".join(struct.pack("<I", o) for o in ouis)
+    body += b"".join(uuid + struct.pack("<B3x", bit) for uuid, bit in services)
+    body += b"".join(struct.pack("<H", m) for m in mfr)
+    blob = b"".join(n.encode("ascii") + b"\0" for n in names)
+    body += blob
+
+    header = struct.pack("<IHHIIHHHHII", MAGIC, FORMAT, 32, version,
+                         zlib.crc32(body) & 0xFFFFFFFF,
+                         len(ouis), len(services), len(mfr), len(names), len(blob), 0)
+    data = header + body
+    if len(data) > MAX_BYTES:
+        fail("database is %d bytes, firmware accepts at most %d" % (len(data), MAX_BYTES))
+    return data, (len(ouis), len(names), len(mfr), len(services))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    ap.add_argument("input", help="signature JSON")
+    ap.add_argument("output", help="binary database to write")
+    ap.add_argument("--version", type=int, help="database version (overrides the JSON)")
+    args = ap.parse_args()
+
+    with open(args.input, encoding="utf-8") as f:
+        sig = json.load(f)
+    version = args.version if args.version is not None else sig.get("version")
+    if not isinstance(version, int) or not 0 < version <= 0xFFFFFFFF:
+        fail("set a positive \"version\" in the JSON or pass --version")
+
+    data, counts = build(sig, version)
+    with open(args.output, "wb") as f:
+        f.write(data)
+    print("build_sigdb: v%d %d OUIs, %d names, %d mfr IDs, %d UUIDs -> %s (%d bytes)"
+          % ((version,) + counts + (args.output, len(data))))
+
+
+if __name__ == "__main__":
+    main()
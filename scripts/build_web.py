@@ -0,0 +1,91 @@
+"""
+Minify and gzip the web UI pages into PROGMEM headers.
+
+Runs as a PlatformIO pre-build script (extra_scripts in platformio.ini) and
+can also be run by hand:  python scripts/build_web.py
+
+  web/<page>.html  ->  src/web/<page>_html.h   (<PAGE>_HTML_GZ, <PAGE>_HTML_GZ_LEN)
+
+Pages are served as-is with "Content-Encoding: gzip"; anything that changes
+at runtime is fetched by the page from the mode's /api/settings endpoint.
+Headers are only rewritten when their content changes, so unchanged pages do
+not trigger a rebuild.
+"""
+
+import gzip
+import os
+import re
+
+try:
+    Import("env")  # noqa: F821 - provided by PlatformIO
+    PROJECT_DIR = env["PROJECT_DIR"]  # noqa: F821
+except NameError:
+    PROJECT_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+WEB_DIR = os.path.join(PROJECT_DIR, "web")
+OUT_DIR = os.path.join(PROJECT_DIR, "src", "web")
+
+# Whitespace is significant inside these; they are copied verbatim
+PRESERVE = re.compile(
+    r'(<textarea\b.*?</textarea>|<pre\b.*?</pre>|<div class="ascii-background">.*?</div>)',
+    re.S)
+COMMENT = re.compile(r"<!--.*?-->", re.S)
+
+
+def minify(html):
+    out = []
+    for i, part in enumerate(PRESERVE.split(html)):
+        if i % 2:
+            out.append(part)
+            continue
+        part = COMMENT.sub("", part)
+        # Keep line breaks (JS relies on them without semicolons), drop indentation
+        lines = [line.strip() for line in part.split("\n")]
+        out.append("\n".join(line for line in lines if line))
+    return "".join(out)
+
+
+def to_header(page, data, source_name):
+    symbol = page.upper() + "_HTML_GZ"
+    guard = "WEB_" + page.upper() + "_HTML_H"
+    rows = []
+    for i in range(0, len(data), 20):
+        rows.append("    " + ",".join("0x%02x" % b for b in data[i:i + 20]) + ",")
+    return (
+        "// Generated by scripts/build_web.py from web/%s - do not edit\n"
+        "#ifndef %s\n"
+        "#define %s\n"
+        "\n"
+        "static const size_t %s_LEN = %d;\n"
+        "static const uint8_t %s[] PROGMEM = {\n"
+        "%s\n"
+        "};\n"
+        "\n"
+        "#endif // %s\n"
+    ) % (source_name, guard, guard, symbol, len(data), symbol, "\n".join(rows), guard)
+
+
+def build():
+    os.makedirs(OUT_DIR, exist_ok=True)
+    for name in sorted(os.listdir(WEB_DIR)):
+        if not name.endswith(".html"):
+            continue
+        page = name[:-len(".html")]
+        with open(os.path.join(WEB_DIR, name), encoding="utf-8") as f:
+            html = f.read()
+        small = minify(html).encode("utf-8")
+        # mtime=0 keeps the output byte-identical between builds
+        data = gzip.compress(small, compresslevel=9, mtime=0)
+        header = to_header(page, data, name)
+
+        out_path = os.path.join(OUT_DIR, page + "_html.h")
+        if os.path.exists(out_path):
+            with open(out_path, encoding="utf-8") as f:
+                if f.read() == header:
+                    continue
+        with open(out_path, "w", encoding="utf-8") as f:
+            f.write(header)
+        print("build_web: %s %d -> %d -> %d bytes gzip" % (name, len(html), len(small), len(data)))
+
+
+build()
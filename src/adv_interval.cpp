@@ -0,0 +1,69 @@
+/*
+ * Advertising Interval Statistics - see adv_interval.h
+ */
+
+#include <Arduino.h>
+#include <math.h>
+#include "adv_interval.h"
+
+static int advIntervalBucket(uint32_t gapMs) {
+    int b = (31 - __builtin_clz(gapMs)) - 4;  // 16 ms -> bucket 0
+    if (b < 0) b = 0;
+    if (b >= ADV_INTERVAL_BUCKETS) b = ADV_INTERVAL_BUCKETS - 1;
+    return b;
+}
+
+void advIntervalAdd(AdvInterval& s, uint32_t nowMs, uint32_t scanStartMs) {
+    if (nowMs == 0) nowMs = 1;  // 0 means "none yet"
+    uint32_t gap = nowMs - s.lastMs;
+    if (s.lastMs != 0 && gap < ADV_INTERVAL_MIN_MS) return;  // Keep the event's first report
+    bool counted = s.lastMs != 0 && s.lastMs >= scanStartMs && gap <= ADV_INTERVAL_MAX_MS;
+    s.lastMs = nowMs;
+    if (!counted) return;
+
+    // Welford; once n is capped the oldest share of m2 is aged out instead
+    if (s.n < ADV_INTERVAL_MAX_N) s.n++;
+    else s.m2 -= s.m2 / s.n;
+    float x = (float)gap;
+    float delta = x - s.mean;
+    s.mean += delta / s.n;
+    s.m2 += delta * (x - s.mean);
+
+    uint8_t& h = s.hist[advIntervalBucket(gap)];
+    if (h == 255) {
+        for (int i = 0; i < ADV_INTERVAL_BUCKETS; i++) s.hist[i] >>= 1;
+    }
+    h++;
+}
+
+float advIntervalStddev(const AdvInterval& s) {
+    return s.n > 1 ? sqrtf(fmaxf(s.m2, 0) / (s.n - 1)) : 0;
+}
+
+uint32_t advIntervalMode(const AdvInterval& s) {
+    int best = -1;
+    for (int i = 0; i < ADV_INTERVAL_BUCKETS; i++) {
+        if (s.hist[i] && (best < 0 || s.hist[i] > s.hist[best])) best = i;
+    }
+    return best < 0 ? 0 : 16UL << best;
+}
+
+bool advIntervalSteady(const AdvInterval& s) {
+    unsigned total = 0, pair = 0;
+    for (int i = 0; i < ADV_INTERVAL_BUCKETS; i++) {
+        total += s.hist[i];
+        unsigned p = s.hist[i] + (i + 1 < ADV_INTERVAL_BUCKETS ? s.hist[i + 1] : 0);
+        if (p > pair) pair = p;
+    }
+    return total >= 8 && pair * 4 >= total * 3;
+}
+
+void advIntervalPrintJSON(Print& out, const AdvInterval& s) {
+    out.printf("{\"scope\":\"session\",\"n\":%u,\"mean\":%.1f,\"sd\":%.1f,\"mode\":%u,\"steady\":%s,\"hist\":[",
+               (unsigned)s.n, s.mean, advIntervalStddev(s), (unsigned)advIntervalMode(s),
+               advIntervalSteady(s) ? "true" : "false");
+    for (int i = 0; i < ADV_INTERVAL_BUCKETS; i++) {
+        out.printf(i ? ",%u" : "%u", (unsigned)s.hist[i]);
+    }
+    out.print("]}");
+}
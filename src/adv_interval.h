@@ -0,0 +1,55 @@
+/*
+ * Advertising Interval Statistics - per-device BLE inter-arrival times.
+ *
+ * Fixed hardware advertises on a steady timer, so the gap between a
+ * device's advertisements is a useful fingerprint. AdvInterval keeps O(1)
+ * streaming statistics of those gaps in 24 bytes: Welford mean and
+ * variance plus a histogram of log2 buckets. It is plain data, so it can
+ * sit in tables that are zeroed with memset and live in PSRAM.
+ *
+ * Statistics are session-only: they live in RAM, start over at boot and
+ * are not written to the session log or NVS. The JSON says so with
+ * "scope":"session".
+ *
+ * Not thread-safe: callers serialize updates and reads of one device.
+ */
+
+#ifndef ADV_INTERVAL_H
+#define ADV_INTERVAL_H
+
+#include <Arduino.h>
+#include <stdint.h>
+
+#define ADV_INTERVAL_BUCKETS 10     // 16-31 ms, 32-63 ms ... 4.1-8.2 s, 8.2 s+
+#define ADV_INTERVAL_MIN_MS  15     // Shorter gaps are repeats of one advertising event
+#define ADV_INTERVAL_MAX_MS  10500  // BLE caps the interval at 10.24 s; longer = out of range
+#define ADV_INTERVAL_MAX_N   1024   // Beyond this the statistics become a moving average
+
+struct AdvInterval {
+    uint32_t lastMs;                     // Previous advertisement, 0 = none yet
+    float mean;                          // Mean gap, ms
+    float m2;                            // Sum of squared deviations from the mean, ms^2
+    uint16_t n;                          // Gaps counted
+    uint8_t hist[ADV_INTERVAL_BUCKETS];  // Gaps per bucket; halved when one fills
+};
+static_assert(sizeof(AdvInterval) <= 32, "AdvInterval is kept for every tracked device");
+
+// Fold in an advertisement received at nowMs. The gap since the previous
+// one only counts if listening was not interrupted in between: pass the
+// time the current scan started (0 when the scan never stops).
+void advIntervalAdd(AdvInterval& s, uint32_t nowMs, uint32_t scanStartMs = 0);
+
+float advIntervalStddev(const AdvInterval& s);
+
+// Lower bound (ms) of the most common bucket, 0 with no gaps yet
+uint32_t advIntervalMode(const AdvInterval& s);
+
+// True once at least 8 gaps were seen and 3/4 of them fall in two adjacent
+// buckets: a timer-driven advertiser. Missed advertisements land in the
+// higher buckets, so this tolerates some packet loss.
+bool advIntervalSteady(const AdvInterval& s);
+
+// {"scope":"session","n":..,"mean":..,"sd":..,"mode":..,"steady":..,"hist":[..]}
+void advIntervalPrintJSON(Print& out, const AdvInterval& s);
+
+#endif // ADV_INTERVAL_H
@@ -0,0 +1,138 @@
+/*
+ * Alert Sequencer - see alert_sequencer.h
+ */
+
+#include <Arduino.h>
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+#include "alert_sequencer.h"
+
+#define ALERT_SWEEP_STEP_MS 8  // Frequency update period for sweeps
+#define ALERT_TASK_STACK    2048
+#define ALERT_TASK_PRIORITY 1
+
+struct AlertPattern {
+    AlertStep steps[ALERT_MAX_STEPS];
+    uint8_t count;
+    bool sound;
+    bool led;
+};
+
+static QueueHandle_t alertQueue = nullptr;
+static std::atomic<uint32_t> alertPending{0};  // Queued or playing patterns
+static uint8_t alertBuzzerPin = 0;
+static uint8_t alertLedPin = 0;
+static bool alertLedActiveLow = true;
+static uint8_t alertChannel = 0;
+
+// ============================================================================
+// Output helpers
+// ============================================================================
+static void alertSetLed(bool on) {
+    digitalWrite(alertLedPin, (on != alertLedActiveLow) ? HIGH : LOW);
+}
+
+static void alertTone(int freq) {
+    if (freq < 100) freq = 100;
+    ledcWriteTone(alertChannel, freq);
+}
+
+static void alertSilence() {
+    ledcWrite(alertChannel, 0);
+}
+
+// ============================================================================
+// Sequencer task
+// ============================================================================
+static void alertPlayStep(const AlertStep& step, const AlertPattern& pattern) {
+    if (pattern.led) alertSetLed(step.led);
+
+    bool sound = pattern.sound && step.freq > 0;
+    if (!sound) {
+        vTaskDelay(pdMS_TO_TICKS(step.ms));
+        return;
+    }
+
+    if (step.endFreq == 0) {
+        alertTone(step.freq);
+        vTaskDelay(pdMS_TO_TICKS(step.ms));
+    } else {
+        // Sweep with the same 8ms stepping and warble texture as the
+        // original Flock-You caw
+        int steps = step.ms / ALERT_SWEEP_STEP_MS;
+        float fStep = steps > 0 ? (float)(step.endFreq - step.freq) / steps : 0;
+        for (int i = 0; i < steps; i++) {
+            int f = step.freq + (int)(fStep * i);
+            if (step.warble > 0 && (i % 3 == 0)) {
+                f += ((i % 6 < 3) ? step.warble : -step.warble);
+            }
+            alertTone(f);
+            vTaskDelay(pdMS_TO_TICKS(ALERT_SWEEP_STEP_MS));
+        }
+    }
+    alertSilence();
+}
+
+static void alertTask(void*) {
+    AlertPattern pattern;
+    for (;;) {
+        if (xQueueReceive(alertQueue, &pattern, portMAX_DELAY) != pdTRUE) continue;
+
+        // Another user of the channel (tone()/noTone()) may have detached the pin
+        if (pattern.sound) ledcAttachPin(alertBuzzerPin, alertChannel);
+
+        for (uint8_t i = 0; i < pattern.count; i++) {
+            alertPlayStep(pattern.steps[i], pattern);
+        }
+        if (pattern.sound) alertSilence();
+        if (pattern.led) alertSetLed(false);
+
+        alertPending.fetch_sub(1);
+    }
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+void alertBegin(uint8_t buzzerPin, uint8_t ledPin, bool ledActiveLow, uint8_t ledcChannel) {
+    if (alertQueue) return;
+
+    alertBuzzerPin = buzzerPin;
+    alertLedPin = ledPin;
+    alertLedActiveLow = ledActiveLow;
+    alertChannel = ledcChannel;
+
+    ledcSetup(alertChannel, 2000, 8);
+    ledcAttachPin(alertBuzzerPin, alertChannel);
+    alertSilence();
+
+    alertQueue = xQueueCreate(ALERT_QUEUE_DEPTH, sizeof(AlertPattern));
+    if (!alertQueue) return;
+    xTaskCreate(alertTask, "alert_seq", ALERT_TASK_STACK, nullptr, ALERT_TASK_PRIORITY, nullptr);
+}
+
+bool alertPlay(const AlertStep* steps, size_t count, bool sound, bool led) {
+    if (!alertQueue || count == 0) return false;
+    if (!sound && !led) return true;  // Nothing to do
+
+    AlertPattern pattern;
+    pattern.count = count > ALERT_MAX_STEPS ? ALERT_MAX_STEPS : count;
+    memcpy(pattern.steps, steps, pattern.count * sizeof(AlertStep));
+    pattern.sound = sound;
+    pattern.led = led;
+
+    // Never wait: callers include the BLE host task. Counted before the
+    // send so alertBusy() cannot miss a pattern the task already took.
+    alertPending.fetch_add(1);
+    if (xQueueSend(alertQueue, &pattern, 0) != pdTRUE) {
+        alertPending.fetch_sub(1);
+        return false;
+    }
+    return true;
+}
+
+bool alertBusy() {
+    return alertPending.load() > 0;
+}
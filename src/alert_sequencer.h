@@ -0,0 +1,46 @@
+/*
+ * Alert Sequencer - non-blocking buzzer / LED patterns shared by all modes.
+ *
+ * A pattern is a short list of AlertStep descriptors. alertPlay() copies it
+ * into a queue and returns immediately; a dedicated FreeRTOS task plays the
+ * steps on the LEDC buzzer channel and the status LED. Safe to call from the
+ * NimBLE callback, loop() or web handlers.
+ */
+
+#ifndef ALERT_SEQUENCER_H
+#define ALERT_SEQUENCER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define ALERT_MAX_STEPS   16  // Steps per pattern
+#define ALERT_QUEUE_DEPTH 4   // Patterns waiting to play
+
+// One step of a pattern. freq == 0 is a rest. A non-zero endFreq sweeps
+// linearly from freq to endFreq over the step, with optional +/- warble Hz
+// of raspy texture (Flock-You crow calls).
+struct AlertStep {
+    uint16_t freq;
+    uint16_t endFreq;
+    uint16_t ms;
+    uint8_t  warble;
+    uint8_t  led;  // 1 = status LED on during this step
+};
+
+// Start the sequencer task. Safe to call more than once.
+void alertBegin(uint8_t buzzerPin, uint8_t ledPin, bool ledActiveLow, uint8_t ledcChannel = 0);
+
+// Queue a pattern. sound/led mask the buzzer and LED parts of every step.
+// Returns false if the sequencer is not running or the queue is full.
+bool alertPlay(const AlertStep* steps, size_t count, bool sound = true, bool led = true);
+
+template <size_t N>
+inline bool alertPlay(const AlertStep (&steps)[N], bool sound = true, bool led = true) {
+    return alertPlay(steps, N, sound, led);
+}
+
+// True while a pattern is playing or queued (modes that drive the buzzer
+// directly, like Foxhunter proximity beeping, wait for this to clear).
+bool alertBusy();
+
+#endif // ALERT_SEQUENCER_H
@@ -0,0 +1,168 @@
+/*
+ * Device Table - fixed-capacity table of BLE devices keyed by 48-bit MAC.
+ *
+ * Entries live in one block of caller-provided memory (PSRAM when present),
+ * so the table never allocates after attach(). Slots 0..size()-1 are always
+ * occupied, so the table can be indexed and iterated like a vector. A
+ * linear-probing index maps MAC -> slot and a doubly-linked list over slots
+ * tracks recency; when full, the least-recently-seen device is evicted and
+ * its slot reused in place.
+ *
+ * Entry must be plain data with a uint64_t macKey member; insert() zeroes
+ * it. Not thread-safe: callers serialize access.
+ */
+
+#ifndef DEVICE_TABLE_H
+#define DEVICE_TABLE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#define DEVICE_SLOT_NONE 0xFFFF
+
+template <typename Entry>
+class DeviceTable {
+public:
+    // Bytes of memory attach() needs for a table of this capacity
+    static size_t bytesFor(size_t capacity) {
+        return capacity * (sizeof(Entry) + 2 * sizeof(uint16_t)) + bucketsFor(capacity) * sizeof(uint16_t);
+    }
+    
+    // Lay the table out in caller-owned memory of bytesFor(capacity) bytes
+    bool attach(void* memory, size_t capacity) {
+        if (!memory || capacity == 0 || capacity >= DEVICE_SLOT_NONE) return false;
+        uint8_t* mem = (uint8_t*)memory;
+        entries = (Entry*)mem;
+        lruPrev = (uint16_t*)(mem + capacity * sizeof(Entry));
+        lruNext = lruPrev + capacity;
+        index = lruNext + capacity;
+        cap = capacity;
+        mask = bucketsFor(capacity) - 1;
+        clear();
+        return true;
+    }
+    
+    void clear() {
+        count = 0;
+        evictions = 0;
+        head = tail = DEVICE_SLOT_NONE;
+        if (index) memset(index, 0xFF, (mask + 1) * sizeof(uint16_t));
+    }
+    
+    size_t size() const { return count; }
+    size_t capacity() const { return cap; }
+    uint32_t evicted() const { return evictions; }
+    
+    Entry& operator[](size_t i) { return entries[i]; }
+    Entry* begin() { return entries; }
+    Entry* end() { return entries + count; }
+    
+    Entry* find(uint64_t mac) {
+        if (!index) return nullptr;
+        for (size_t b = bucketFor(mac); index[b] != DEVICE_SLOT_NONE; b = (b + 1) & mask) {
+            if (entries[index[b]].macKey == mac) return &entries[index[b]];
+        }
+        return nullptr;
+    }
+    
+    // Insert a new device as most-recently-seen. Never allocates; evicts the
+    // least-recently-seen entry when the table is full.
+    Entry* insert(uint64_t mac) {
+        if (!index) return nullptr;
+        
+        uint16_t slot;
+        if (count < cap) {
+            slot = count++;
+        } else {
+            slot = tail;
+            unlink(slot);
+            removeFromIndex(slot);
+            evictions++;
+        }
+        
+        Entry& dev = entries[slot];
+        memset(&dev, 0, sizeof(dev));
+        dev.macKey = mac;
+        
+        size_t b = bucketFor(mac);
+        while (index[b] != DEVICE_SLOT_NONE) b = (b + 1) & mask;
+        index[b] = slot;
+        pushFront(slot);
+        return &dev;
+    }
+    
+    // Mark a device as most-recently-seen
+    void touch(Entry* dev) {
+        uint16_t slot = dev - entries;
+        if (slot == head) return;
+        unlink(slot);
+        pushFront(slot);
+    }
+    
+    // Recency-ordered traversal: newest() then older() until nullptr
+    Entry* newest() { return head == DEVICE_SLOT_NONE ? nullptr : &entries[head]; }
+    Entry* older(const Entry* dev) {
+        uint16_t next = lruNext[dev - entries];
+        return next == DEVICE_SLOT_NONE ? nullptr : &entries[next];
+    }
+    
+private:
+    Entry* entries = nullptr;
+    uint16_t* lruPrev = nullptr;
+    uint16_t* lruNext = nullptr;
+    uint16_t* index = nullptr;
+    size_t cap = 0;
+    size_t count = 0;
+    size_t mask = 0;
+    uint16_t head = DEVICE_SLOT_NONE;  // most recently seen
+    uint16_t tail = DEVICE_SLOT_NONE;  // least recently seen
+    uint32_t evictions = 0;
+    
+    static size_t bucketsFor(size_t capacity) {
+        size_t buckets = 1;
+        while (buckets < capacity * 2) buckets <<= 1;  // load factor <= 0.5
+        return buckets;
+    }
+    
+    size_t bucketFor(uint64_t mac) const {
+        return (size_t)((mac * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+    }
+    
+    void pushFront(uint16_t slot) {
+        lruPrev[slot] = DEVICE_SLOT_NONE;
+        lruNext[slot] = head;
+        if (head != DEVICE_SLOT_NONE) lruPrev[head] = slot;
+        head = slot;
+        if (tail == DEVICE_SLOT_NONE) tail = slot;
+    }
+    
+    void unlink(uint16_t slot) {
+        uint16_t prev = lruPrev[slot];
+        uint16_t next = lruNext[slot];
+        if (prev != DEVICE_SLOT_NONE) lruNext[prev] = next; else head = next;
+        if (next != DEVICE_SLOT_NONE) lruPrev[next] = prev; else tail = prev;
+    }
+    
+    // Backward-shift deletion keeps probe chains intact without tombstones
+    void removeFromIndex(uint16_t slot) {
+        size_t hole = bucketFor(entries[slot].macKey);
+        while (index[hole] != slot) hole = (hole + 1) & mask;
+        
+        size_t probe = hole;
+        for (;;) {
+            probe = (probe + 1) & mask;
+            if (index[probe] == DEVICE_SLOT_NONE) break;
+            size_t home = bucketFor(entries[index[probe]].macKey);
+            // Leave entries whose home bucket lies cyclically in (hole, probe]
+            bool stays = (hole <= probe) ? (home > hole && home <= probe)
+                                         : (home > hole || home <= probe);
+            if (stays) continue;
+            index[hole] = index[probe];
+            hole = probe;
+        }
+        index[hole] = DEVICE_SLOT_NONE;
+    }
+};
+
+#endif // DEVICE_TABLE_H
@@ -0,0 +1,16 @@
+/*
+ * Flock-You position fixes - see fy_gps.h
+ */
+
+#include <Arduino.h>
+#include "fy_gps.h"
+
+bool fyGPSTakeFix(TinyGPSPlus& gps, float hdopScale, FYFix& out) {
+    if (!gps.location.isUpdated() || !gps.location.isValid()) return false;
+    out.lat = gps.location.lat();
+    out.lon = gps.location.lng();
+    out.acc = gps.hdop.isValid() ? (float)(gps.hdop.hdop() * hdopScale) : 10.0f;
+    out.ms = millis();
+    out.hw = true;
+    return true;
+}
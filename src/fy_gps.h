@@ -0,0 +1,31 @@
+/*
+ * Flock-You position fixes - what a hardware GPS sentence or a phone
+ * location report turns into, and how NMEA parsed by TinyGPS++ becomes one.
+ *
+ * Fixes are published through a SeqLock<FYFix> so detections can be tagged
+ * with the current position without blocking the BLE callback.
+ */
+
+#ifndef FY_GPS_H
+#define FY_GPS_H
+
+#include <stdint.h>
+#include <TinyGPS++.h>
+#include "seqlock.h"
+
+struct FYFix {
+    double lat;
+    double lon;
+    float acc;            // Estimated accuracy, m
+    unsigned long ms;     // millis() when the fix arrived
+    bool hw;              // From the hardware GPS
+};
+
+typedef SeqLock<FYFix> FYFixLock;
+
+// After gps.encode() completed a sentence: if it updated the position,
+// fill out (stamped now, accuracy from HDOP * hdopScale, 10 m without HDOP)
+// and return true. Consumes the position's updated flag.
+bool fyGPSTakeFix(TinyGPSPlus& gps, float hdopScale, FYFix& out);
+
+#endif // FY_GPS_H
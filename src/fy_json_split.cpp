@@ -0,0 +1,41 @@
+/*
+ * Flock-You JSON splitter - see fy_json_split.h
+ */
+
+#include "fy_json_split.h"
+
+bool fyJsonNextObject(FYJsonSplitter& s) {
+    for (;;) {
+        if (s.pos == s.len) {
+            s.len = s.read(s.ctx, s.chunk, sizeof(s.chunk));
+            s.pos = 0;
+            if (s.len == 0) return false;
+        }
+        char c = (char)s.chunk[s.pos++];
+        if (s.depth == 0) {
+            if (c != '{') continue;  // '[', ',' and whitespace around elements
+            s.objLen = 0;
+            s.overflow = false;
+            s.inString = false;
+        }
+
+        if (s.objLen < sizeof(s.obj) - 1) s.obj[s.objLen++] = c;
+        else s.overflow = true;
+
+        if (s.inString) {
+            if (s.escape) s.escape = false;
+            else if (c == '\\') s.escape = true;
+            else if (c == '"') s.inString = false;
+            continue;
+        }
+        if (c == '"') s.inString = true;
+        else if (c == '{' || c == '[') s.depth++;
+        else if ((c == '}' || c == ']') && --s.depth == 0) {
+            if (!s.overflow) {
+                s.obj[s.objLen] = '\0';
+                return true;
+            }
+            s.skipped++;
+        }
+    }
+}
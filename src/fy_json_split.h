@@ -0,0 +1,38 @@
+/*
+ * Flock-You JSON splitter - reads a JSON array one element at a time.
+ *
+ * The splitter tracks strings and nesting over FY_JSON_CHUNK reads and
+ * hands back each top-level object on its own, so a caller can parse it
+ * (ArduinoJson) with memory that stays fixed whatever the file size.
+ * Objects over FY_JSON_OBJ_MAX bytes are skipped and counted.
+ */
+
+#ifndef FY_JSON_SPLIT_H
+#define FY_JSON_SPLIT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define FY_JSON_CHUNK   512
+#define FY_JSON_OBJ_MAX 768
+
+// Source: copy up to len bytes into buf, return how many (0 at the end)
+typedef size_t (*FYJsonReadFn)(void* ctx, uint8_t* buf, size_t len);
+
+// Zero it, then set read and ctx
+struct FYJsonSplitter {
+    FYJsonReadFn read;
+    void* ctx;
+    uint8_t chunk[FY_JSON_CHUNK];
+    size_t len, pos;
+    char obj[FY_JSON_OBJ_MAX];
+    size_t objLen;
+    int depth;                  // 0 = between objects
+    bool inString, escape, overflow;
+    uint32_t skipped;
+};
+
+// Next object into s.obj (NUL-terminated). Returns false at end of input.
+bool fyJsonNextObject(FYJsonSplitter& s);
+
+#endif // FY_JSON_SPLIT_H
@@ -0,0 +1,83 @@
+/*
+ * Flock-You Raven services - see fy_raven.h
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include "fy_raven.h"
+
+const char* const raven_service_uuids[FY_SVC_COUNT] = {
+    RAVEN_DEVICE_INFO_SERVICE,
+    RAVEN_GPS_SERVICE,
+    RAVEN_POWER_SERVICE,
+    RAVEN_NETWORK_SERVICE,
+    RAVEN_UPLOAD_SERVICE,
+    RAVEN_ERROR_SERVICE,
+    RAVEN_OLD_HEALTH_SERVICE,
+    RAVEN_OLD_LOCATION_SERVICE
+};
+
+static int fyHexNibble(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    c = (char)tolower((uint8_t)c);
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+bool fySigServiceLess(const FYSigService& a, const FYSigService& b) {
+    return memcmp(a.uuid, b.uuid, 16) < 0;
+}
+
+bool fyParseUUID128(const char* str, uint8_t* out) {
+    int n = 0;
+    for (const char* p = str; *p; p++) {
+        if (*p == '-') continue;
+        int v = fyHexNibble(*p);
+        if (v < 0 || n >= 32) return false;
+        uint8_t& b = out[15 - n / 2];
+        b = (n & 1) ? (uint8_t)(b | v) : (uint8_t)(v << 4);
+        n++;
+    }
+    return n == 32;
+}
+
+void fyFormatUUID128(const uint8_t* uuid, char* out) {
+    char* o = out;
+    for (int i = 15; i >= 0; i--) {
+        o += sprintf(o, "%02x", uuid[i]);
+        if (i == 12 || i == 10 || i == 8 || i == 6) *o++ = '-';
+    }
+    *o = '\0';
+}
+
+void fyRavenServices(std::vector<FYSigService>& out) {
+    out.clear();
+    for (int s = 0; s < FY_SVC_COUNT; s++) {
+        FYSigService svc = {};
+        if (!fyParseUUID128(raven_service_uuids[s], svc.uuid)) continue;
+        svc.bit = (uint8_t)s;
+        out.push_back(svc);
+    }
+    std::sort(out.begin(), out.end(), fySigServiceLess);
+}
+
+uint32_t fyServiceBit(const std::vector<FYSigService>& table, const uint8_t* uuid) {
+    FYSigService key;
+    memcpy(key.uuid, uuid, 16);
+    std::vector<FYSigService>::const_iterator it =
+        std::lower_bound(table.begin(), table.end(), key, fySigServiceLess);
+    if (it == table.end() || memcmp(it->uuid, uuid, 16) != 0) return 0;
+    return FY_SVC_BIT(it->bit);
+}
+
+const char* estimateRavenFW(uint32_t svcMask) {
+    bool has_new_gps = svcMask & FY_SVC_BIT(FY_SVC_GPS);
+    bool has_old_loc = svcMask & FY_SVC_BIT(FY_SVC_OLD_LOCATION);
+    bool has_power   = svcMask & FY_SVC_BIT(FY_SVC_POWER);
+    if (has_old_loc && !has_new_gps) return "1.1.x";
+    if (has_new_gps && !has_power)   return "1.2.x";
+    if (has_new_gps && has_power)    return "1.3.x";
+    return "?";
+}
@@ -0,0 +1,72 @@
+/*
+ * Flock-You Raven services - the 128-bit service UUIDs advertised by
+ * SoundThinking Raven units, and firmware estimation from which of them a
+ * unit advertises.
+ *
+ * Advertised services are decoded once into a mask of FY_SVC_BIT()s by
+ * binary comparison of the native UUID bytes against a sorted table, so
+ * nothing is formatted on the advertisement path. Only the 128-bit form
+ * is matched: a 16-bit alias (e.g. 0x180A) is far too common to count on
+ * its own.
+ */
+
+#ifndef FY_RAVEN_H
+#define FY_RAVEN_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+#define RAVEN_DEVICE_INFO_SERVICE   "0000180a-0000-1000-8000-00805f9b34fb"
+#define RAVEN_GPS_SERVICE           "00003100-0000-1000-8000-00805f9b34fb"
+#define RAVEN_POWER_SERVICE         "00003200-0000-1000-8000-00805f9b34fb"
+#define RAVEN_NETWORK_SERVICE       "00003300-0000-1000-8000-00805f9b34fb"
+#define RAVEN_UPLOAD_SERVICE        "00003400-0000-1000-8000-00805f9b34fb"
+#define RAVEN_ERROR_SERVICE         "00003500-0000-1000-8000-00805f9b34fb"
+#define RAVEN_OLD_HEALTH_SERVICE    "00001809-0000-1000-8000-00805f9b34fb"
+#define RAVEN_OLD_LOCATION_SERVICE  "00001819-0000-1000-8000-00805f9b34fb"
+
+// Bit positions in the advertised-service mask (same order as raven_service_uuids)
+enum {
+    FY_SVC_DEVICE_INFO,
+    FY_SVC_GPS,
+    FY_SVC_POWER,
+    FY_SVC_NETWORK,
+    FY_SVC_UPLOAD,
+    FY_SVC_ERROR,
+    FY_SVC_OLD_HEALTH,
+    FY_SVC_OLD_LOCATION,
+    FY_SVC_COUNT
+};
+#define FY_SVC_OTHER FY_SVC_COUNT   // Uploaded services with no firmware role
+#define FY_SVC_BIT(s) (1UL << (s))
+static_assert(FY_SVC_COUNT <= 32, "service mask is 32 bits");
+
+extern const char* const raven_service_uuids[FY_SVC_COUNT];
+
+// One known service. Also a record of the signature file format.
+struct FYSigService {
+    uint8_t uuid[16];      // NimBLE native (least significant byte first)
+    uint8_t bit;           // FY_SVC_* role, or any other bit < 32
+    uint8_t reserved[3];
+};
+static_assert(sizeof(FYSigService) == 20, "FYSigService is part of the file format");
+
+bool fySigServiceLess(const FYSigService& a, const FYSigService& b);
+
+// "0000180a-0000-1000-8000-00805f9b34fb" -> 16 bytes, least significant first
+bool fyParseUUID128(const char* str, uint8_t* out);
+
+// Inverse of fyParseUUID128; out holds at least 37 bytes
+void fyFormatUUID128(const uint8_t* uuid, char* out);
+
+// The built-in Raven services, sorted for fyServiceBit()
+void fyRavenServices(std::vector<FYSigService>& out);
+
+// FY_SVC_BIT() of a native 128-bit UUID in a sorted table, 0 if unknown
+uint32_t fyServiceBit(const std::vector<FYSigService>& table, const uint8_t* uuid);
+
+// "1.1.x", "1.2.x", "1.3.x" or "?" from the advertised-service mask
+const char* estimateRavenFW(uint32_t svcMask);
+
+#endif // FY_RAVEN_H
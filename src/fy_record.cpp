@@ -0,0 +1,77 @@
+/*
+ * Flock-You session records - see fy_record.h
+ */
+
+#include "fy_record.h"
+
+uint32_t fyCrc32(uint32_t crc, const uint8_t* data, size_t len) {
+    crc = ~crc;
+    while (len--) {
+        crc ^= *data++;
+        for (int k = 0; k < 8; k++) crc = (crc >> 1) ^ (0xEDB88320UL & (0 - (crc & 1)));
+    }
+    return ~crc;
+}
+
+void fyRecordSeal(FYSessionRecord& r) {
+    r.magic = FY_REC_MAGIC;
+    r.crc = fyCrc32(0, (const uint8_t*)&r, offsetof(FYSessionRecord, crc));
+}
+
+bool fyRecordValid(const FYSessionRecord& r) {
+    return r.magic == FY_REC_MAGIC &&
+           r.crc == fyCrc32(0, (const uint8_t*)&r, offsetof(FYSessionRecord, crc));
+}
+
+uint32_t fyRecordReplay(FYRecordReadFn read, void* readCtx, FYRecordApplyFn apply, void* applyCtx) {
+    uint32_t records = 0;
+    FYSessionRecord r;
+    while (read(readCtx, (uint8_t*)&r, sizeof(r)) == sizeof(r)) {
+        if (!fyRecordValid(r)) break;
+        apply(applyCtx, r);
+        records++;
+    }
+    return records;
+}
+
+FYLogAction fyLogPlan(const FYLogState& s, uint32_t live, uint32_t pending, uint32_t now, uint32_t* room) {
+    uint64_t records = s.records;
+    bool fits = records + live <= s.budget;
+    bool waiting = s.backoffMs && (int32_t)(now - s.retryAt) < 0;
+    *room = 0;
+    if (s.compact) return fits && !waiting ? FY_LOG_COMPACT : FY_LOG_FULL;
+
+    // Worth it once stale records pile up, or before the pending appends
+    // would leave no room for the compacted copy (and FY_LOG_SLACK devices
+    // found before the next checkpoint)
+    bool stale = records > live;
+    bool due = stale && (records > 2ULL * live + FY_LOG_SLACK ||
+                         records + pending + live + FY_LOG_SLACK > s.budget);
+    if (due && fits && !waiting) return FY_LOG_COMPACT;
+
+    if (records >= s.budget) return FY_LOG_FULL;
+    *room = s.budget - s.records;
+    return FY_LOG_APPEND;
+}
+
+void fyLogCompacted(FYLogState& s, uint32_t records) {
+    s.records = records;
+    s.backoffMs = 0;
+}
+
+void fyLogCompactFailed(FYLogState& s, uint32_t now) {
+    s.backoffMs = s.backoffMs ? s.backoffMs * 2 : FY_LOG_BACKOFF_MS;
+    if (s.backoffMs > FY_LOG_BACKOFF_MAX) s.backoffMs = FY_LOG_BACKOFF_MAX;
+    s.retryAt = now + s.backoffMs;
+}
+
+FYStoragePlan fyStoragePlan(size_t bytes, uint32_t maxCapacity) {
+    FYStoragePlan p = {0, 0, 0};
+    uint32_t records = bytes / sizeof(FYSessionRecord);
+    if (records <= 2 * FY_LOG_SLACK) return p;
+    p.capacity = (records - 2 * FY_LOG_SLACK) / 4;
+    if (p.capacity > maxCapacity) p.capacity = maxCapacity;
+    p.logRecords = 3 * p.capacity + 2 * FY_LOG_SLACK;
+    p.histRecords = records - p.logRecords;
+    return p;
+}
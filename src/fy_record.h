@@ -0,0 +1,107 @@
+/*
+ * Flock-You session records - the fixed-size, CRC-sealed record the live
+ * session log and the session history are made of.
+ *
+ * The live session is an append-only log of FYSessionRecords. Later records
+ * for the same MAC supersede earlier ones. A record only counts if its magic
+ * and CRC check out, so replay stops at the first bad one: a final write
+ * torn by a reset loses that record and nothing before it.
+ */
+
+#ifndef FY_RECORD_H
+#define FY_RECORD_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define FY_REC_MAGIC 0x52535946UL   // "FYSR"
+#define FY_REC_RAVEN 0x01
+#define FY_REC_GPS   0x02
+
+// Records written before location estimates have estN == 0 and zeros where
+// the estimate offsets now sit (BLE names are at most 29 bytes).
+struct FYSessionRecord {
+    uint32_t magic;
+    uint16_t estN;        // Fixes in the location estimate, 0 = none
+    uint16_t estR;        // Its uncertainty radius, m
+    uint64_t macKey;
+    double gpsLat;
+    double gpsLon;
+    uint32_t firstSeen;
+    uint32_t lastSeen;
+    uint32_t count;
+    float gpsAcc;
+    int16_t rssi;
+    uint8_t flags;        // FY_REC_*
+    uint8_t signals;      // FY_SIG_BIT()s, 0 in records written before scoring
+    char name[40];
+    float estDLat;        // Estimate minus gpsLat / gpsLon, degrees
+    float estDLon;
+    char method[24];
+    char ravenFW[16];
+    uint32_t crc;         // CRC-32 of every byte before it
+};
+static_assert(sizeof(FYSessionRecord) == 144, "FYSessionRecord is the on-flash format");
+
+// CRC-32 (IEEE), chainable: pass the previous result as crc. Shared by
+// every Flock-You flash format.
+uint32_t fyCrc32(uint32_t crc, const uint8_t* data, size_t len);
+
+// Stamp the magic and CRC once every other field is filled in
+void fyRecordSeal(FYSessionRecord& r);
+
+bool fyRecordValid(const FYSessionRecord& r);
+
+// Log source: copy up to len bytes into buf, return how many (0 at the end)
+typedef size_t (*FYRecordReadFn)(void* ctx, uint8_t* buf, size_t len);
+typedef void (*FYRecordApplyFn)(void* ctx, const FYSessionRecord& r);
+
+// Hand every record of a log to apply(), in order, stopping at the end or
+// at the first short or invalid record. Returns the records applied.
+uint32_t fyRecordReplay(FYRecordReadFn read, void* readCtx, FYRecordApplyFn apply, void* applyCtx);
+
+// Log budgeting. The log shares its partition with other files, and a
+// compaction writes the live detections to a second file before the old log
+// is removed, so it can only start while both fit in the log's budget. When
+// they cannot, stale records are kept and appends go on until the budget is
+// spent. A failed compaction is retried after a backoff, not every checkpoint.
+
+#define FY_LOG_SLACK       256         // Stale records tolerated beyond 2x live
+#define FY_LOG_BACKOFF_MS  60000UL     // First retry after a failed compaction
+#define FY_LOG_BACKOFF_MAX 3600000UL   // Doubling stops here
+
+enum FYLogAction {
+    FY_LOG_APPEND,      // Append up to *room records
+    FY_LOG_COMPACT,     // Rewrite the log from the live detections
+    FY_LOG_FULL         // Write nothing, changes stay queued
+};
+
+struct FYLogState {
+    uint32_t budget;      // Records the log may use, compacted copy included
+    uint32_t records;     // Records in the log file
+    bool compact;         // Log must be rewritten before any append (pool cleared, torn tail)
+    uint32_t retryAt;     // No compaction before this millis()
+    uint32_t backoffMs;   // 0 = last compaction did not fail
+};
+
+// What the next checkpoint should do with live detections in the pool and
+// pending of them changed since they were last written
+FYLogAction fyLogPlan(const FYLogState& s, uint32_t live, uint32_t pending, uint32_t now, uint32_t* room);
+
+void fyLogCompacted(FYLogState& s, uint32_t records);
+void fyLogCompactFailed(FYLogState& s, uint32_t now);
+
+// How bytes of flash set aside for records are split. The log compacts at
+// 2x the pool plus slack and then needs room for the copy beside it (3x the
+// pool, plus slack for devices found meanwhile), and the history ring must
+// take one whole session, so the pool is capped at about a quarter of the
+// records; the ring gets whatever the log does not.
+struct FYStoragePlan {
+    uint32_t capacity;      // Pool entries that can be persisted, at most maxCapacity
+    uint32_t logRecords;    // Session log budget
+    uint32_t histRecords;   // History ring size
+};
+
+FYStoragePlan fyStoragePlan(size_t bytes, uint32_t maxCapacity);
+
+#endif // FY_RECORD_H
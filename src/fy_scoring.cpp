@@ -0,0 +1,149 @@
+/*
+ * Flock-You detection scoring - see fy_scoring.h
+ */
+
+#include <string.h>
+#include <algorithm>
+#include "fy_scoring.h"
+
+// AD types (Bluetooth Assigned Numbers, Generic Access Profile)
+#define FY_AD_UUID128_SOME  0x06
+#define FY_AD_UUID128_ALL   0x07
+#define FY_AD_NAME_SHORT    0x08
+#define FY_AD_NAME_COMPLETE 0x09
+#define FY_AD_MFR_DATA      0xFF
+
+const FYSignalInfo fy_signals[FY_SIG_COUNT] = {
+    { 40, "mac_prefix"  },
+    { 50, "device_name" },
+    { 35, "ble_mfr_id"  },
+    { 60, "raven_uuid"  },
+    { 25, "raven_multi" },
+    { 20, "steady_interval" },
+};
+
+void fyCompileRules(std::vector<FYRule>& rules, bool ouis, bool names, bool mfrIds, uint32_t svcBits) {
+    rules.clear();
+    FYRule r = {};
+    if (ouis) {
+        r.op = FY_OP_OUI; r.signal = FY_SIG_MAC_OUI;
+        rules.push_back(r);
+    }
+    if (svcBits) {
+        r.op = FY_OP_SVC_ANY; r.signal = FY_SIG_RAVEN_SVC; r.mask = svcBits;
+        rules.push_back(r);
+    }
+    uint32_t roles = svcBits & (FY_SVC_BIT(FY_SVC_COUNT) - 1);
+    if (__builtin_popcount(roles) >= 2) {
+        r.op = FY_OP_SVC_MIN; r.signal = FY_SIG_RAVEN_MULTI; r.mask = roles; r.min = 2;
+        rules.push_back(r);
+    }
+    if (mfrIds) {
+        r.op = FY_OP_MFR; r.signal = FY_SIG_MFR_ID;
+        rules.push_back(r);
+    }
+    if (names) {
+        r.op = FY_OP_NAME; r.signal = FY_SIG_NAME;
+        rules.push_back(r);
+    }
+}
+
+static void fyAdvertName(FYAdvert& a, const uint8_t* data, size_t len) {
+    if (len > sizeof(a.name) - 1) len = sizeof(a.name) - 1;
+    memcpy(a.name, data, len);
+    a.name[len] = '\0';
+}
+
+void fyParseAdvert(const uint8_t* mac, const uint8_t* payload, size_t len,
+                   const std::vector<FYSigService>& services, FYAdvert& a) {
+    a.mac = mac;
+    a.name[0] = '\0';
+    a.mfrCount = 0;
+    a.svcMask = 0;
+    bool complete = false;
+
+    size_t pos = 0;
+    while (payload && pos < len) {
+        size_t n = payload[pos];             // Type byte + data
+        if (n == 0) { pos++; continue; }     // Padding before a scan response
+        if (pos + 1 + n > len) break;
+        uint8_t type = payload[pos + 1];
+        const uint8_t* data = payload + pos + 2;
+        size_t dataLen = n - 1;
+
+        switch (type) {
+        case FY_AD_NAME_COMPLETE:
+            fyAdvertName(a, data, dataLen);
+            complete = true;
+            break;
+        case FY_AD_NAME_SHORT:
+            if (!complete) fyAdvertName(a, data, dataLen);
+            break;
+        case FY_AD_MFR_DATA:
+            if (dataLen >= 2 && a.mfrCount < FY_ADV_MAX_MFR) {
+                a.mfr[a.mfrCount++] = ((uint16_t)data[1] << 8) | data[0];
+            }
+            break;
+        case FY_AD_UUID128_SOME:
+        case FY_AD_UUID128_ALL:
+            for (size_t i = 0; i + 16 <= dataLen; i += 16) a.svcMask |= fyServiceBit(services, data + i);
+            break;
+        }
+        pos += 1 + n;
+    }
+}
+
+uint8_t fyEvalRules(const std::vector<FYRule>& rules, const FYAdvert& a,
+                    const std::vector<uint32_t>& ouis, const std::vector<uint16_t>& mfrIds,
+                    const NameMatcher& names) {
+    uint8_t signals = 0;
+    for (size_t i = 0; i < rules.size(); i++) {
+        const FYRule& r = rules[i];
+        bool hit = false;
+        switch (r.op) {
+        case FY_OP_OUI: {
+            uint32_t oui = ((uint32_t)a.mac[0] << 16) | ((uint32_t)a.mac[1] << 8) | a.mac[2];
+            hit = std::binary_search(ouis.begin(), ouis.end(), oui);
+            break;
+        }
+        case FY_OP_SVC_ANY:
+            hit = (a.svcMask & r.mask) != 0;
+            break;
+        case FY_OP_SVC_MIN:
+            hit = __builtin_popcount(a.svcMask & r.mask) >= r.min;
+            break;
+        case FY_OP_MFR:
+            for (int m = 0; m < a.mfrCount && !hit; m++) {
+                hit = std::binary_search(mfrIds.begin(), mfrIds.end(), a.mfr[m]);
+            }
+            break;
+        case FY_OP_NAME: {
+            uint16_t match;
+            hit = a.name[0] && names.match(a.name, &match, 1) > 0;
+            break;
+        }
+        }
+        if (hit) signals |= FY_SIG_BIT(r.signal);
+    }
+    return signals;
+}
+
+uint8_t fyScoreSignals(uint8_t signals) {
+    unsigned score = 0;
+    for (int i = 0; i < FY_SIG_COUNT; i++) {
+        if (signals & FY_SIG_BIT(i)) score += fy_signals[i].weight;
+    }
+    return score > FY_SCORE_MAX ? FY_SCORE_MAX : score;
+}
+
+const char* fySignalMethod(uint8_t signals) {
+    const char* method = "";
+    uint8_t best = 0;
+    for (int i = 0; i < FY_SIG_COUNT; i++) {
+        if ((signals & FY_SIG_BIT(i)) && fy_signals[i].weight > best) {
+            best = fy_signals[i].weight;
+            method = fy_signals[i].method;
+        }
+    }
+    return method;
+}
@@ -0,0 +1,93 @@
+/*
+ * Flock-You detection scoring - weighted signals evaluated by a compiled
+ * rule table over a pre-parsed advertisement.
+ *
+ * Every heuristic is a signal with a weight. fyCompileRules() turns the
+ * active signatures into a short table of (op, signal) rows ordered
+ * cheapest first, with empty tables dropped and service masks worked out
+ * up front. fyParseAdvert() decodes an advertisement once, straight from
+ * the raw AD structures, and fyEvalRules() runs the table over it in one
+ * pass; each rule that fires sets its signal's bit. The confidence score
+ * is the sum of the fired signals' weights, capped at FY_SCORE_MAX, and an
+ * advertisement is a detection from FY_SCORE_DETECT. Any one of the first
+ * four signals is enough on its own.
+ *
+ * FY_SIG_STEADY comes from the device's own advertising history rather
+ * than one advertisement, so the caller adds it; it only ever adds
+ * confidence to a device something else flagged.
+ */
+
+#ifndef FY_SCORING_H
+#define FY_SCORING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include "fy_raven.h"
+#include "name_matcher.h"
+
+enum {
+    FY_SIG_MAC_OUI,       // Flock Safety MAC prefix
+    FY_SIG_NAME,          // Device name pattern
+    FY_SIG_MFR_ID,        // Manufacturer company ID
+    FY_SIG_RAVEN_SVC,     // Any signature service UUID
+    FY_SIG_RAVEN_MULTI,   // Two or more Raven service roles
+    FY_SIG_STEADY,        // Timer-driven advertising (advIntervalSteady)
+    FY_SIG_COUNT
+};
+#define FY_SIG_BIT(s) (1U << (s))
+static_assert(FY_SIG_COUNT <= 8, "signal mask is 8 bits");
+
+// Weight, and the method name reported when it is the strongest signal
+struct FYSignalInfo {
+    uint8_t weight;
+    const char* method;
+};
+extern const FYSignalInfo fy_signals[FY_SIG_COUNT];
+
+#define FY_SCORE_DETECT 35
+#define FY_SCORE_MAX    100
+
+enum { FY_OP_OUI, FY_OP_SVC_ANY, FY_OP_SVC_MIN, FY_OP_MFR, FY_OP_NAME };
+
+struct FYRule {
+    uint8_t op;           // FY_OP_*
+    uint8_t signal;       // FY_SIG_* set when the rule fires
+    uint8_t min;          // FY_OP_SVC_MIN: bits of mask needed
+    uint32_t mask;        // FY_OP_SVC_*: service bits looked at
+};
+
+#define FY_ADV_MAX_MFR  4
+#define FY_ADV_NAME_MAX 32   // A legacy AD structure holds at most 29 name bytes
+
+// What the rules look at, decoded once per advertisement
+struct FYAdvert {
+    const uint8_t* mac;          // Display order
+    char name[FY_ADV_NAME_MAX];  // "" if none
+    uint16_t mfr[FY_ADV_MAX_MFR];
+    uint8_t mfrCount;
+    uint32_t svcMask;            // FY_SVC_BIT()s of signature services
+};
+
+// svcBits is every service bit the signatures can produce
+void fyCompileRules(std::vector<FYRule>& rules, bool ouis, bool names, bool mfrIds, uint32_t svcBits);
+
+// Walk the raw advertising payload (advertisement followed by any scan
+// response): the complete name (else the shortened one), manufacturer
+// company IDs and 128-bit service UUIDs looked up in services. Parsing
+// stops at a structure that runs past len; what came before still counts.
+void fyParseAdvert(const uint8_t* mac, const uint8_t* payload, size_t len,
+                   const std::vector<FYSigService>& services, FYAdvert& a);
+
+// Returns the FY_SIG_BIT()s of every rule that fires. ouis and mfrIds are
+// sorted; names is compiled from the name patterns.
+uint8_t fyEvalRules(const std::vector<FYRule>& rules, const FYAdvert& a,
+                    const std::vector<uint32_t>& ouis, const std::vector<uint16_t>& mfrIds,
+                    const NameMatcher& names);
+
+uint8_t fyScoreSignals(uint8_t signals);
+
+// Strongest signal's method name, "" for none
+const char* fySignalMethod(uint8_t signals);
+
+#endif // FY_SCORING_H
@@ -0,0 +1,78 @@
+/*
+ * Flock-You track blocks - see fy_track.h
+ */
+
+#include <string.h>
+#include "fy_record.h"
+#include "fy_track.h"
+
+int fyPutVarint(uint8_t* p, uint32_t v) {
+    int n = 0;
+    while (v >= 0x80) {
+        p[n++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    p[n++] = (uint8_t)v;
+    return n;
+}
+
+bool fyGetVarint(const uint8_t* p, uint16_t len, uint16_t& pos, uint32_t& v) {
+    v = 0;
+    for (int shift = 0; shift < 35 && pos < len; shift += 7) {
+        uint8_t b = p[pos++];
+        v |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+uint32_t fyTrackCrc(const FYTrackBlock& b) {
+    return fyCrc32(fyCrc32(0, (const uint8_t*)&b, offsetof(FYTrackBlock, crc)), b.data, b.len);
+}
+
+bool fyTrackValid(const FYTrackBlock& b) {
+    return b.magic == FY_TRACK_MAGIC && b.count > 0 && b.len <= sizeof(b.data) &&
+           b.crc == fyTrackCrc(b);
+}
+
+void fyTrackBlockStart(FYTrackBlock& b, uint32_t seq, uint32_t session, uint32_t t, int32_t lat, int32_t lon) {
+    memset(&b, 0, sizeof(b));
+    b.magic = FY_TRACK_MAGIC;
+    b.seq = seq;
+    b.session = session;
+    b.t0 = t;
+    b.lat0 = lat;
+    b.lon0 = lon;
+    b.count = 1;
+}
+
+bool fyTrackBlockAppend(FYTrackBlock& b, uint32_t dt, int32_t dlat, int32_t dlon) {
+    if (b.count == 0 || b.count == 0xFFFF || b.len + FY_TRACK_POINT_MAX > (int)sizeof(b.data)) return false;
+    b.len += fyPutVarint(b.data + b.len, dt);
+    b.len += fyPutVarint(b.data + b.len, fyZigzag(dlat));
+    b.len += fyPutVarint(b.data + b.len, fyZigzag(dlon));
+    b.count++;
+    return true;
+}
+
+bool fyTrackBlockNext(const FYTrackBlock& b, FYTrackReader& r) {
+    if (r.point >= b.count) return false;
+    if (r.point == 0) {
+        r.t = b.t0;
+        r.lat = b.lat0;
+        r.lon = b.lon0;
+    } else {
+        uint32_t dt, dlat, dlon;
+        if (!fyGetVarint(b.data, b.len, r.pos, dt) ||
+            !fyGetVarint(b.data, b.len, r.pos, dlat) ||
+            !fyGetVarint(b.data, b.len, r.pos, dlon)) {
+            r.point = b.count;
+            return false;
+        }
+        r.t += dt;
+        r.lat += fyUnzigzag(dlat);
+        r.lon += fyUnzigzag(dlon);
+    }
+    r.point++;
+    return true;
+}
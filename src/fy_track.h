@@ -0,0 +1,64 @@
+/*
+ * Flock-You track blocks - the on-flash unit of the GPS breadcrumb log.
+ *
+ * A block stores its first point in full (FY_TRACK_SCALE fixed point,
+ * seconds after boot) and the rest as zigzag varint deltas of time,
+ * latitude and longitude, 3-5 bytes a point when driving. Blocks carry the
+ * history id of the session that recorded them and a CRC over the header
+ * and the bytes of data in use.
+ */
+
+#ifndef FY_TRACK_H
+#define FY_TRACK_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define FY_TRACK_MAGIC      0x4B525446UL   // "FTRK"
+#define FY_TRACK_BLOCK      512
+#define FY_TRACK_SCALE      100000.0       // Units per degree (~1.1 m)
+#define FY_TRACK_POINT_MAX  15             // Three 5-byte varints
+
+struct FYTrackBlock {
+    uint32_t magic;
+    uint32_t seq;          // Ring order, starts at 1
+    uint32_t session;      // History id of the recording session
+    uint32_t bootEpoch;    // Unix time at that boot, 0 = unknown when written
+    uint32_t t0;           // First point, seconds after boot
+    int32_t lat0, lon0;    // First point, FY_TRACK_SCALE units
+    uint16_t count;        // Points in the block
+    uint16_t len;          // Bytes of data in use
+    uint32_t crc;          // CRC-32 of the header before it and data[0..len)
+    uint8_t data[FY_TRACK_BLOCK - 36];
+};
+static_assert(sizeof(FYTrackBlock) == FY_TRACK_BLOCK, "track block layout");
+
+// Position while decoding a block, point by point
+struct FYTrackReader {
+    uint16_t point;        // Points returned so far
+    uint16_t pos;          // Offset in data
+    uint32_t t;            // Seconds after boot
+    int32_t lat, lon;      // FY_TRACK_SCALE units
+};
+
+int fyPutVarint(uint8_t* p, uint32_t v);
+bool fyGetVarint(const uint8_t* p, uint16_t len, uint16_t& pos, uint32_t& v);
+
+inline uint32_t fyZigzag(int32_t v) { return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31); }
+inline int32_t fyUnzigzag(uint32_t v) { return (int32_t)(v >> 1) ^ -(int32_t)(v & 1); }
+
+uint32_t fyTrackCrc(const FYTrackBlock& b);
+bool fyTrackValid(const FYTrackBlock& b);
+
+// Reset b to hold a single point
+void fyTrackBlockStart(FYTrackBlock& b, uint32_t seq, uint32_t session, uint32_t t, int32_t lat, int32_t lon);
+
+// Add a point after the last one. Returns false (b unchanged) when the
+// block may not have room for it.
+bool fyTrackBlockAppend(FYTrackBlock& b, uint32_t dt, int32_t dlat, int32_t dlon);
+
+// Next point of b into r (zero r first). Returns false after the last
+// point, or at data that does not decode.
+bool fyTrackBlockNext(const FYTrackBlock& b, FYTrackReader& r);
+
+#endif // FY_TRACK_H
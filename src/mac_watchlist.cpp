@@ -0,0 +1,80 @@
+/*
+ * MAC Watchlist - see mac_watchlist.h
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <algorithm>
+#include "mac_watchlist.h"
+
+int parseMACKey(const char* text, uint64_t& key) {
+    key = 0;
+    int nibbles = 0;
+    for (const char* p = text; *p; p++) {
+        char c = *p;
+        if (c == ':' || c == '-' || c == ' ') continue;
+        if (!isxdigit((unsigned char)c) || nibbles >= 12) return 0;
+        uint8_t v = (c <= '9') ? (c - '0') : ((c | 0x20) - 'a' + 10);
+        key = (key << 4) | v;
+        nibbles++;
+    }
+    if (nibbles == 6 || nibbles == 12) return nibbles / 2;
+    return 0;
+}
+
+uint64_t macKeyFromNative(const uint8_t* native) {
+    uint64_t key = 0;
+    for (int i = 5; i >= 0; i--) {
+        key = (key << 8) | native[i];
+    }
+    return key;
+}
+
+void formatMACKey(uint64_t key, char* out, size_t len) {
+    snprintf(out, len, "%02x:%02x:%02x:%02x:%02x:%02x",
+             (unsigned)(key >> 40) & 0xFF, (unsigned)(key >> 32) & 0xFF,
+             (unsigned)(key >> 24) & 0xFF, (unsigned)(key >> 16) & 0xFF,
+             (unsigned)(key >> 8) & 0xFF, (unsigned)key & 0xFF);
+}
+
+static size_t findKey(const std::vector<uint64_t>& table, uint64_t key) {
+    std::vector<uint64_t>::const_iterator it = std::lower_bound(table.begin(), table.end(), key << 16);
+    if (it != table.end() && (*it >> 16) == key) {
+        return (size_t)(*it & 0xFFFF);
+    }
+    return MAC_WATCHLIST_NONE;
+}
+
+void MacWatchlist::clear() {
+    macs.clear();
+    ouis.clear();
+}
+
+bool MacWatchlist::add(const char* identifier, bool fullMAC, size_t index) {
+    if (index >= MAC_WATCHLIST_MAX) return false;
+    uint64_t key;
+    int octets = parseMACKey(identifier, key);
+    // A full address typed into the OUI list used to match as a prefix,
+    // i.e. exactly, so it goes in the MAC set whichever list it came from
+    if (octets == 6) {
+        macs.push_back((key << 16) | index);
+    } else if (octets == 3 && !fullMAC) {
+        ouis.push_back((key << 16) | index);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void MacWatchlist::build() {
+    // Sorting the packed values orders by key, then by filter index, so a
+    // lower_bound lands on the first configured filter for a duplicated key
+    std::sort(macs.begin(), macs.end());
+    std::sort(ouis.begin(), ouis.end());
+    macs.shrink_to_fit();
+    ouis.shrink_to_fit();
+}
+
+size_t MacWatchlist::find(uint64_t mac48) const {
+    return std::min(findKey(macs, mac48), findKey(ouis, mac48 >> 24));
+}
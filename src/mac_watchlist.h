@@ -0,0 +1,57 @@
+/*
+ * MAC Watchlist - allocation-free matching of BLE addresses against a list
+ * of OUI prefixes and full MAC addresses.
+ *
+ * Identifiers are compiled once (when the list is loaded or edited) into two
+ * sorted arrays of (key << 16) | filterIndex: 48-bit MACs and 24-bit OUIs.
+ * A lookup is two binary searches on integers, so it is safe for the NimBLE
+ * callback. The lowest filter index wins when both an OUI and a full MAC
+ * match, the same precedence as a linear scan of the list.
+ *
+ * Not thread-safe: rebuild only while nothing is matching.
+ */
+
+#ifndef MAC_WATCHLIST_H
+#define MAC_WATCHLIST_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+#define MAC_WATCHLIST_MAX 65535  // Filter indices are packed into 16 bits
+#define MAC_WATCHLIST_NONE ((size_t)-1)
+
+// Parse "aa:bb:cc" or "aa:bb:cc:dd:ee:ff" (':' '-' ' ' separators, any case)
+// into an integer key. Returns the number of octets parsed (3 or 6), 0 if invalid.
+int parseMACKey(const char* text, uint64_t& key);
+
+// NimBLE stores addresses little-endian (getNative()[0] is the last octet)
+uint64_t macKeyFromNative(const uint8_t* native);
+
+// Format a 48-bit MAC key as "aa:bb:cc:dd:ee:ff" into a caller-provided buffer
+void formatMACKey(uint64_t key, char* out, size_t len);
+
+class MacWatchlist {
+public:
+    void clear();
+
+    // Index filter number `index`. A six-octet identifier is matched as a
+    // full MAC whichever list it came from; three octets only as an OUI.
+    // Returns false if the identifier was not indexed.
+    bool add(const char* identifier, bool fullMAC, size_t index);
+
+    // Sort the index; call after the last add()
+    void build();
+
+    // Lowest filter index matching the 48-bit address, MAC_WATCHLIST_NONE if none
+    size_t find(uint64_t mac48) const;
+
+    size_t macCount() const { return macs.size(); }
+    size_t ouiCount() const { return ouis.size(); }
+
+private:
+    std::vector<uint64_t> macs;   // key = 48-bit MAC
+    std::vector<uint64_t> ouis;   // key = 24-bit OUI
+};
+
+#endif // MAC_WATCHLIST_H
@@ -14,6 +14,8 @@
 #include <AsyncTCP.h>
 #include <ESPAsyncWebServer.h>
 #include <Preferences.h>
+#include <ArduinoJson.h>
+#include "alert_sequencer.h"
 #include "modes.h"
 
 // Hardware pins (shared across all modes)
@@ -101,110 +103,30 @@ static void randomizeMAC() {
 // ============================================================================
 // Selector Web UI HTML
 // ============================================================================
-static const char SELECTOR_HTML[] PROGMEM = R"rawliteral(
-<!DOCTYPE html><html><head><meta charset="utf-8"><meta name="viewport" content="width=device-width,initial-scale=1,maximum-scale=1,user-scalable=no">
-<title>OUI SPY</title>
-<style>
-*{margin:0;padding:0;box-sizing:border-box}
-html{height:100%;height:-webkit-fill-available;overflow:hidden}
-body{margin:0;height:100vh;height:-webkit-fill-available;font-family:monospace;background:#000;color:#0f0;display:flex;flex-direction:column;padding:4px;overflow:hidden}
-.t{flex:1;display:flex;flex-direction:column;border:2px solid #0f0;padding:6px;overflow:hidden;min-height:0}
-.h{text-align:center;padding-bottom:3px;margin-bottom:3px;border-bottom:1px solid #0f0;flex-shrink:0}
-.ti{font-size:24px;font-weight:bold;letter-spacing:2px}
-.s{font-size:8px;margin-top:1px;opacity:.7}
-#x{flex:1;display:flex;flex-direction:column;min-height:0;overflow:hidden}
-.m{flex:1;display:flex;flex-direction:column;min-height:0;overflow:hidden}
-.i{flex:1;display:flex;flex-direction:column;justify-content:center;align-items:center;border:2px solid #0f0;border-bottom:0;cursor:pointer;background:#000;text-align:center;min-height:0;overflow:hidden}
-.i:last-child{border-bottom:2px solid #0f0}
-.i:active{background:#0f0;color:#000}
-.n{font-size:18px;font-weight:bold;letter-spacing:1px}
-.d{font-size:9px;opacity:.7;margin-top:1px}
-.ap{display:flex;gap:3px;align-items:center;margin-top:4px;border-top:1px solid #0f0;padding-top:4px;flex-shrink:0}
-.ap input{flex:1;padding:4px;background:#000;color:#0f0;border:1px solid #0f0;font-family:monospace;font-size:11px;min-width:0}
-.ap input:focus{outline:none;border-color:#fff;color:#fff}
-.ap .sb{padding:4px 7px;background:#0f0;color:#000;border:none;font-family:monospace;font-size:10px;font-weight:bold;cursor:pointer;white-space:nowrap}
-.ap .sb:active{background:#fff}
-.bz{display:flex;align-items:center;white-space:nowrap;cursor:pointer;font-size:9px;gap:2px;opacity:.7}
-.bz:hover{opacity:1}
-.bz input{margin:0;cursor:pointer}
-.f{padding-top:2px;margin-top:3px;font-size:7px;text-align:center;opacity:.5;flex-shrink:0}
-.boot{flex:1;display:flex;flex-direction:column;justify-content:center;align-items:center;text-align:center;padding:20px}
-.bt{font-size:28px;font-weight:bold;margin-bottom:16px;letter-spacing:2px}
-.bs{font-size:12px;line-height:1.5;margin-bottom:16px;opacity:.9;max-width:500px}
-.br{font-size:13px}
-@keyframes b{0%,50%{opacity:1}51%,100%{opacity:0}}
-.blink{animation:b 1s infinite}
-</style></head><body>
-<div class="t">
-<div class="h"><div class="ti">OUI SPY</div><div class="s">FIRMWARE SELECTOR</div></div>
-<div id="x">
-<div class="m">
-<div class="i" onclick="go(1)"><div class="n">DETECTOR</div><div class="d">BLE Alert Tool for Specific Devices</div></div>
-<div class="i" onclick="go(2)"><div class="n">FOXHUNTER</div><div class="d">RSSI Proximity Tracker</div></div>
-<div class="i" onclick="go(4)"><div class="n">FLOCK-YOU</div><div class="d">Surveillance Detector &bull; AP: flockyou</div></div>
-<div class="i" onclick="go(5)"><div class="n">SKY SPY</div><div class="d">Drone Remote ID Monitor</div></div>
-</div>
-<div class="ap">
-<input type="text" id="ap_ssid" placeholder="SSID" maxlength="32" value="%SSID%">
-<input type="text" id="ap_pass" placeholder="PASSWORD" maxlength="63" value="%PASS%">
-<button class="sb" onclick="saveAP()">SET</button>
-<label class="bz"><input type="checkbox" id="bz" onchange="saveBZ(this.checked)" %BUZZER%>BZR</label>
-</div>
-<div class="f" id="ft">Hold BOOT 2s for menu &bull; MAC randomized</div>
-</div>
-<div id="y" class="boot" style="display:none">
-<div class="bt" id="yt"></div>
-<div class="bs" id="ys"></div>
-<div class="br">REBOOTING<span class="blink">_</span></div>
-</div>
-</div>
-<script>
-var info={1:{t:'DETECTOR',s:'Scans for BLE devices and alerts when specific targets are detected. Configure OUI prefixes and MAC addresses to monitor.'},2:{t:'FOXHUNTER',s:'Track down a specific device using RSSI signal strength. Beeps get faster as you get closer to your target.'},4:{t:'FLOCK-YOU',s:'Detects Flock Safety surveillance cameras via BLE. Serves web dashboard on AP flockyou with live detections, pattern DB, and JSON/CSV export.'},5:{t:'SKY SPY',s:'Monitors for FAA Remote ID broadcasts from drones. Detects Open Drone ID signals over WiFi and BLE.'}};
-function go(m){var d=info[m];document.getElementById('yt').textContent=d.t;document.getElementById('ys').textContent=d.s;document.getElementById('x').style.display='none';document.getElementById('y').style.display='flex';fetch('/select?mode='+m)}
-function saveAP(){
-var s=document.getElementById('ap_ssid').value.trim();
-var p=document.getElementById('ap_pass').value.trim();
-var ft=document.getElementById('ft');
-if(s.length<1||s.length>32){ft.textContent='SSID must be 1-32 chars';return}
-if(p.length>0&&p.length<8){ft.textContent='Password must be 8+ chars or empty';return}
-ft.textContent='SAVING...';
-fetch('/saveap?ssid='+encodeURIComponent(s)+'&pass='+encodeURIComponent(p)).then(function(r){
-if(r.ok){ft.textContent='SAVED! REBOOTING...'}else{ft.textContent='ERROR'}
-}).catch(function(){ft.textContent='ERROR'})}
-function saveBZ(on){fetch('/buzzer?on='+(on?'1':'0'))}
-</script></body></html>
-)rawliteral";
+// web/selector.html, minified + gzipped at build time by scripts/build_web.py
+#include "web/selector_html.h"
 
 // ============================================================================
 // Boot Jingle for Selector - Zelda "Secret Discovered" Style
 // ============================================================================
-static void playNote(int freq, int duration) {
-    ledcSetup(0, freq, 8);
-    ledcAttachPin(BUZZER_PIN, 0);
-    ledcWrite(0, 100);
-    delay(duration);
-    ledcWrite(0, 0);
-}
+// "Secret discovered" ascending jingle, then an LED flash
+static const AlertStep SELECTOR_JINGLE[] = {
+    {784, 0, 150, 0, 0},   // G5
+    {0, 0, 20, 0, 0},
+    {988, 0, 150, 0, 0},   // B5
+    {0, 0, 20, 0, 0},
+    {1175, 0, 150, 0, 0},  // D6
+    {0, 0, 20, 0, 0},
+    {1568, 0, 400, 0, 0},  // G6 (hold)
+    {0, 0, 100, 0, 0},
+    // LED flash sync
+    {0, 0, 50, 0, 1}, {0, 0, 50, 0, 0},
+    {0, 0, 50, 0, 1}, {0, 0, 50, 0, 0},
+    {0, 0, 50, 0, 1}, {0, 0, 50, 0, 0}
+};
 
 static void selectorBeep() {
-    // "Secret discovered" ascending jingle
-    playNote(784, 150);   // G5
-    delay(20);
-    playNote(988, 150);   // B5
-    delay(20);
-    playNote(1175, 150);  // D6
-    delay(20);
-    playNote(1568, 400);  // G6 (hold)
-    delay(100);
-    
-    // LED flash sync
-    pinMode(LED_PIN, OUTPUT);
-    for (int i = 0; i < 3; i++) {
-        digitalWrite(LED_PIN, LOW);   // On
-        delay(50);
-        digitalWrite(LED_PIN, HIGH);  // Off
-        delay(50);
-    }
+    alertPlay(SELECTOR_JINGLE);
 }
 
 // ============================================================================
@@ -298,12 +220,21 @@ static void startSelector() {
         prefs.begin("unified-mode", false);
         prefs.putInt("mode", 0);
         prefs.end();
-        // Build HTML with current AP values injected
-        String html = FPSTR(SELECTOR_HTML);
-        html.replace("%SSID%", apSSID);
-        html.replace("%PASS%", apPassword);
-        html.replace("%BUZZER%", buzzerEnabled ? "checked" : "");
-        request->send(200, "text/html", html);
+        // Static page; current AP values are fetched from /api/settings
+        AsyncWebServerResponse *response = request->beginResponse_P(200, "text/html", SELECTOR_HTML_GZ, SELECTOR_HTML_GZ_LEN);
+        response->addHeader("Content-Encoding", "gzip");
+        request->send(response);
+    });
+    
+    // Current AP config and buzzer setting for the selector page
+    selectorServer.on("/api/settings", HTTP_GET, [](AsyncWebServerRequest *request) {
+        JsonDocument doc;
+        doc["ssid"] = apSSID;
+        doc["pass"] = apPassword;
+        doc["buzzer"] = buzzerEnabled;
+        AsyncResponseStream *response = request->beginResponseStream("application/json");
+        serializeJson(doc, *response);
+        request->send(response);
     });
     
     // Mode selection endpoint - ONLY place that should trigger reboot
@@ -436,6 +367,9 @@ void setup() {
     pinMode(LED_PIN, OUTPUT);
     digitalWrite(LED_PIN, HIGH);  // LED off (inverted logic on XIAO)
     
+    // Non-blocking buzzer/LED alerts for every mode
+    alertBegin(BUZZER_PIN, LED_PIN, true);
+    
     // CRITICAL: Nuke ALL stored WiFi config from NVS.
     // The ESP32 persists AP SSID/password in flash and auto-restores it,
     // causing stale APs from previous firmware to appear on every boot.
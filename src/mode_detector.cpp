@@ -19,7 +19,15 @@
 #include <nvs_flash.h>
 #include <vector>
 #include <algorithm>
+#include <unordered_map>
+#include <atomic>
+#include <esp_heap_caps.h>
 #include <Adafruit_NeoPixel.h>
+#include "alert_sequencer.h"
+#include "adv_interval.h"
+#include "mac_watchlist.h"
+#include "device_table.h"
+#include "spsc_ring.h"
 #include "modes.h"
 
 // Rename setup/loop to avoid conflict with Arduino entry points
@@ -18,13 +18,26 @@
 #include <ctype.h>
 #include <stdio.h>
 #include <stdint.h>
+#include <vector>
+#include <algorithm>
+#include <memory>
 #include "esp_wifi.h"
 #include "esp_wifi_types.h"
 #include <AsyncTCP.h>
 #include <ESPAsyncWebServer.h>
 #include <SPIFFS.h>
 #include <TinyGPS++.h>
+#include <esp_heap_caps.h>
 #include <Adafruit_NeoPixel.h>
+#include "alert_sequencer.h"
+#include "adv_interval.h"
+#include "name_matcher.h"
+#include "fy_raven.h"
+#include "fy_scoring.h"
+#include "fy_record.h"
+#include "fy_json_split.h"
+#include "fy_track.h"
+#include "fy_gps.h"
 #include "modes.h"
 
 // Rename setup/loop
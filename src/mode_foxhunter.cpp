@@ -14,6 +14,8 @@
 #include <NimBLEScan.h>
 #include <NimBLEAdvertisedDevice.h>
 #include <esp_wifi.h>
+#include <ArduinoJson.h>
+#include "alert_sequencer.h"
 #include "modes.h"
 
 // Rename setup/loop
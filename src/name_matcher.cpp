@@ -0,0 +1,125 @@
+/*
+ * Name Matcher - see name_matcher.h
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <algorithm>
+#include <utility>
+#include "name_matcher.h"
+
+uint16_t NameMatcher::step(uint16_t node, uint8_t c) const {
+    uint16_t lo = edgeStart[node], hi = edgeStart[node + 1];
+    while (lo < hi) {
+        uint16_t mid = lo + (hi - lo) / 2;
+        if (edgeChar[mid] < c) lo = mid + 1;
+        else hi = mid;
+    }
+    return (lo < edgeStart[node + 1] && edgeChar[lo] == c) ? edgeNext[lo] : NAME_MATCHER_NONE;
+}
+
+size_t NameMatcher::build(const char* const* patterns, size_t count) {
+    typedef std::vector<std::pair<uint8_t, uint16_t> > Edges;
+    std::vector<Edges> kids(1);
+
+    if (count > NAME_MATCHER_NONE) count = NAME_MATCHER_NONE;
+    out.assign(1, NAME_MATCHER_NONE);
+    outNext.assign(count, NAME_MATCHER_NONE);
+
+    // 1. Trie of case-folded patterns
+    for (size_t p = 0; p < count; p++) {
+        const char* pat = patterns[p];
+        if (!pat || !pat[0]) continue;
+        uint16_t node = 0;
+        bool full = false;
+        for (const char* c = pat; *c; c++) {
+            uint8_t fc = (uint8_t)tolower((uint8_t)*c);
+            uint16_t next = NAME_MATCHER_NONE;
+            for (size_t e = 0; e < kids[node].size(); e++) {
+                if (kids[node][e].first == fc) { next = kids[node][e].second; break; }
+            }
+            if (next == NAME_MATCHER_NONE) {
+                if (kids.size() >= NAME_MATCHER_NONE) { full = true; break; }
+                next = (uint16_t)kids.size();
+                kids[node].push_back(std::make_pair(fc, next));
+                kids.push_back(Edges());
+                out.push_back(NAME_MATCHER_NONE);
+            }
+            node = next;
+        }
+        if (full) {
+            printf("[NAMES] Matcher full, skipping \"%s\"\n", pat);
+            continue;
+        }
+        outNext[p] = out[node];
+        out[node] = (uint16_t)p;
+    }
+
+    // 2. Flatten edges, sorted per node for binary search
+    size_t nodes = kids.size();
+    edgeStart.assign(nodes + 1, 0);
+    edgeChar.clear();
+    edgeNext.clear();
+    edgeChar.reserve(nodes - 1);
+    edgeNext.reserve(nodes - 1);
+    for (size_t n = 0; n < nodes; n++) {
+        std::sort(kids[n].begin(), kids[n].end());
+        edgeStart[n] = (uint16_t)edgeChar.size();
+        for (size_t e = 0; e < kids[n].size(); e++) {
+            edgeChar.push_back(kids[n][e].first);
+            edgeNext.push_back(kids[n][e].second);
+        }
+    }
+    edgeStart[nodes] = (uint16_t)edgeChar.size();
+
+    // 3. Fail and dict links, breadth-first so parents are done first
+    fail.assign(nodes, 0);
+    dict.assign(nodes, 0);
+    std::vector<uint16_t> queue;
+    queue.reserve(nodes);
+    queue.push_back(0);
+    for (size_t qi = 0; qi < queue.size(); qi++) {
+        uint16_t u = queue[qi];
+        for (uint16_t e = edgeStart[u]; e < edgeStart[u + 1]; e++) {
+            uint8_t c = edgeChar[e];
+            uint16_t v = edgeNext[e];
+            uint16_t f = 0;
+            if (u != 0) {
+                f = fail[u];
+                uint16_t g;
+                while ((g = step(f, c)) == NAME_MATCHER_NONE && f != 0) f = fail[f];
+                f = (g == NAME_MATCHER_NONE) ? 0 : g;
+            }
+            fail[v] = f;
+            dict[v] = (out[f] != NAME_MATCHER_NONE) ? f : dict[f];
+            queue.push_back(v);
+        }
+    }
+    return nodes;
+}
+
+int NameMatcher::match(const char* name, uint16_t* hits, int maxHits) const {
+    if (!name || fail.empty() || maxHits <= 0) return 0;
+    int n = 0;
+    uint16_t state = 0;
+    for (const char* p = name; *p; p++) {
+        uint8_t c = (uint8_t)tolower((uint8_t)*p);
+        uint16_t next;
+        while ((next = step(state, c)) == NAME_MATCHER_NONE && state != 0) state = fail[state];
+        state = (next == NAME_MATCHER_NONE) ? 0 : next;
+
+        uint16_t o = (out[state] != NAME_MATCHER_NONE) ? state : dict[state];
+        for (; o != 0; o = dict[o]) {
+            for (uint16_t pat = out[o]; pat != NAME_MATCHER_NONE; pat = outNext[pat]) {
+                bool seen = false;
+                for (int i = 0; i < n; i++) {
+                    if (hits[i] == pat) { seen = true; break; }
+                }
+                if (seen) continue;
+                hits[n++] = pat;
+                if (n >= maxHits) return n;
+            }
+        }
+    }
+    return n;
+}
@@ -0,0 +1,49 @@
+/*
+ * Name Matcher - case-folded Aho-Corasick over a list of name fragments.
+ *
+ * The patterns are compiled once (at boot or when the list changes) so a
+ * name is scanned in a single pass whatever the number of patterns, and
+ * every pattern it contains is reported. Matching never allocates.
+ *
+ * Not thread-safe: build() must not run while another task calls match().
+ */
+
+#ifndef NAME_MATCHER_H
+#define NAME_MATCHER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+#define NAME_MATCHER_NONE 0xFFFF  // No edge / no pattern; also caps the node count
+
+class NameMatcher {
+public:
+    // Compile patterns (empty and NULL entries never match). Patterns that
+    // do not fit in the node budget are skipped. Returns the node count.
+    size_t build(const char* const* patterns, size_t count);
+
+    // Single pass over name. Writes the distinct indices of matched patterns
+    // into hits and returns how many; stops early once maxHits are found.
+    int match(const char* name, uint16_t* hits, int maxHits) const;
+
+    bool empty() const { return fail.empty(); }
+    size_t nodes() const { return fail.size(); }
+
+private:
+    // Trie node edges are flattened into sorted runs
+    // (edgeStart[n] .. edgeStart[n + 1]). Fail links fall back to the
+    // longest suffix that is also a trie prefix; dict links jump to the
+    // next suffix node that ends a pattern (0 = none).
+    std::vector<uint16_t> edgeStart;
+    std::vector<uint8_t>  edgeChar;
+    std::vector<uint16_t> edgeNext;
+    std::vector<uint16_t> fail;
+    std::vector<uint16_t> dict;
+    std::vector<uint16_t> out;      // Per node: first pattern ending here
+    std::vector<uint16_t> outNext;  // Per pattern: next pattern at same node
+
+    uint16_t step(uint16_t node, uint8_t c) const;
+};
+
+#endif // NAME_MATCHER_H
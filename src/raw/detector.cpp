@@ -12,7 +12,15 @@
 #include <nvs_flash.h>
 #include <vector>
 #include <algorithm>
+#include <unordered_map>
+#include <atomic>
+#include <esp_heap_caps.h>
 #include <Adafruit_NeoPixel.h>
+#include "alert_sequencer.h"
+#include "adv_interval.h"
+#include "mac_watchlist.h"
+#include "device_table.h"
+#include "spsc_ring.h"
 
 // ================================
 // Pin and Buzzer Definitions - Xiao ESP32 S3
@@ -68,27 +76,24 @@ unsigned long modeSwitchScheduled = 0; // When to switch modes (0 = not schedule
 unsigned long deviceResetScheduled = 0; // When to reset device (0 = not scheduled)
 unsigned long normalRestartScheduled = 0; // When to do normal restart (0 = not scheduled)
 
-// Serial output synchronization - avoid concurrent writes
-volatile bool newMatchFound = false;
-String detectedMAC = "";
-int detectedRSSI = 0;
-String matchedFilter = "";
-String matchType = "";  // "NEW", "RE-3s", "RE-30s"
 
 // Persistent settings
 bool buzzerEnabled = true;
 bool ledEnabled = true;
+volatile bool devicesDirty = false;  // Device history changed since last NVS write
+uint8_t scanProfile = 0;             // Index into SCAN_PROFILES
 
-// Device tracking
+// Device tracking (plain data so the table can live in PSRAM without constructors)
 struct DeviceInfo {
-    String macAddress;
+    uint64_t macKey;  // 48-bit MAC for allocation-free comparison
     int rssi;
     unsigned long firstSeen;
     unsigned long lastSeen;
     bool inCooldown;
     unsigned long cooldownUntil;
     const char* matchedFilter;
-    String filterDescription;  // Store filter description for persistence
+    char filterDescription[24];  // Store filter description for persistence
+    AdvInterval adv;  // Gaps between advertisements, every one heard
 };
 
 struct TargetFilter {
@@ -97,17 +102,74 @@ struct TargetFilter {
     String description;
 };
 
-struct DeviceAlias {
-    String macAddress;
-    String alias;
+// BLE scan duty-cycle profiles (selected on the config page)
+struct ScanProfile {
+    const char* name;
+    uint16_t intervalMs;
+    uint16_t windowMs;
 };
 
-std::vector<DeviceInfo> devices;
+// Window/interval is the radio duty cycle; WiFi is off while scanning
+const ScanProfile SCAN_PROFILES[] = {
+    {"continuous", 100, 100},  // 100% - catches the shortest advertising bursts
+    {"balanced",   300, 200},  // 67%  - previous fixed setting
+    {"low-power",  500, 100}   // 20%
+};
+#define SCAN_PROFILE_COUNT (sizeof(SCAN_PROFILES) / sizeof(SCAN_PROFILES[0]))
+
+// ================================
+// Detection Event Ring - BLE callback -> loop()
+// ================================
+// Single-producer (NimBLE host task) / single-consumer (loop) ring of
+// compact match events (spsc_ring.h), so bursts of matches between two
+// loop iterations are queued instead of overwriting each other.
+#define DETECTION_RING_SIZE 64    // Power of two
+#define DETECTION_DRAIN_BATCH 16  // Events handled per loop() iteration
+
+enum DetectionType : uint8_t {
+    DETECTION_NEW = 0,
+    DETECTION_RE_3S,
+    DETECTION_RE_30S
+};
+
+struct DetectionEvent {
+    uint64_t macKey;  // 48-bit MAC, formatted only when printed
+    int8_t rssi;
+    uint8_t type;     // DetectionType
+};
+
+typedef SpscRing<DetectionEvent, DETECTION_RING_SIZE> DetectionRing;
+
+// ================================
+// Device Table - fixed capacity, hashed by MAC, LRU eviction
+// ================================
+#define MAX_TRACKED_DEVICES 2048      // Configurable capacity (PSRAM)
+#define FALLBACK_TRACKED_DEVICES 256  // Used when PSRAM is unavailable
+
+DeviceTable<DeviceInfo> devices;
+
+// The NimBLE host task mutates the table while loop() saves it: both hold
+// this spinlock, and only for table work (no queueing or I/O inside)
+portMUX_TYPE devicesMux = portMUX_INITIALIZER_UNLOCKED;
+
+bool allocateDevices(size_t capacity, uint32_t caps) {
+    void* mem = heap_caps_malloc(DeviceTable<DeviceInfo>::bytesFor(capacity), caps);
+    if (devices.attach(mem, capacity)) return true;
+    free(mem);
+    return false;
+}
+
+DetectionRing detectionRing;
 std::vector<TargetFilter> targetFilters;
-std::vector<DeviceAlias> deviceAliases;
+// Aliases keyed by 48-bit MAC; normalized once when loaded or set
+std::unordered_map<uint64_t, String> deviceAliases;
+
+// Compiled watchlist index (rebuilt from targetFilters by compileTargetFilters)
+MacWatchlist targetIndex;
 
 // Forward declarations
 void startScanningMode();
+void compileTargetFilters();
 void startDetectionFlash();
 class MyAdvertisedDeviceCallbacks;
 
@@ -150,39 +212,54 @@ void initializeBuzzer() {
     // Setup LED (inverted logic - HIGH = OFF for Xiao ESP32-S3)
     pinMode(LED_PIN, OUTPUT);
     digitalWrite(LED_PIN, HIGH);
-}
 
-void digitalBeep(int duration) {
-    unsigned long startTime = millis();
-    while (millis() - startTime < duration) {
-        digitalWrite(BUZZER_PIN, HIGH);
-        delayMicroseconds(250);
-        digitalWrite(BUZZER_PIN, LOW);
-        delayMicroseconds(250);
-    }
 }
 
+// Beep patterns are queued on the shared alert sequencer, so none of these
+// block - they are safe to call from the BLE callback. Each beep keeps the
+// original two halves: an LEDC tone, then the bit-banged 250us/250us square
+// wave (also 2 kHz), with the LED lit throughout.
+static const AlertStep SINGLE_BEEP[] = {
+    {BUZZER_FREQ, 0, BEEP_DURATION, 0, 1},
+    {BUZZER_FREQ, 0, BEEP_DURATION, 0, 1}
+};
+
+static const AlertStep TWO_BEEPS[] = {
+    {BUZZER_FREQ, 0, BEEP_DURATION, 0, 1},
+    {BUZZER_FREQ, 0, BEEP_DURATION, 0, 1},
+    {0, 0, BEEP_PAUSE, 0, 0},
+    {BUZZER_FREQ, 0, BEEP_DURATION, 0, 1},
+    {BUZZER_FREQ, 0, BEEP_DURATION, 0, 1}
+};
+
+static const AlertStep THREE_BEEPS[] = {
+    {BUZZER_FREQ, 0, BEEP_DURATION, 0, 1},
+    {BUZZER_FREQ, 0, BEEP_DURATION, 0, 1},
+    {0, 0, BEEP_PAUSE, 0, 0},
+    {BUZZER_FREQ, 0, BEEP_DURATION, 0, 1},
+    {BUZZER_FREQ, 0, BEEP_DURATION, 0, 1},
+    {0, 0, BEEP_PAUSE, 0, 0},
+    {BUZZER_FREQ, 0, BEEP_DURATION, 0, 1},
+    {BUZZER_FREQ, 0, BEEP_DURATION, 0, 1}
+};
+
+// Two fast ascending beeps to indicate "ready to scan"
+// (close melodic interval, not octave)
+static const AlertStep ASCENDING_BEEPS[] = {
+    {1900, 0, BEEP_DURATION, 0, 1},
+    {0, 0, 100, 0, 0},
+    {2200, 0, BEEP_DURATION, 0, 1}
+};
+
 void singleBeep() {
-    if (buzzerEnabled) {
-        ledcWrite(0, BUZZER_DUTY);
-    }
-    ledOn();
-    delay(BEEP_DURATION);
-    if (buzzerEnabled) {
-        ledcWrite(0, 0);
-        digitalBeep(BEEP_DURATION);
-    }
-    ledOff();
+    alertPlay(SINGLE_BEEP, buzzerEnabled, ledEnabled);
 }
 
 void threeBeeps() {
     // Start detection flash animation
     startDetectionFlash();
     
-    for(int i = 0; i < 3; i++) {
-        singleBeep();
-        if (i < 2) delay(BEEP_PAUSE);
-    }
+    alertPlay(THREE_BEEPS, buzzerEnabled, ledEnabled);
 }
 
 // ================================
@@ -324,35 +401,142 @@ void startDetectionFlash() {
 }
 
 void twoBeeps() {
-    for(int i = 0; i < 2; i++) {
-        singleBeep();
-        if (i < 1) delay(BEEP_PAUSE);
-    }
+    alertPlay(TWO_BEEPS, buzzerEnabled, ledEnabled);
 }
 
 void ascendingBeeps() {
-    // Two fast ascending beeps to indicate "ready to scan"
-    int frequencies[] = {1900, 2200}; // Close melodic interval, not octave
-    int fastPause = 100; // Faster than normal beeps
-    
-    for (int i = 0; i < 2; i++) {
-        if (buzzerEnabled) {
-            ledcSetup(0, frequencies[i], 8);
-            ledcWrite(0, BUZZER_DUTY);
-        }
-        ledOn();
-        delay(BEEP_DURATION);
-        if (buzzerEnabled) {
-            ledcWrite(0, 0);
-        }
-        ledOff();
-        if (i < 1) delay(fastPause);
+    alertPlay(ASCENDING_BEEPS, buzzerEnabled, ledEnabled);
+}
+
+// ================================
+// Binary NVS Record Storage
+// ================================
+// Lists are persisted as fixed-size records packed into versioned blobs
+// "<prefix>0", "<prefix>1", ... of at most NVS_BLOB_PAGE_BYTES each, instead
+// of several NVS keys per entry. A page is only rewritten when its bytes
+// differ from what is already stored, so an unchanged save costs no flash.
+#define NVS_BLOB_MAGIC 0x5355494F  // "OIUS"
+#define NVS_BLOB_PAGE_BYTES 1984
+#define NVS_BLOB_MAX_PAGES 16
+
+#define FILTER_RECORD_VERSION 1
+#define ALIAS_RECORD_VERSION 1
+#define DEVICE_RECORD_VERSION 1
+
+struct BlobPageHeader {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t recordSize;
+    uint16_t count;  // records in this page
+};
+
+struct StoredFilter {
+    uint8_t isFullMAC;
+    char identifier[18];
+    char description[29];
+};
+
+struct StoredAlias {
+    uint8_t mac[6];
+    char alias[34];
+};
+
+struct StoredDevice {
+    uint8_t mac[6];
+    int8_t rssi;
+    uint8_t reserved;
+    uint32_t lastSeen;
+    char filterDescription[24];
+};
+
+static uint8_t blobPage[NVS_BLOB_PAGE_BYTES];
+static uint8_t blobCompare[NVS_BLOB_PAGE_BYTES];
+
+// Write count records of recordSize bytes. preferences must be open read-write.
+bool writeRecordBlob(const char* prefix, uint8_t version, const void* records,
+                     size_t recordSize, size_t count) {
+    const size_t perPage = (NVS_BLOB_PAGE_BYTES - sizeof(BlobPageHeader)) / recordSize;
+    const uint8_t* src = (const uint8_t*)records;
+    size_t written = 0;
+    int page = 0;
+    bool ok = true;
+    char key[16];
+    
+    // Always write page 0 (even when empty) so its presence marks the format
+    do {
+        size_t n = min(count - written, perPage);
+        BlobPageHeader header = { NVS_BLOB_MAGIC, version, (uint8_t)recordSize, (uint16_t)n };
+        memcpy(blobPage, &header, sizeof(header));
+        if (n > 0) memcpy(blobPage + sizeof(header), src + written * recordSize, n * recordSize);
+        size_t len = sizeof(header) + n * recordSize;
+        
+        snprintf(key, sizeof(key), "%s%d", prefix, page);
+        bool same = preferences.getBytesLength(key) == len &&
+                    preferences.getBytes(key, blobCompare, len) == len &&
+                    memcmp(blobPage, blobCompare, len) == 0;
+        if (!same && preferences.putBytes(key, blobPage, len) != len) {
+            ok = false;
+            break;
+        }
+        written += n;
+        page++;
+    } while (written < count && page < NVS_BLOB_MAX_PAGES);
+    
+    // Drop pages left over from a longer list
+    for (int stale = page; stale < NVS_BLOB_MAX_PAGES; stale++) {
+        snprintf(key, sizeof(key), "%s%d", prefix, stale);
+        if (!preferences.isKey(key)) break;
+        preferences.remove(key);
     }
     
-    // Reset to original frequency for future beeps
-    if (buzzerEnabled) {
-        ledcSetup(0, BUZZER_FREQ, 8);
+    if (isSerialConnected() && (!ok || written < count)) {
+        Serial.println("NVS blob '" + String(prefix) + "' truncated: stored " + String(written) +
+                       " of " + String(count) + " records");
+    }
+    return ok;
+}
+
+// Read records page by page, calling onRecord for each one. Returns the
+// number of records read, or -1 when no blob of this version exists.
+template <typename RecordFn>
+int readRecordBlob(const char* prefix, uint8_t version, size_t recordSize, RecordFn onRecord) {
+    int total = 0;
+    bool found = false;
+    char key[16];
+    
+    for (int page = 0; page < NVS_BLOB_MAX_PAGES; page++) {
+        snprintf(key, sizeof(key), "%s%d", prefix, page);
+        size_t len = preferences.getBytesLength(key);
+        if (len < sizeof(BlobPageHeader) || len > NVS_BLOB_PAGE_BYTES) break;
+        if (preferences.getBytes(key, blobPage, len) != len) break;
+        
+        BlobPageHeader header;
+        memcpy(&header, blobPage, sizeof(header));
+        if (header.magic != NVS_BLOB_MAGIC || header.version != version ||
+            header.recordSize != recordSize ||
+            sizeof(header) + header.count * recordSize > len) {
+            break;
+        }
+        found = true;
+        
+        for (uint16_t i = 0; i < header.count; i++) {
+            onRecord(blobPage + sizeof(header) + i * recordSize);
+        }
+        total += header.count;
     }
+    
+    return found ? total : -1;
+}
+
+// Remove the pre-blob "<prefix>N" keys once their data has been migrated
+void removeLegacyKeys(const char* countKey, const char* const* prefixes, size_t prefixCount) {
+    int count = preferences.getInt(countKey, 0);
+    for (int i = 0; i < count; i++) {
+        for (size_t p = 0; p < prefixCount; p++) {
+            preferences.remove((String(prefixes[p]) + String(i)).c_str());
+        }
+    }
+    preferences.remove(countKey);
 }
 
 // ================================
@@ -360,18 +544,20 @@ void ascendingBeeps() {
 // ================================
 void saveConfiguration() {
     preferences.begin("ouispy", false);
-    preferences.putInt("filterCount", targetFilters.size());
     preferences.putBool("buzzerEnabled", buzzerEnabled);
     preferences.putBool("ledEnabled", ledEnabled);
-    
-    for (int i = 0; i < targetFilters.size(); i++) {
-        String keyId = "id_" + String(i);
-        String keyMAC = "mac_" + String(i);
-        String keyDesc = "desc_" + String(i);
-        
-        preferences.putString(keyId.c_str(), targetFilters[i].identifier);
-        preferences.putBool(keyMAC.c_str(), targetFilters[i].isFullMAC);
-        preferences.putString(keyDesc.c_str(), targetFilters[i].description);
+    preferences.putUChar("scanProfile", scanProfile);
+    
+    size_t count = targetFilters.size();
+    StoredFilter* records = (StoredFilter*)calloc(count ? count : 1, sizeof(StoredFilter));
+    if (records) {
+        for (size_t i = 0; i < count; i++) {
+            records[i].isFullMAC = targetFilters[i].isFullMAC;
+            strncpy(records[i].identifier, targetFilters[i].identifier.c_str(), sizeof(records[i].identifier) - 1);
+            strncpy(records[i].description, targetFilters[i].description.c_str(), sizeof(records[i].description) - 1);
+        }
+        writeRecordBlob("filters", FILTER_RECORD_VERSION, records, sizeof(StoredFilter), count);
+        free(records);
     }
     
     preferences.end();
@@ -381,34 +567,68 @@ void saveConfiguration() {
     }
 }
 
+// Pre-blob format: id_N / mac_N / desc_N keys per filter
+static const char* const LEGACY_FILTER_KEYS[] = { "id_", "mac_", "desc_" };
+
+void loadLegacyFilters() {
+    int filterCount = preferences.getInt("filterCount", 0);
+    for (int i = 0; i < filterCount; i++) {
+        String keyId = "id_" + String(i);
+        String keyMAC = "mac_" + String(i);
+        String keyDesc = "desc_" + String(i);
+        
+        TargetFilter filter;
+        filter.identifier = preferences.getString(keyId.c_str(), "");
+        filter.isFullMAC = preferences.getBool(keyMAC.c_str(), false);
+        filter.description = preferences.getString(keyDesc.c_str(), "");
+        
+        if (filter.identifier.length() > 0) {
+            targetFilters.push_back(filter);
+        }
+    }
+}
+
 void loadConfiguration() {
     preferences.begin("ouispy", true);
-    int filterCount = preferences.getInt("filterCount", 0);
     buzzerEnabled = preferences.getBool("buzzerEnabled", true);
     ledEnabled = preferences.getBool("ledEnabled", true);
+    scanProfile = preferences.getUChar("scanProfile", 0);
+    if (scanProfile >= SCAN_PROFILE_COUNT) scanProfile = 0;
     
     targetFilters.clear();
     
     // Load saved filters (no defaults - start empty)
-    if (filterCount > 0) {
-        for (int i = 0; i < filterCount; i++) {
-            String keyId = "id_" + String(i);
-            String keyMAC = "mac_" + String(i);
-            String keyDesc = "desc_" + String(i);
+    int loaded = readRecordBlob("filters", FILTER_RECORD_VERSION, sizeof(StoredFilter),
+        [](const uint8_t* data) {
+            StoredFilter record;
+            memcpy(&record, data, sizeof(record));
+            record.identifier[sizeof(record.identifier) - 1] = '\0';
+            record.description[sizeof(record.description) - 1] = '\0';
             
             TargetFilter filter;
-            filter.identifier = preferences.getString(keyId.c_str(), "");
-            filter.isFullMAC = preferences.getBool(keyMAC.c_str(), false);
-            filter.description = preferences.getString(keyDesc.c_str(), "");
-            
+            filter.identifier = record.identifier;
+            filter.isFullMAC = record.isFullMAC;
+            filter.description = record.description;
             if (filter.identifier.length() > 0) {
                 targetFilters.push_back(filter);
             }
-        }
+        });
+    bool legacy = loaded < 0 && preferences.isKey("filterCount");
+    if (legacy) {
+        loadLegacyFilters();
     }
     // No default values - form starts empty (placeholder examples remain in HTML)
     
     preferences.end();
+    
+    if (legacy) {
+        saveConfiguration();
+        preferences.begin("ouispy", false);
+        removeLegacyKeys("filterCount", LEGACY_FILTER_KEYS, 3);
+        preferences.end();
+    }
+    
+    compileTargetFilters();
 }
 
 void loadWiFiCredentials() {
@@ -456,27 +676,46 @@ bool isValidMAC(const String& mac) {
     return true;
 }
 
-bool matchesTargetFilter(const String& deviceMAC, String& matchedDescription) {
-    String normalizedDeviceMAC = deviceMAC;
-    normalizeMACAddress(normalizedDeviceMAC);
-    
-    for (const TargetFilter& filter : targetFilters) {
-        String filterID = filter.identifier;
-        normalizeMACAddress(filterID);
-        
-        if (filter.isFullMAC) {
-            if (normalizedDeviceMAC.equals(filterID)) {
-                matchedDescription = filter.description;
-                return true;
-            }
+// Write a quoted, escaped JSON string without building a temporary String
+void printJSONString(Print& out, const char* text) {
+    out.print('"');
+    for (const char* p = text; *p; p++) {
+        char c = *p;
+        if (c == '"' || c == '\\') {
+            out.print('\\');
+            out.print(c);
+        } else if ((uint8_t)c < 0x20) {
+            out.printf("\\u%04x", c);
         } else {
-            if (normalizedDeviceMAC.startsWith(filterID)) {
-                matchedDescription = filter.description;
-                return true;
-            }
+            out.print(c);
         }
     }
-    return false;
+    out.print('"');
+}
+
+// Rebuild the sorted integer index from targetFilters. Call whenever the
+// filter list changes (load, /save, /clear) - never from the BLE callback.
+void compileTargetFilters() {
+    targetIndex.clear();
+    size_t count = min(targetFilters.size(), (size_t)MAC_WATCHLIST_MAX);
+    for (size_t i = 0; i < count; i++) {
+        targetIndex.add(targetFilters[i].identifier.c_str(), targetFilters[i].isFullMAC, i);
+    }
+    targetIndex.build();
+
+    if (isSerialConnected()) {
+        Serial.println("Compiled filter index: " + String(targetIndex.macCount()) + " MACs, " +
+                       String(targetIndex.ouiCount()) + " OUIs");
+    }
+}
+
+// O(log n), allocation-free lookup of a 48-bit MAC against the compiled index.
+// When both an OUI and a full MAC match, the one configured first wins
+// (same precedence as the original linear scan).
+const TargetFilter* findTargetFilter(uint64_t mac48) {
+    size_t idx = targetIndex.find(mac48);
+    if (idx >= targetFilters.size()) return nullptr;
+    return &targetFilters[idx];
 }
 
 // ================================
@@ -484,14 +723,20 @@ bool matchesTargetFilter(const String& deviceMAC, String& matchedDescription) {
 // ================================
 void saveDeviceAliases() {
     preferences.begin("ouispy", false);
-    preferences.putInt("aliasCount", deviceAliases.size());
     
-    for (int i = 0; i < deviceAliases.size(); i++) {
-        String keyMac = "alias_mac_" + String(i);
-        String keyName = "alias_name_" + String(i);
-        
-        preferences.putString(keyMac.c_str(), deviceAliases[i].macAddress);
-        preferences.putString(keyName.c_str(), deviceAliases[i].alias);
+    size_t count = deviceAliases.size();
+    StoredAlias* records = (StoredAlias*)calloc(count ? count : 1, sizeof(StoredAlias));
+    if (records) {
+        size_t i = 0;
+        for (const auto& entry : deviceAliases) {
+            for (int b = 0; b < 6; b++) {
+                records[i].mac[b] = (entry.first >> (40 - 8 * b)) & 0xFF;
+            }
+            strncpy(records[i].alias, entry.second.c_str(), sizeof(records[i].alias) - 1);
+            i++;
+        }
+        writeRecordBlob("aliases", ALIAS_RECORD_VERSION, records, sizeof(StoredAlias), count);
+        free(records);
     }
     
     preferences.end();
@@ -501,140 +746,187 @@ void saveDeviceAliases() {
     }
 }
 
-void loadDeviceAliases() {
-    preferences.begin("ouispy", true);
+// Pre-blob format: alias_mac_N / alias_name_N keys per alias
+static const char* const LEGACY_ALIAS_KEYS[] = { "alias_mac_", "alias_name_" };
+
+void loadLegacyAliases() {
     int aliasCount = preferences.getInt("aliasCount", 0);
-    
-    deviceAliases.clear();
-    
     for (int i = 0; i < aliasCount; i++) {
         String keyMac = "alias_mac_" + String(i);
         String keyName = "alias_name_" + String(i);
         
-        DeviceAlias alias;
-        alias.macAddress = preferences.getString(keyMac.c_str(), "");
-        alias.alias = preferences.getString(keyName.c_str(), "");
+        String macAddress = preferences.getString(keyMac.c_str(), "");
+        String alias = preferences.getString(keyName.c_str(), "");
         
-        if (alias.macAddress.length() > 0 && alias.alias.length() > 0) {
-            deviceAliases.push_back(alias);
+        uint64_t macKey;
+        if (alias.length() > 0 && parseMACKey(macAddress.c_str(), macKey) == 6) {
+            deviceAliases[macKey] = alias;
         }
     }
+}
+
+void loadDeviceAliases() {
+    preferences.begin("ouispy", true);
+    
+    deviceAliases.clear();
+    
+    int loaded = readRecordBlob("aliases", ALIAS_RECORD_VERSION, sizeof(StoredAlias),
+        [](const uint8_t* data) {
+            StoredAlias record;
+            memcpy(&record, data, sizeof(record));
+            record.alias[sizeof(record.alias) - 1] = '\0';
+            
+            uint64_t macKey = 0;
+            for (int b = 0; b < 6; b++) {
+                macKey = (macKey << 8) | record.mac[b];
+            }
+            if (record.alias[0]) {
+                deviceAliases[macKey] = record.alias;
+            }
+        });
+    bool legacy = loaded < 0 && preferences.isKey("aliasCount");
+    if (legacy) {
+        loadLegacyAliases();
+    }
     
     preferences.end();
     
+    if (legacy) {
+        saveDeviceAliases();
+        preferences.begin("ouispy", false);
+        removeLegacyKeys("aliasCount", LEGACY_ALIAS_KEYS, 2);
+        preferences.end();
+    }
+    
     if (isSerialConnected()) {
         Serial.println("Device aliases loaded from NVS (" + String(deviceAliases.size()) + " aliases)");
     }
 }
 
-String getDeviceAlias(const String& macAddress) {
-    String normalizedMAC = macAddress;
-    normalizeMACAddress(normalizedMAC);
-    
-    for (const DeviceAlias& alias : deviceAliases) {
-        String normalizedAliasMAC = alias.macAddress;
-        normalizeMACAddress(normalizedAliasMAC);
-        
-        if (normalizedAliasMAC.equals(normalizedMAC)) {
-            return alias.alias;
-        }
-    }
-    
-    return ""; // No alias found
+// O(1) alias lookup; returns "" when the device has no alias
+const char* getDeviceAlias(uint64_t macKey) {
+    auto it = deviceAliases.find(macKey);
+    return it != deviceAliases.end() ? it->second.c_str() : "";
 }
 
-void setDeviceAlias(const String& macAddress, const String& alias) {
-    String normalizedMAC = macAddress;
-    normalizeMACAddress(normalizedMAC);
-    
-    // Check if alias already exists, update it
-    for (auto& deviceAlias : deviceAliases) {
-        String normalizedAliasMAC = deviceAlias.macAddress;
-        normalizeMACAddress(normalizedAliasMAC);
-        
-        if (normalizedAliasMAC.equals(normalizedMAC)) {
-            if (alias.length() > 0) {
-                deviceAlias.alias = alias;
-            } else {
-                // Remove alias if empty - find and remove the entry
-                for (size_t i = 0; i < deviceAliases.size(); i++) {
-                    String mac = deviceAliases[i].macAddress;
-                    normalizeMACAddress(mac);
-                    if (mac.equals(normalizedMAC)) {
-                        deviceAliases.erase(deviceAliases.begin() + i);
-                        break;
-                    }
-                }
-            }
-            return;
-        }
+// Set or (with an empty alias) remove a device alias. Returns false if the
+// MAC address cannot be parsed.
+bool setDeviceAlias(const String& macAddress, const String& alias) {
+    uint64_t macKey;
+    if (parseMACKey(macAddress.c_str(), macKey) != 6) {
+        return false;
     }
     
-    // Add new alias if not empty
     if (alias.length() > 0) {
-        DeviceAlias newAlias;
-        newAlias.macAddress = normalizedMAC;
-        newAlias.alias = alias;
-        deviceAliases.push_back(newAlias);
+        deviceAliases[macKey] = alias;
+    } else {
+        deviceAliases.erase(macKey);
     }
+    return true;
 }
 
 // ================================
 // Persistent Device Storage Functions
 // ================================
+#define MAX_PERSISTED_DEVICES 100  // NVS partition is 20 KB; keep the most recent
+
 void saveDetectedDevices() {
-    preferences.begin("ouispy", false);
+    StoredDevice* records = (StoredDevice*)calloc(MAX_PERSISTED_DEVICES, sizeof(StoredDevice));
+    if (!records) return;
+    
+    // Records are stored oldest-first so loading can insert them in order;
+    // walk newest-first and fill from the back to keep the most recent.
+    // The walk runs under devicesMux so the BLE callback cannot relink the
+    // list under it; the NVS write happens after the lock is released.
+    portENTER_CRITICAL(&devicesMux);
+    size_t count = min(devices.size(), (size_t)MAX_PERSISTED_DEVICES);
+    const DeviceInfo* dev = devices.newest();
+    for (size_t i = count; i > 0 && dev; i--, dev = devices.older(dev)) {
+        StoredDevice& record = records[i - 1];
+        for (int b = 0; b < 6; b++) {
+            record.mac[b] = (dev->macKey >> (40 - 8 * b)) & 0xFF;
+        }
+        record.rssi = (int8_t)constrain(dev->rssi, -128, 127);
+        record.lastSeen = dev->lastSeen;
+        memcpy(record.filterDescription, dev->filterDescription, sizeof(record.filterDescription));
+    }
+    portEXIT_CRITICAL(&devicesMux);
     
-    // Limit to 100 most recent devices to avoid NVS overflow
-    int deviceCount = min((int)devices.size(), 100);
-    preferences.putInt("deviceCount", deviceCount);
+    preferences.begin("ouispy", false);
+    writeRecordBlob("devices", DEVICE_RECORD_VERSION, records, sizeof(StoredDevice), count);
+    preferences.end();
+    free(records);
+}
+
+// Pre-blob format: dev_mac_N / dev_rssi_N / dev_time_N / dev_filt_N keys
+static const char* const LEGACY_DEVICE_KEYS[] = { "dev_mac_", "dev_rssi_", "dev_time_", "dev_filt_" };
+
+void loadLegacyDevices() {
+    int deviceCount = preferences.getInt("deviceCount", 0);
     
-    for (int i = 0; i < deviceCount; i++) {
+    // Stored newest-first; insert oldest-first to rebuild recency order
+    for (int i = deviceCount - 1; i >= 0; i--) {
         String keyMac = "dev_mac_" + String(i);
         String keyRssi = "dev_rssi_" + String(i);
         String keyTime = "dev_time_" + String(i);
         String keyFilt = "dev_filt_" + String(i);
         
-        preferences.putString(keyMac.c_str(), devices[i].macAddress);
-        preferences.putInt(keyRssi.c_str(), devices[i].rssi);
-        preferences.putULong(keyTime.c_str(), devices[i].lastSeen);
-        preferences.putString(keyFilt.c_str(), devices[i].filterDescription);
+        uint64_t macKey;
+        String macAddress = preferences.getString(keyMac.c_str(), "");
+        if (parseMACKey(macAddress.c_str(), macKey) != 6 || devices.find(macKey)) {
+            continue;
+        }
+        
+        DeviceInfo* device = devices.insert(macKey);
+        if (!device) break;
+        device->rssi = preferences.getInt(keyRssi.c_str(), 0);
+        device->lastSeen = preferences.getULong(keyTime.c_str(), 0);
+        device->firstSeen = device->lastSeen;
+        String filterDescription = preferences.getString(keyFilt.c_str(), "");
+        strncpy(device->filterDescription, filterDescription.c_str(), sizeof(device->filterDescription) - 1);
     }
-    
-    preferences.end();
 }
 
 void loadDetectedDevices() {
     preferences.begin("ouispy", true);
-    int deviceCount = preferences.getInt("deviceCount", 0);
     
     devices.clear();
     
-    for (int i = 0; i < deviceCount; i++) {
-        String keyMac = "dev_mac_" + String(i);
-        String keyRssi = "dev_rssi_" + String(i);
-        String keyTime = "dev_time_" + String(i);
-        String keyFilt = "dev_filt_" + String(i);
-        
-        DeviceInfo device;
-        device.macAddress = preferences.getString(keyMac.c_str(), "");
-        device.rssi = preferences.getInt(keyRssi.c_str(), 0);
-        device.lastSeen = preferences.getULong(keyTime.c_str(), 0);
-        device.filterDescription = preferences.getString(keyFilt.c_str(), "");
-        device.firstSeen = device.lastSeen;
-        device.inCooldown = false;
-        device.cooldownUntil = 0;
-        device.matchedFilter = nullptr;
-        
-        if (device.macAddress.length() > 0) {
-            devices.push_back(device);
-        }
+    int loaded = readRecordBlob("devices", DEVICE_RECORD_VERSION, sizeof(StoredDevice),
+        [](const uint8_t* data) {
+            StoredDevice record;
+            memcpy(&record, data, sizeof(record));
+            
+            uint64_t macKey = 0;
+            for (int b = 0; b < 6; b++) {
+                macKey = (macKey << 8) | record.mac[b];
+            }
+            if (devices.find(macKey)) return;
+            
+            DeviceInfo* device = devices.insert(macKey);
+            if (!device) return;
+            device->rssi = record.rssi;
+            device->lastSeen = record.lastSeen;
+            device->firstSeen = record.lastSeen;
+            memcpy(device->filterDescription, record.filterDescription, sizeof(device->filterDescription) - 1);
+        });
+    bool legacy = loaded < 0 && preferences.isKey("deviceCount");
+    if (legacy) {
+        loadLegacyDevices();
     }
     
     preferences.end();
     
+    if (legacy) {
+        saveDetectedDevices();
+        preferences.begin("ouispy", false);
+        removeLegacyKeys("deviceCount", LEGACY_DEVICE_KEYS, 4);
+        preferences.end();
+    }
+    devicesDirty = false;
+    
     if (isSerialConnected()) {
-        Serial.println("Detected devices loaded from NVS (" + String(deviceCount) + " devices)");
+        Serial.println("Detected devices loaded from NVS (" + String(devices.size()) + " devices)");
     }
 }
 
@@ -642,8 +934,9 @@ void clearDetectedDevices() {
     devices.clear();
     
     preferences.begin("ouispy", false);
-    preferences.putInt("deviceCount", 0);
+    writeRecordBlob("devices", DEVICE_RECORD_VERSION, nullptr, sizeof(StoredDevice), 0);
     preferences.end();
+    devicesDirty = false;
     
     if (isSerialConnected()) {
         Serial.println("All detected devices cleared from memory and NVS");
@@ -828,659 +1121,9 @@ const char* getASCIIArt() {
 )";
 }
 
-const char* getConfigHTML() {
-    return R"html(
-<!DOCTYPE html>
-<html>
-<head>
-    <title>OUI-SPY Detector</title>
-    <meta name="viewport" content="width=device-width, initial-scale=1">
-    <style>
-        * { box-sizing: border-box; }
-        body { 
-            font-family: 'Segoe UI', Tahoma, Geneva, Verdana, sans-serif; 
-            margin: 0; 
-            padding: 20px;
-            background: #0f0f23; 
-            color: #ffffff;
-            position: relative;
-            overflow-x: hidden;
-        }
-        .ascii-background {
-            position: fixed;
-            top: 0;
-            left: 0;
-            width: 100%;
-            height: 100%;
-            z-index: -1;
-            opacity: 0.6;
-            color: #ff1493;
-            font-family: 'Courier New', monospace;
-            font-size: 8px;
-            line-height: 8px;
-            white-space: pre;
-            pointer-events: none;
-            overflow: hidden;
-        }
-        .container { 
-            max-width: 700px; 
-            margin: 0 auto; 
-            background: rgba(255, 255, 255, 0.02); 
-            padding: 40px; 
-            border-radius: 16px; 
-            box-shadow: 0 8px 32px rgba(0, 0, 0, 0.2); 
-            backdrop-filter: blur(5px);
-            border: 1px solid rgba(255, 255, 255, 0.05);
-            position: relative;
-            z-index: 1;
-        }
-        h1 {
-            text-align: center;
-            margin-bottom: 20px;
-            margin-top: 0px;
-            font-size: 48px;
-            font-weight: 700;
-            color: #8a2be2;
-            background: -webkit-linear-gradient(45deg, #8a2be2, #4169e1);
-            background: -moz-linear-gradient(45deg, #8a2be2, #4169e1);
-            background: linear-gradient(45deg, #8a2be2, #4169e1);
-            -webkit-background-clip: text;
-            -moz-background-clip: text;
-            background-clip: text;
-            -webkit-text-fill-color: transparent;
-            -moz-text-fill-color: transparent;
-            letter-spacing: 3px;
-        }
-        @media (max-width: 768px) {
-            h1 {
-                font-size: clamp(32px, 8vw, 48px);
-                letter-spacing: 2px;
-                margin-bottom: 15px;
-                text-align: center;
-                display: block;
-                width: 100%;
-            }
-            .container {
-                padding: 20px;
-                margin: 10px;
-            }
-        }
-        .section { 
-            margin-bottom: 30px; 
-            padding: 25px; 
-            border: 1px solid rgba(255, 255, 255, 0.1); 
-            border-radius: 12px; 
-            background: rgba(255, 255, 255, 0.01); 
-            backdrop-filter: blur(3px);
-        }
-        .section h3 { 
-            margin-top: 0; 
-            color: #ffffff; 
-            font-size: 18px;
-            font-weight: 600;
-            margin-bottom: 15px;
-        }
-        textarea { 
-            width: 100%; 
-            min-height: 120px;
-            padding: 15px; 
-            border: 1px solid rgba(255, 255, 255, 0.2); 
-            border-radius: 8px; 
-            background: rgba(255, 255, 255, 0.02);
-            color: #ffffff;
-            font-family: 'Courier New', monospace;
-            font-size: 14px;
-            resize: vertical;
-        }
-        textarea:focus {
-            outline: none;
-            border-color: #4ecdc4;
-            box-shadow: 0 0 0 3px rgba(78, 205, 196, 0.2);
-        }
-        .help-text { 
-            font-size: 13px; 
-            color: #a0a0a0; 
-            margin-top: 8px; 
-            line-height: 1.4;
-        }
-        .toggle-container {
-            display: flex;
-            flex-direction: column;
-            gap: 15px;
-        }
-        .toggle-item {
-            display: flex;
-            align-items: center;
-            gap: 15px;
-            padding: 15px;
-            border: 1px solid rgba(255, 255, 255, 0.1);
-            border-radius: 8px;
-            background: rgba(255, 255, 255, 0.02);
-        }
-        .toggle-item input[type="checkbox"] {
-            width: 20px;
-            height: 20px;
-            accent-color: #4ecdc4;
-            cursor: pointer;
-        }
-        .toggle-label {
-            font-weight: 500;
-            color: #ffffff;
-            cursor: pointer;
-            user-select: none;
-        }
-        button { 
-            background: linear-gradient(135deg, #667eea 0%, #764ba2 100%); 
-            color: #ffffff; 
-            padding: 14px 28px; 
-            border: none; 
-            border-radius: 8px; 
-            cursor: pointer; 
-            font-size: 16px; 
-            font-weight: 500;
-            margin: 10px 5px; 
-            transition: all 0.3s;
-        }
-        button:hover { 
-            transform: translateY(-2px);
-            box-shadow: 0 8px 25px rgba(102, 126, 234, 0.4);
-        }
-        .button-container {
-            text-align: center;
-            margin-top: 40px;
-            padding-top: 30px;
-            border-top: 1px solid #404040;
-        }
-        .status { 
-            padding: 15px; 
-            border-radius: 8px; 
-            margin-bottom: 30px; 
-            margin-top: 10px;
-            border-left: 4px solid #ff1493;
-            background: rgba(255, 20, 147, 0.05);
-            color: #ffffff;
-            border: 1px solid rgba(255, 20, 147, 0.2);
-        }
-    </style>
-</head>
-<body>
-    <div class="ascii-background">%ASCII_ART%</div>
-    <div class="container">
-        <h1>OUI-SPY Detector</h1>
-        
-        <div class="status">
-            Enter MAC addresses and/or OUI prefixes below. You must provide at least one entry in either field.
-        </div>
-
-        <form id="configForm" method="POST" action="/save">
-            <div class="section">
-                <h3>OUI Prefixes</h3>
-                <textarea id="ouis" name="ouis" placeholder="Enter OUI prefixes, one per line:
-AA:BB:CC
-DD:EE:FF
-11:22:33">%OUI_VALUES%</textarea>
-                <div class="help-text">
-                    OUI prefixes (first 3 bytes) match all devices from a manufacturer.<br>
-                    Format: XX:XX:XX (8 characters with colons)
-                </div>
-            </div>
-            
-            <div class="section">
-                <h3>MAC Addresses</h3>
-                <textarea id="macs" name="macs" placeholder="Enter full MAC addresses, one per line:
-AA:BB:CC:12:34:56
-DD:EE:FF:ab:cd:ef
-11:22:33:44:55:66">%MAC_VALUES%</textarea>
-                <div class="help-text">
-                    Full MAC addresses match specific devices only.<br>
-                    Format: XX:XX:XX:XX:XX:XX (17 characters with colons)
-                </div>
-            </div>
-            
-            <div class="section">
-                <h3>Audio & Visual Settings</h3>
-                <div class="toggle-container">
-                    <div class="toggle-item">
-                        <input type="checkbox" id="buzzerEnabled" name="buzzerEnabled" %BUZZER_CHECKED%>
-                        <label class="toggle-label" for="buzzerEnabled">Enable Buzzer</label>
-                        <div class="help-text" style="margin-top: 0;">Audio feedback for target detection</div>
-                    </div>
-                    <div class="toggle-item">
-                        <input type="checkbox" id="ledEnabled" name="ledEnabled" %LED_CHECKED%>
-                        <label class="toggle-label" for="ledEnabled">Enable LED Blinking</label>
-                        <div class="help-text" style="margin-top: 0;">Orange LED blinks with same pattern as buzzer</div>
-                    </div>
-                </div>
-            </div>
-            
-            <div class="section">
-                <h3>WiFi Access Point Settings</h3>
-                <div class="help-text" style="margin-bottom: 15px;">
-                    Customize the WiFi network name and password for the configuration portal.<br>
-                    <strong>Changes take effect on next device boot.</strong>
-                </div>
-                <div style="margin-bottom: 15px;">
-                    <label for="ap_ssid" style="display: block; margin-bottom: 8px; font-weight: 500; color: #ffffff;">Network Name (SSID)</label>
-                    <input type="text" id="ap_ssid" name="ap_ssid" value="%AP_SSID%" maxlength="32" style="width: 100%; padding: 12px; border: 1px solid rgba(255, 255, 255, 0.2); border-radius: 8px; background: rgba(255, 255, 255, 0.02); color: #ffffff; font-size: 14px;">
-                    <div class="help-text" style="margin-top: 5px;">1-32 characters</div>
-                </div>
-                <div>
-                    <label for="ap_password" style="display: block; margin-bottom: 8px; font-weight: 500; color: #ffffff;">Password</label>
-                    <input type="text" id="ap_password" name="ap_password" value="%AP_PASSWORD%" minlength="8" maxlength="63" style="width: 100%; padding: 12px; border: 1px solid rgba(255, 255, 255, 0.2); border-radius: 8px; background: rgba(255, 255, 255, 0.02); color: #ffffff; font-size: 14px;">
-                    <div class="help-text" style="margin-top: 5px;">8-63 characters (leave empty for open network)</div>
-                </div>
-            </div>
-            
-            <!-- Detected Devices Section -->
-            <div class="section" id="detectedDevicesSection">
-                <h3>Device Alias Management</h3>
-                <div class="help-text" style="margin-bottom: 15px;">
-                    Assign identification labels to detected MAC addresses for serial output tracking.<br>
-                    <strong>Device history and aliases persist in non-volatile storage.</strong>
-                </div>
-                <div id="clearDeviceBtn" style="margin-bottom: 10px; text-align: right; display: none;">
-                    <button type="button" onclick="clearDeviceHistory()" style="background: #8b0000; padding: 8px 16px; font-size: 13px; margin: 0;">Clear Device History</button>
-                </div>
-                <div id="deviceList" class="device-list">
-                    <div style="text-align: center; padding: 30px; color: #888888;">
-                        <p style="font-size: 14px;">No device records in storage.</p>
-                        <p style="font-size: 12px; margin-top: 10px;">Detected devices during scanning operations will persist to this list.</p>
-                    </div>
-                </div>
-            </div>
-
-            <div class="button-container">
-                <button type="submit">Save Configuration & Start Scanning</button>
-                <button type="button" onclick="clearConfig()" style="background: #8b0000; margin-left: 20px;">Clear All Filters</button>
-                <button type="button" onclick="deviceReset()" style="background: #4a0000; margin-left: 20px; font-size: 12px;">Device Reset</button>
-            </div>
-            
-            <!-- Burn In Configuration Section -->
-            <div class="section" style="border: 2px solid #8b0000; background: linear-gradient(135deg, rgba(139, 0, 0, 0.03) 0%, rgba(139, 0, 0, 0.08) 100%); margin-top: 40px;">
-                <h3 style="color: #ff6b6b; margin-top: 0; font-size: 18px; letter-spacing: 1px; text-transform: uppercase; border-bottom: 2px solid rgba(255, 107, 107, 0.3); padding-bottom: 12px; margin-bottom: 20px; text-align: center;">
-                    Burn In Settings
-                </h3>
-                
-                <div style="background: linear-gradient(135deg, #1a0a0a 0%, #2d0a0a 100%); color: #ff9999; padding: 18px; border-radius: 8px; margin: 15px 0; border: 2px solid #8b0000; box-shadow: 0 4px 15px rgba(139, 0, 0, 0.3);">
-                    <p style="font-weight: 600; font-size: 13px; margin: 0 0 10px 0; color: #ff6b6b; text-transform: uppercase; letter-spacing: 0.5px;">
-                        Warning - Requires Flash Erase to Unlock
-                    </p>
-                    <p style="line-height: 1.5; margin: 0 0 12px 0; color: #ffcccc; font-size: 13px;">
-                        Permanently locks all current settings: <strong>OUI/MAC filters, device aliases, buzzer/LED preferences</strong>
-                    </p>
-                    <p style="line-height: 1.4; margin: 0 0 8px 0; color: #e0e0e0; font-weight: 500; font-size: 12px;">
-                        Effects after activation:
-                    </p>
-                    <ul style="text-align: left; line-height: 1.6; margin: 0 0 12px 0; padding-left: 20px; color: #e0e0e0; font-size: 12px;">
-                        <li>Disables WiFi AP and 20-second config window</li>
-                        <li>Boots directly to scanning mode (~2 seconds)</li>
-                        <li>Removes web interface access</li>
-                    </ul>
-                    <p style="line-height: 1.4; margin: 0; color: #ffcccc; font-size: 12px;">
-                        <strong>Unlock:</strong> USB connection, flash erase, then firmware reflash required
-                    </p>
-                </div>
-                
-                <div style="background: linear-gradient(135deg, #0a1a0a 0%, #0a2d0a 100%); color: #99ff99; padding: 18px; border-radius: 8px; margin: 15px 0; border: 1px solid #166534; box-shadow: 0 2px 10px rgba(22, 101, 52, 0.2);">
-                    <p style="font-weight: 600; margin: 0 0 8px 0; color: #4ade80; font-size: 13px; text-transform: uppercase; letter-spacing: 0.5px;">
-                        Use Cases:
-                    </p>
-                    <ul style="text-align: left; line-height: 1.6; margin: 0; padding-left: 20px; color: #ccffcc; font-size: 12px;">
-                        <li>Production deployments</li>
-                        <li>Fixed installations</li>
-                        <li>Security-sensitive environments</li>
-                        <li>Battery-powered optimization</li>
-                    </ul>
-                </div>
-                
-                <div style="text-align: center; margin-top: 25px; padding-top: 20px; border-top: 1px solid rgba(255, 107, 107, 0.2);">
-                    <button type="button" onclick="burnInConfig()" style="background: linear-gradient(135deg, #8b0000 0%, #6b0000 100%); color: #ffffff; font-size: 15px; padding: 15px 35px; font-weight: 600; border: 2px solid #ff0000; border-radius: 8px; cursor: pointer; text-transform: uppercase; letter-spacing: 1px; box-shadow: 0 4px 15px rgba(139, 0, 0, 0.4); transition: all 0.3s;">
-                        Lock Configuration Permanently
-                    </button>
-                    <p style="font-size: 11px; color: #888888; margin-top: 12px; font-style: italic;">
-                        Cannot be undone without flash erase + reflash
-                    </p>
-                </div>
-            </div>
-            
-            <style>
-                .device-list {
-                    display: flex;
-                    flex-direction: column;
-                    gap: 10px;
-                    max-height: 400px;
-                    overflow-y: auto;
-                }
-                .device-item {
-                    display: flex;
-                    flex-direction: column;
-                    gap: 10px;
-                    padding: 12px;
-                    border: 1px solid rgba(255, 255, 255, 0.1);
-                    border-radius: 8px;
-                    background: rgba(255, 255, 255, 0.02);
-                }
-                .device-info-row {
-                    display: flex;
-                    align-items: center;
-                    gap: 12px;
-                    flex-wrap: wrap;
-                }
-                .device-alias-row {
-                    display: flex;
-                    align-items: center;
-                    gap: 10px;
-                    width: 100%;
-                }
-                .device-mac {
-                    font-family: 'Courier New', monospace;
-                    font-weight: 500;
-                    color: #4ecdc4;
-                    font-size: 13px;
-                }
-                .device-rssi {
-                    color: #a0a0a0;
-                    font-size: 12px;
-                }
-                .device-time {
-                    color: #888888;
-                    font-size: 11px;
-                    font-style: italic;
-                }
-                .device-time.recent {
-                    color: #4ade80;
-                }
-                .alias-input {
-                    flex: 1;
-                    padding: 8px 12px;
-                    border: 1px solid rgba(255, 255, 255, 0.2);
-                    border-radius: 6px;
-                    background: rgba(255, 255, 255, 0.05);
-                    color: #ffffff;
-                    font-size: 14px;
-                    min-width: 0;
-                }
-                .alias-input:focus {
-                    outline: none;
-                    border-color: #4ecdc4;
-                    box-shadow: 0 0 0 2px rgba(78, 205, 196, 0.2);
-                }
-                .save-alias-btn {
-                    padding: 8px 16px;
-                    font-size: 13px;
-                    margin: 0;
-                    white-space: nowrap;
-                }
-                .device-filter {
-                    color: #a0a0a0;
-                    font-size: 11px;
-                    font-style: italic;
-                }
-            </style>
-            
-            <script>
-            // Load detected devices on page load
-            window.addEventListener('DOMContentLoaded', function() {
-                loadDetectedDevices();
-                
-                // Ensure form submits on first click (mobile fix)
-                const configForm = document.getElementById('configForm');
-                if (configForm) {
-                    const submitBtn = configForm.querySelector('button[type="submit"]');
-                    if (submitBtn) {
-                        submitBtn.addEventListener('touchstart', function(e) {
-                            // Blur any focused inputs to ensure submit works on first tap
-                            if (document.activeElement) {
-                                document.activeElement.blur();
-                            }
-                        }, { passive: true });
-                        
-                        submitBtn.addEventListener('click', function(e) {
-                            // Ensure any focused element is blurred before submit
-                            if (document.activeElement && document.activeElement !== submitBtn) {
-                                document.activeElement.blur();
-                            }
-                        });
-                    }
-                }
-            });
-            
-            function formatTimeSince(milliseconds) {
-                const seconds = Math.floor(milliseconds / 1000);
-                const minutes = Math.floor(seconds / 60);
-                const hours = Math.floor(minutes / 60);
-                const days = Math.floor(hours / 24);
-                
-                if (seconds < 60) return 'Just now';
-                if (minutes < 60) return minutes + ' min ago';
-                if (hours < 24) return hours + ' hour' + (hours > 1 ? 's' : '') + ' ago';
-                return days + ' day' + (days > 1 ? 's' : '') + ' ago';
-            }
-            
-            function loadDetectedDevices() {
-                fetch('/api/devices')
-                    .then(response => response.json())
-                    .then(data => {
-                        const deviceList = document.getElementById('deviceList');
-                        const clearBtn = document.getElementById('clearDeviceBtn');
-                        
-                        if (data.devices && data.devices.length > 0) {
-                            clearBtn.style.display = 'block';
-                            deviceList.innerHTML = '';
-                            
-                            data.devices.forEach(device => {
-                                const deviceItem = document.createElement('div');
-                                deviceItem.className = 'device-item';
-                                
-                                // First row: device info
-                                const infoRow = document.createElement('div');
-                                infoRow.className = 'device-info-row';
-                                
-                                const macSpan = document.createElement('span');
-                                macSpan.className = 'device-mac';
-                                macSpan.textContent = device.mac;
-                                
-                                const rssiSpan = document.createElement('span');
-                                rssiSpan.className = 'device-rssi';
-                                rssiSpan.textContent = device.rssi + ' dBm';
-                                
-                                const timeSpan = document.createElement('span');
-                                timeSpan.className = 'device-time';
-                                const timeSince = device.timeSince || 0;
-                                timeSpan.textContent = formatTimeSince(timeSince);
-                                if (timeSince < 60000) { // Less than 1 minute
-                                    timeSpan.classList.add('recent');
-                                }
-                                
-                                infoRow.appendChild(macSpan);
-                                infoRow.appendChild(rssiSpan);
-                                infoRow.appendChild(timeSpan);
-                                
-                                if (device.filter) {
-                                    const filterSpan = document.createElement('span');
-                                    filterSpan.className = 'device-filter';
-                                    filterSpan.textContent = device.filter;
-                                    filterSpan.title = device.filter;
-                                    infoRow.appendChild(filterSpan);
-                                }
-                                
-                                // Second row: alias input and button
-                                const aliasRow = document.createElement('div');
-                                aliasRow.className = 'device-alias-row';
-                                
-                                const aliasInput = document.createElement('input');
-                                aliasInput.type = 'text';
-                                aliasInput.className = 'alias-input';
-                                aliasInput.placeholder = 'Device identification label';
-                                aliasInput.value = device.alias || '';
-                                aliasInput.maxLength = 32;
-                                
-                                const saveBtn = document.createElement('button');
-                                saveBtn.type = 'button';
-                                saveBtn.className = 'save-alias-btn';
-                                saveBtn.textContent = 'Save';
-                                saveBtn.onclick = function() {
-                                    saveAlias(device.mac, aliasInput.value, saveBtn);
-                                };
-                                
-                                aliasRow.appendChild(aliasInput);
-                                aliasRow.appendChild(saveBtn);
-                                
-                                deviceItem.appendChild(infoRow);
-                                deviceItem.appendChild(aliasRow);
-                                
-                                deviceList.appendChild(deviceItem);
-                            });
-                        }
-                    })
-                    .catch(error => {
-                        console.error('Error loading devices:', error);
-                    });
-            }
-            
-            function saveAlias(mac, alias, button) {
-                const originalText = button.textContent;
-                const originalBg = button.style.background;
-                button.textContent = 'Saving...';
-                button.disabled = true;
-                button.style.opacity = '0.6';
-                
-                fetch('/api/alias', {
-                    method: 'POST',
-                    headers: {
-                        'Content-Type': 'application/x-www-form-urlencoded',
-                    },
-                    body: 'mac=' + encodeURIComponent(mac) + '&alias=' + encodeURIComponent(alias)
-                })
-                .then(response => response.json())
-                .then(data => {
-                    button.textContent = 'Saved!';
-                    button.style.background = 'linear-gradient(135deg, #10b981 0%, #059669 100%)';
-                    button.style.opacity = '1';
-                    setTimeout(() => {
-                        button.textContent = originalText;
-                        button.style.background = originalBg;
-                        button.disabled = false;
-                    }, 2000);
-                })
-                .catch(error => {
-                    console.error('Error saving alias:', error);
-                    button.textContent = 'Error';
-                    button.style.background = 'linear-gradient(135deg, #ef4444 0%, #dc2626 100%)';
-                    button.style.opacity = '1';
-                    setTimeout(() => {
-                        button.textContent = originalText;
-                        button.style.background = originalBg;
-                        button.disabled = false;
-                    }, 2000);
-                });
-            }
-            
-            function clearDeviceHistory() {
-                if (confirm('CLEAR DEVICE HISTORY\n\nThis will remove all detected device records from non-volatile storage.\n\nAliases and filter configurations will be preserved.\n\nProceed with clearing device history?')) {
-                    fetch('/api/clear-devices', { method: 'POST' })
-                        .then(response => response.json())
-                        .then(data => {
-                            alert('Device history cleared from storage.');
-                            location.reload();
-                        })
-                        .catch(error => {
-                            console.error('Error:', error);
-                            alert('Error clearing device history.');
-                        });
-                }
-            }
-            
-            function clearConfig() {
-                if (confirm('Are you sure you want to clear all filters? This action cannot be undone.')) {
-                    document.getElementById('ouis').value = '';
-                    document.getElementById('macs').value = '';
-                    fetch('/clear', { method: 'POST' })
-                        .then(response => response.text())
-                        .then(data => {
-                            alert('All filters cleared!');
-                            location.reload();
-                        })
-                        .catch(error => {
-                            console.error('Error:', error);
-                            alert('Error clearing filters. Check console.');
-                        });
-                }
-            }
-            
-            function deviceReset() {
-                if (confirm('DEVICE RESET: This will completely wipe all saved data and restart the device. Are you absolutely sure?')) {
-                    if (confirm('This action cannot be undone. The device will restart and behave like first boot. Continue?')) {
-                        fetch('/device-reset', { method: 'POST' })
-                            .then(response => response.text())
-                            .then(data => {
-                                alert('Device reset initiated! Device restarting...');
-                                setTimeout(function() {
-                                    window.location.href = '/';
-                                }, 5000);
-                            })
-                            .catch(error => {
-                                console.error('Error:', error);
-                                alert('Error during device reset. Check console.');
-                            });
-                    }
-                }
-            }
-            
-            function burnInConfig() {
-                if (!confirm('PERMANENT CONFIGURATION LOCK\n\nThis will PERMANENTLY lock all settings (OUI/MAC filters, aliases, buzzer/LED preferences).\n\nAfter activation:\n- WiFi AP and config window disabled on boot\n- Device boots directly to scanning mode\n- Unlock requires: flash erase + firmware reflash via USB\n\nClick OK to proceed with permanent lock.')) {
-                    return;
-                }
-                
-                // Collect current form values
-                const formData = new URLSearchParams();
-                const ouisElement = document.getElementById('ouis');
-                const macsElement = document.getElementById('macs');
-                const ouis = ouisElement ? ouisElement.value.trim() : '';
-                const macs = macsElement ? macsElement.value.trim() : '';
-                const buzzerEnabled = document.getElementById('buzzerEnabled') ? document.getElementById('buzzerEnabled').checked : true;
-                const ledEnabled = document.getElementById('ledEnabled') ? document.getElementById('ledEnabled').checked : true;
-                const apSSID = document.getElementById('ap_ssid') ? document.getElementById('ap_ssid').value : '';
-                const apPassword = document.getElementById('ap_password') ? document.getElementById('ap_password').value : '';
-                
-                // Debug logging
-                console.log('Burn-in: OUI values:', ouis);
-                console.log('Burn-in: MAC values:', macs);
-                
-                formData.append('ouis', ouis);
-                formData.append('macs', macs);
-                if (buzzerEnabled) formData.append('buzzerEnabled', 'on');
-                if (ledEnabled) formData.append('ledEnabled', 'on');
-                formData.append('ap_ssid', apSSID);
-                formData.append('ap_password', apPassword);
-                
-                // User confirmed, proceed with burn-in - send current form values
-                fetch('/api/lock-config', { 
-                    method: 'POST',
-                    headers: {
-                        'Content-Type': 'application/x-www-form-urlencoded',
-                    },
-                    body: formData.toString()
-                })
-                    .then(response => response.text())
-                    .then(data => {
-                        // Response is HTML that shows the success page
-                        document.open();
-                        document.write(data);
-                        document.close();
-                    })
-                    .catch(error => {
-                        console.error('Error:', error);
-                        alert('Error locking configuration. Check console.');
-                    });
-            }
-            </script>
-        </form>
-    </div>
-</body>
-</html>
-)html";
-}
+// Config page: web/detector.html, minified + gzipped at build time by
+// scripts/build_web.py. Current values are fetched from /api/settings.
+#include "web/detector_html.h"
 
 String generateRandomOUI() {
     String oui = "";
@@ -1506,47 +1149,6 @@ String generateRandomMAC() {
     return mac;
 }
 
-String generateConfigHTML() {
-    String html = getConfigHTML();
-    String ouiValues = "";
-    String macValues = "";
-    
-    // Populate existing saved values (if any)
-    for (const TargetFilter& filter : targetFilters) {
-        if (filter.isFullMAC) {
-            if (macValues.length() > 0) macValues += "\n";
-            macValues += filter.identifier;
-        } else {
-            if (ouiValues.length() > 0) ouiValues += "\n";
-            ouiValues += filter.identifier;
-        }
-    }
-    
-    // Generate random examples for placeholders
-    String randomOUIExamples = generateRandomOUI() + "\n" + generateRandomOUI() + "\n" + generateRandomOUI();
-    String randomMACExamples = generateRandomMAC() + "\n" + generateRandomMAC() + "\n" + generateRandomMAC();
-    
-    // Replace static placeholders with random examples
-    html.replace("AA:BB:CC\nDD:EE:FF\n11:22:33", randomOUIExamples);
-    html.replace("AA:BB:CC:12:34:56\nDD:EE:FF:ab:cd:ef\n11:22:33:44:55:66", randomMACExamples);
-    
-    // Remove ASCII art - causes memory exhaustion on ESP32
-    html.replace("%ASCII_ART%", "");
-    
-    html.replace("%OUI_VALUES%", ouiValues);
-    html.replace("%MAC_VALUES%", macValues);
-    
-    // Replace toggle states
-    html.replace("%BUZZER_CHECKED%", buzzerEnabled ? "checked" : "");
-    html.replace("%LED_CHECKED%", ledEnabled ? "checked" : "");
-    
-    // Replace WiFi credentials
-    html.replace("%AP_SSID%", AP_SSID);
-    html.replace("%AP_PASSWORD%", AP_PASSWORD);
-    
-    return html;
-}
-
 // ================================
 // WiFi and Web Server Functions
 // ================================
@@ -1592,7 +1194,43 @@ void startConfigMode() {
     // Setup web server routes
     server.on("/", HTTP_GET, [](AsyncWebServerRequest *request) {
         lastConfigActivity = millis();
-        request->send(200, "text/html", generateConfigHTML());
+        AsyncWebServerResponse *response = request->beginResponse_P(200, "text/html", DETECTOR_HTML_GZ, DETECTOR_HTML_GZ_LEN);
+        response->addHeader("Content-Encoding", "gzip");
+        request->send(response);
+    });
+    
+    // Current configuration for the config page (filters one per line)
+    server.on("/api/settings", HTTP_GET, [](AsyncWebServerRequest *request) {
+        lastConfigActivity = millis();
+        
+        AsyncResponseStream *response = request->beginResponseStream("application/json");
+        String ouiValues = "";
+        String macValues = "";
+        for (const TargetFilter& filter : targetFilters) {
+            String& values = filter.isFullMAC ? macValues : ouiValues;
+            if (values.length() > 0) values += "\n";
+            values += filter.identifier;
+        }
+        
+        response->print("{\"ouis\":");
+        printJSONString(*response, ouiValues.c_str());
+        response->print(",\"macs\":");
+        printJSONString(*response, macValues.c_str());
+        response->printf(",\"buzzer\":%s,\"led\":%s,\"scanProfile\":%u,\"ssid\":",
+                         buzzerEnabled ? "true" : "false", ledEnabled ? "true" : "false", scanProfile);
+        printJSONString(*response, AP_SSID.c_str());
+        response->print(",\"password\":");
+        printJSONString(*response, AP_PASSWORD.c_str());
+        
+        // Random examples for the textarea placeholders
+        String exampleOUIs = generateRandomOUI() + "\n" + generateRandomOUI() + "\n" + generateRandomOUI();
+        String exampleMACs = generateRandomMAC() + "\n" + generateRandomMAC() + "\n" + generateRandomMAC();
+        response->print(",\"exampleOUIs\":");
+        printJSONString(*response, exampleOUIs.c_str());
+        response->print(",\"exampleMACs\":");
+        printJSONString(*response, exampleMACs.c_str());
+        response->print("}");
+        request->send(response);
     });
     
     server.on("/save", HTTP_POST, [](AsyncWebServerRequest *request) {
@@ -1674,9 +1312,15 @@ void startConfigMode() {
             }
         }
         
+        compileTargetFilters();
+        
         // Process buzzer and LED toggles
         buzzerEnabled = request->hasParam("buzzerEnabled", true);
         ledEnabled = request->hasParam("ledEnabled", true);
+        if (request->hasParam("scanProfile", true)) {
+            int profile = request->getParam("scanProfile", true)->value().toInt();
+            if (profile >= 0 && profile < (int)SCAN_PROFILE_COUNT) scanProfile = profile;
+        }
         
         // Process WiFi credentials
         if (request->hasParam("ap_ssid", true)) {
@@ -1797,6 +1441,7 @@ void startConfigMode() {
         
         // Clear all filters
         targetFilters.clear();
+        compileTargetFilters();
         saveConfiguration();
         
         if (isSerialConnected()) {
@@ -1826,41 +1471,74 @@ void startConfigMode() {
     });
     
     // API endpoint to get detected devices
+    // Optional query: since=<lastSeen> returns only devices seen after that
+    // time, limit=<n> caps the page size. Devices are streamed oldest-change
+    // first; "next" is the cursor for the following request and "more" tells
+    // the client whether another page is waiting.
     server.on("/api/devices", HTTP_GET, [](AsyncWebServerRequest *request) {
         lastConfigActivity = millis();
         
-        String json = "{\"devices\":[";
-        
         unsigned long currentTime = millis();
+        bool hasSince = request->hasParam("since");
+        unsigned long since = hasSince ? strtoul(request->getParam("since")->value().c_str(), nullptr, 10) : 0;
+        size_t limit = devices.size();
+        if (request->hasParam("limit")) {
+            long requested = request->getParam("limit")->value().toInt();
+            if (requested > 0) limit = min((size_t)requested, limit);
+        }
         
+        // Order matching table slots by lastSeen so the cursor is monotonic
+        std::vector<uint16_t> order;
+        order.reserve(devices.size());
         for (size_t i = 0; i < devices.size(); i++) {
-            if (i > 0) json += ",";
+            if (!hasSince || devices[i].lastSeen > since) order.push_back(i);
+        }
+        std::sort(order.begin(), order.end(), [](uint16_t a, uint16_t b) {
+            return devices[a].lastSeen < devices[b].lastSeen;
+        });
+        
+        // Never split devices that share a timestamp across two pages
+        size_t count = min(limit, order.size());
+        while (count > 0 && count < order.size() &&
+               devices[order[count]].lastSeen == devices[order[count - 1]].lastSeen) {
+            count++;
+        }
+        unsigned long next = count > 0 ? devices[order[count - 1]].lastSeen : since;
+        
+        AsyncResponseStream *response = request->beginResponseStream("application/json");
+        response->print("{\"devices\":[");
+        
+        for (size_t n = 0; n < count; n++) {
+            const DeviceInfo& dev = devices[order[n]];
+            if (n > 0) response->print(",");
             
-            String alias = getDeviceAlias(devices[i].macAddress);
-            String filterDesc = devices[i].filterDescription;
-            if (filterDesc.length() == 0 && devices[i].matchedFilter) {
-                filterDesc = String(devices[i].matchedFilter);
+            char macText[18];
+            formatMACKey(dev.macKey, macText, sizeof(macText));
+            
+            const char* filterDesc = dev.filterDescription;
+            if (filterDesc[0] == '\0' && dev.matchedFilter) {
+                filterDesc = dev.matchedFilter;
             }
             
             // Calculate time since last seen
-            unsigned long timeSince = (currentTime >= devices[i].lastSeen) ? 
-                                     (currentTime - devices[i].lastSeen) : 0;
+            unsigned long timeSince = (currentTime >= dev.lastSeen) ? 
+                                     (currentTime - dev.lastSeen) : 0;
             
-            json += "{";
-            json += "\"mac\":\"" + devices[i].macAddress + "\",";
-            json += "\"rssi\":" + String(devices[i].rssi) + ",";
-            json += "\"filter\":\"" + filterDesc + "\",";
-            json += "\"alias\":\"" + alias + "\",";
-            json += "\"lastSeen\":" + String(devices[i].lastSeen) + ",";
-            json += "\"timeSince\":" + String(timeSince);
-            json += "}";
+            response->printf("{\"mac\":\"%s\",\"rssi\":%d,\"filter\":", macText, dev.rssi);
+            printJSONString(*response, filterDesc);
+            response->print(",\"alias\":");
+            printJSONString(*response, getDeviceAlias(dev.macKey));
+            response->printf(",\"lastSeen\":%lu,\"timeSince\":%lu", dev.lastSeen, timeSince);
+            if (dev.adv.n) {
+                response->print(",\"adv\":");
+                advIntervalPrintJSON(*response, dev.adv);
+            }
+            response->print("}");
         }
         
-        json += "],";
-        json += "\"currentTime\":" + String(currentTime);
-        json += "}";
-        
-        request->send(200, "application/json", json);
+        response->printf("],\"currentTime\":%lu,\"next\":%lu,\"more\":%s}",
+                         currentTime, next, count < order.size() ? "true" : "false");
+        request->send(response);
     });
     
     // API endpoint to save device alias
@@ -1871,7 +1549,10 @@ void startConfigMode() {
             String mac = request->getParam("mac", true)->value();
             String alias = request->getParam("alias", true)->value();
             
-            setDeviceAlias(mac, alias);
+            if (!setDeviceAlias(mac, alias)) {
+                request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid MAC address\"}");
+                return;
+            }
             saveDeviceAliases();
             
             if (isSerialConnected()) {
@@ -1995,9 +1676,15 @@ void startConfigMode() {
             }
         }
         
+        compileTargetFilters();
+        
         // Process buzzer and LED toggles
         buzzerEnabled = request->hasParam("buzzerEnabled", true);
         ledEnabled = request->hasParam("ledEnabled", true);
+        if (request->hasParam("scanProfile", true)) {
+            int profile = request->getParam("scanProfile", true)->value().toInt();
+            if (profile >= 0 && profile < (int)SCAN_PROFILE_COUNT) scanProfile = profile;
+        }
         
         // Process WiFi credentials
         if (request->hasParam("ap_ssid", true)) {
@@ -2166,91 +1853,140 @@ void startConfigMode() {
     }
 }
 
+// ================================
+// BLE Scan Scheduler
+// ================================
+// Scanning runs as one continuous, callback-only scan (no start/stop cycle,
+// no stored results) so there are no blind spots between scan windows. The
+// controller's duplicate filter is off; repeats are instead dropped per
+// device in onResult once they fall inside BLE_DEDUP_WINDOW_MS.
+#define BLE_DEDUP_WINDOW_MS 250         // Per-device repeat suppression
+#define BLE_SCAN_WATCHDOG_MS 1000       // How often loop() checks the scan is alive
+
+// Counters (written by the NimBLE host task, read by loop)
+volatile uint32_t scanAdvertsReceived = 0;  // Every advertisement delivered
+volatile uint32_t scanAdvertsMatched = 0;   // Matched a filter
+volatile uint32_t scanAdvertsDeduped = 0;   // Matched but inside the dedup window
+uint32_t scanRestarts = 0;                  // Scan found stopped and restarted
+unsigned long scanActiveMs = 0;             // Completed scanning time
+unsigned long scanStartedAt = 0;            // Start of the current scan (0 = stopped)
+
+void startContinuousScan() {
+    if (pBLEScan == nullptr) return;
+    
+    // Duration 0 = scan until stopped
+    if (pBLEScan->start(0, nullptr, false)) {
+        scanStartedAt = millis();
+    }
+}
+
+// Keep the scan running and account scanning time
+void serviceScanScheduler(unsigned long now) {
+    static unsigned long lastCheck = 0;
+    if (pBLEScan == nullptr || now - lastCheck < BLE_SCAN_WATCHDOG_MS) return;
+    lastCheck = now;
+    
+    if (!pBLEScan->isScanning()) {
+        if (scanStartedAt != 0) {
+            scanActiveMs += now - scanStartedAt;
+            scanStartedAt = 0;
+        }
+        scanRestarts++;
+        startContinuousScan();
+    }
+}
+
+unsigned long totalScanMs(unsigned long now) {
+    return scanActiveMs + (scanStartedAt != 0 ? now - scanStartedAt : 0);
+}
+
 // ================================
 // BLE Advertised Device Callback Class
 // ================================
 class MyAdvertisedDeviceCallbacks: public NimBLEAdvertisedDeviceCallbacks {
     void onResult(NimBLEAdvertisedDevice* advertisedDevice) {
         if (currentMode != SCANNING_MODE) return;
+        scanAdvertsReceived++;
+        
+        // Work on the native address; text is only produced for new devices
+        // and by loop() when it prints a match
+        const uint64_t mac = macKeyFromNative(advertisedDevice->getAddress().getNative());
+        
+        const TargetFilter* filter = findTargetFilter(mac);
+        if (!filter) return;
+        scanAdvertsMatched++;
         
-        String mac = advertisedDevice->getAddress().toString().c_str();
         int rssi = advertisedDevice->getRSSI();
         unsigned long currentMillis = millis();
-
-        String matchedDescription;
-        bool matchFound = matchesTargetFilter(mac, matchedDescription);
         
-        if (matchFound) {
-            bool known = false;
-            for (auto& dev : devices) {
-                if (dev.macAddress == mac) {
-                    known = true;
-
-                    if (dev.inCooldown && currentMillis < dev.cooldownUntil) {
-                        return;
-                    }
-
-                    if (dev.inCooldown && currentMillis >= dev.cooldownUntil) {
-                        dev.inCooldown = false;
-                    }
-
-                    unsigned long timeSinceLastSeen = currentMillis - dev.lastSeen;
-
-                    if (timeSinceLastSeen >= 30000) {
-                        // Store data for main loop to process
-                        detectedMAC = mac;
-                        detectedRSSI = rssi;
-                        matchedFilter = matchedDescription;
-                        matchType = "RE-30s";
-                        newMatchFound = true;
-                        
-                        threeBeeps();
-                        dev.inCooldown = true;
-                        dev.cooldownUntil = currentMillis + 10000;
-                    } else if (timeSinceLastSeen >= 3000) {
-                        // Store data for main loop to process
-                        detectedMAC = mac;
-                        detectedRSSI = rssi;
-                        matchedFilter = matchedDescription;
-                        matchType = "RE-3s";
-                        newMatchFound = true;
-                        
-                        twoBeeps();
-                        dev.inCooldown = true;
-                        dev.cooldownUntil = currentMillis + 3000;
-                    }
+        // Table work happens under devicesMux; the outcome is reported
+        // (ring push, beeps) after the lock is released
+        int beeps = 0;
+        DetectionType event = DETECTION_NEW;
+        
+        portENTER_CRITICAL(&devicesMux);
+        DeviceInfo* known = devices.find(mac);
+        if (known) {
+            DeviceInfo& dev = *known;
+            devices.touch(known);
+            advIntervalAdd(dev.adv, currentMillis, scanStartedAt);
+            
+            unsigned long timeSinceLastSeen = currentMillis - dev.lastSeen;
+            
+            if (dev.inCooldown && currentMillis >= dev.cooldownUntil) {
+                dev.inCooldown = false;
+            }
 
-                    dev.lastSeen = currentMillis;
-                    break;
+            if (timeSinceLastSeen < BLE_DEDUP_WINDOW_MS) {
+                // Repeats inside the dedup window only refresh the signal level
+                dev.rssi = rssi;
+                scanAdvertsDeduped++;
+            } else if (!dev.inCooldown) {
+                if (timeSinceLastSeen >= 30000) {
+                    event = DETECTION_RE_30S;
+                    beeps = 3;
+                    dev.inCooldown = true;
+                    dev.cooldownUntil = currentMillis + 10000;
+                } else if (timeSinceLastSeen >= 3000) {
+                    event = DETECTION_RE_3S;
+                    beeps = 2;
+                    dev.inCooldown = true;
+                    dev.cooldownUntil = currentMillis + 3000;
                 }
-            }
 
-            if (!known) {
-                DeviceInfo newDev;
-                newDev.macAddress = mac;
-                newDev.rssi = rssi;
-                newDev.firstSeen = currentMillis;
-                newDev.lastSeen = currentMillis;
-                newDev.inCooldown = false;
-                newDev.cooldownUntil = 0;
-                newDev.matchedFilter = matchedDescription.c_str();
-                newDev.filterDescription = matchedDescription;
-                devices.push_back(newDev);
-
-                // Store data for main loop to process
-                detectedMAC = mac;
-                detectedRSSI = rssi;
-                matchedFilter = matchedDescription;
-                matchType = "NEW";
-                newMatchFound = true;
-                
-                threeBeeps();
-                
-                auto& dev = devices.back();
-                dev.inCooldown = true;
-                dev.cooldownUntil = currentMillis + 3000;
+                // Plain lastSeen refreshes ride along with the next dirty save
+                // rather than forcing an NVS write on every advertisement
+                if (timeSinceLastSeen >= 3000) devicesDirty = true;
+                dev.lastSeen = currentMillis;
+            }
+        } else {
+            // Fixed-capacity insert: reuses the least-recently-seen slot when full
+            DeviceInfo* newDev = devices.insert(mac);
+            if (newDev) {
+                newDev->rssi = rssi;
+                newDev->firstSeen = currentMillis;
+                newDev->lastSeen = currentMillis;
+                advIntervalAdd(newDev->adv, currentMillis, scanStartedAt);
+                newDev->matchedFilter = filter->description.c_str();
+                strncpy(newDev->filterDescription, filter->description.c_str(), sizeof(newDev->filterDescription) - 1);
+                newDev->inCooldown = true;
+                newDev->cooldownUntil = currentMillis + 3000;
+                devicesDirty = true;
+                event = DETECTION_NEW;
+                beeps = 3;
             }
         }
+        portEXIT_CRITICAL(&devicesMux);
+        
+        if (beeps == 0) return;
+        
+        // Queue for the main loop to report
+        detectionRing.push({mac, (int8_t)rssi, event});
+        if (beeps == 3) {
+            threeBeeps();
+        } else {
+            twoBeeps();
+        }
     }
 };
 
@@ -2279,10 +2015,12 @@ void startScanningMode() {
     // Setup BLE scanning (but don't start)
     pBLEScan = NimBLEDevice::getScan();
     if (pBLEScan != nullptr) {
-        pBLEScan->setAdvertisedDeviceCallbacks(new MyAdvertisedDeviceCallbacks());
+        // Report every advertisement; duplicates are handled per device
+        pBLEScan->setAdvertisedDeviceCallbacks(new MyAdvertisedDeviceCallbacks(), true);
+        pBLEScan->setMaxResults(0);  // Callback only - keep no result list
         pBLEScan->setActiveScan(true);
-        pBLEScan->setInterval(300);
-        pBLEScan->setWindow(200);
+        pBLEScan->setInterval(SCAN_PROFILES[scanProfile].intervalMs);
+        pBLEScan->setWindow(SCAN_PROFILES[scanProfile].windowMs);
     }
     
     // Ready to scan - ascending beeps (no interference possible)
@@ -2294,10 +2032,10 @@ void startScanningMode() {
     
     // NOW start BLE scanning - after ready signal is complete
     if (pBLEScan != nullptr) {
-        pBLEScan->start(3, nullptr, false);
+        startContinuousScan();
         
         if (isSerialConnected()) {
-            Serial.println("BLE scanning started!");
+            Serial.println("BLE scanning started! Profile: " + String(SCAN_PROFILES[scanProfile].name));
         }
     }
 }
@@ -2380,6 +2118,12 @@ void setup() {
     setNeoPixelColor(128, 0, 255); // Purple
     delay(1000);
     
+    // Allocate the device table once (PSRAM), falling back to a small internal pool
+    if (!allocateDevices(MAX_TRACKED_DEVICES, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT)) {
+        allocateDevices(FALLBACK_TRACKED_DEVICES, MALLOC_CAP_8BIT);
+    }
+    Serial.println("Device table capacity: " + String(devices.capacity()));
+    
     // Check for factory reset flag first
     preferences.begin("ouispy", true); // read-only
     bool factoryReset = preferences.getBool("factoryReset", false);
@@ -2395,6 +2139,7 @@ void setup() {
         
         // Clear in-memory data
         targetFilters.clear();
+        compileTargetFilters();
         deviceAliases.clear();
         devices.clear();
         
@@ -2432,7 +2177,6 @@ void setup() {
 // Loop Function
 // ================================
 void loop() {
-    static unsigned long lastScanTime = 0;
     static unsigned long lastCleanupTime = 0;
     static unsigned long lastStatusTime = 0;
     unsigned long currentMillis = millis();
@@ -2509,38 +2253,55 @@ void loop() {
     // Scanning mode loop
     if (currentMode == SCANNING_MODE) {
         // Handle match detection messages (JSON output for API)
-        if (newMatchFound) {
+        static uint32_t reportedOverflows = 0;
+        DetectionEvent events[DETECTION_DRAIN_BATCH];
+        size_t eventCount = detectionRing.popBatch(events, DETECTION_DRAIN_BATCH);
+        bool serialConnected = eventCount > 0 && isSerialConnected();
+        for (size_t i = 0; i < eventCount && serialConnected; i++) {
+            char macText[18];
+            formatMACKey(events[i].macKey, macText, sizeof(macText));
+            const char* alias = getDeviceAlias(events[i].macKey);
+            
+            // Output clean JSON
+            Serial.print("{\"mac\":\"");
+            Serial.print(macText);
+            Serial.print("\",\"alias\":\"");
+            Serial.print(alias);
+            Serial.print("\",\"rssi\":");
+            Serial.print((int)events[i].rssi);
+            Serial.println("}");
+        }
+        
+        // Report dropped events once per change rather than per event
+        uint32_t overflows = detectionRing.overflows();
+        if (overflows != reportedOverflows) {
             if (isSerialConnected()) {
-                String alias = getDeviceAlias(detectedMAC);
-                
-                // Output clean JSON
-                Serial.print("{\"mac\":\"");
-                Serial.print(detectedMAC);
-                Serial.print("\",\"alias\":\"");
-                Serial.print(alias);
-                Serial.print("\",\"rssi\":");
-                Serial.print(detectedRSSI);
+                Serial.print("{\"dropped\":");
+                Serial.print(overflows);
                 Serial.println("}");
             }
-            newMatchFound = false;
+            reportedOverflows = overflows;
         }
         
-        // Restart BLE scan every 3 seconds
-        if (currentMillis - lastScanTime >= 3000) {
-            pBLEScan->stop();
-            delay(10);
-            pBLEScan->start(2, nullptr, false);
-            lastScanTime = currentMillis;
-        }
+        // Continuous scan - only restarted if the stack stopped it
+        serviceScanScheduler(currentMillis);
 
-        // Auto-save detected devices to NVS every 10 seconds
+        // Auto-save detected devices to NVS at most every 10 seconds, only when changed
         if (currentMillis - lastCleanupTime >= 10000) {
-            saveDetectedDevices();
+            if (devicesDirty) {
+                devicesDirty = false;  // Cleared first so a concurrent change is not lost
+                saveDetectedDevices();
+            }
             lastCleanupTime = currentMillis;
         }
 
-        // Status report disabled - using JSON output only
+        // Scan counters, JSON like the match output
         if (currentMillis - lastStatusTime >= 30000) {
+            if (isSerialConnected()) {
+                Serial.printf("{\"scan\":{\"profile\":\"%s\",\"adverts\":%u,\"matched\":%u,\"deduped\":%u,\"scanMs\":%lu,\"restarts\":%u}}\n",
+                              SCAN_PROFILES[scanProfile].name, scanAdvertsReceived, scanAdvertsMatched,
+                              scanAdvertsDeduped, totalScanMs(currentMillis), scanRestarts);
+            }
             lastStatusTime = currentMillis;
         }
     }
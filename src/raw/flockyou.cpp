@@ -7,6 +7,9 @@
 //   3. BLE manufacturer company ID matching (0x09C8 XUNTONG) [from wgreenberg]
 //   4. Raven gunshot detector service UUID matching
 //   5. Raven firmware version estimation from service UUID patterns
+//   6. Advertising interval: a steady timer adds confidence (fixed hardware)
+// Each method is a weighted signal; detections carry the signals that fired
+// and a confidence score (see DETECTION SCORING).
 //
 // WiFi AP "flockyou" / "flockyou123" serves web dashboard at 192.168.4.1
 // All detections stored in memory, exportable as JSON or CSV
@@ -25,8 +28,21 @@
 #include <ctype.h>
 #include <stdio.h>
 #include <stdint.h>
+#include <vector>
+#include <algorithm>
+#include <memory>
 #include "esp_wifi.h"
 #include <TinyGPS++.h>
+#include <esp_heap_caps.h>
+#include "alert_sequencer.h"
+#include "adv_interval.h"
+#include "name_matcher.h"
+#include "fy_raven.h"
+#include "fy_scoring.h"
+#include "fy_record.h"
+#include "fy_json_split.h"
+#include "fy_track.h"
+#include "fy_gps.h"
 
 // ============================================================================
 // CONFIGURATION
@@ -57,9 +73,20 @@
 // BLE scanning
 #define BLE_SCAN_DURATION 2      // seconds per scan
 #define BLE_SCAN_INTERVAL 3000   // ms between scans
-
-// Detection storage
-#define MAX_DETECTIONS 200
+#define FY_REPEAT_MS 2500        // Repeats within one scan only feed interval stats
+
+// Detection storage (see DETECTION STORAGE below)
+#ifndef FY_DET_CAPACITY
+#define FY_DET_CAPACITY 10000          // Pool entries with PSRAM (5000-20000), less if SPIFFS can't persist them
+#endif
+#define FY_DET_FALLBACK_CAPACITY 200   // Internal RAM only (no PSRAM)
+#define FY_EVICT_NONE 0                // Full pool: drop new devices
+#define FY_EVICT_LRU  1                // Full pool: reuse least-recently-seen slot
+#ifndef FY_EVICT_POLICY
+#define FY_EVICT_POLICY FY_EVICT_LRU
+#endif
+static_assert(FY_DET_CAPACITY >= 5000 && FY_DET_CAPACITY <= 20000,
+              "FY_DET_CAPACITY must be 5000-20000");
 
 // WiFi AP credentials
 #define FY_AP_SSID "flockyou"
@@ -68,6 +95,8 @@
 // ============================================================================
 // DETECTION PATTERNS
 // ============================================================================
+// Compiled-in defaults. A signature file uploaded to /api/patterns/upload
+// replaces all four tables at runtime (see SIGNATURE DATABASE).
 
 // Known Flock Safety MAC address prefixes (OUIs)
 static const char* mac_prefixes[] = {
@@ -93,39 +122,28 @@ static const uint16_t ble_manufacturer_ids[] = {
     0x09C8   // XUNTONG
 };
 
-// ============================================================================
-// RAVEN SURVEILLANCE DEVICE UUID PATTERNS
-// ============================================================================
-
-#define RAVEN_DEVICE_INFO_SERVICE   "0000180a-0000-1000-8000-00805f9b34fb"
-#define RAVEN_GPS_SERVICE           "00003100-0000-1000-8000-00805f9b34fb"
-#define RAVEN_POWER_SERVICE         "00003200-0000-1000-8000-00805f9b34fb"
-#define RAVEN_NETWORK_SERVICE       "00003300-0000-1000-8000-00805f9b34fb"
-#define RAVEN_UPLOAD_SERVICE        "00003400-0000-1000-8000-00805f9b34fb"
-#define RAVEN_ERROR_SERVICE         "00003500-0000-1000-8000-00805f9b34fb"
-#define RAVEN_OLD_HEALTH_SERVICE    "00001809-0000-1000-8000-00805f9b34fb"
-#define RAVEN_OLD_LOCATION_SERVICE  "00001819-0000-1000-8000-00805f9b34fb"
-
-static const char* raven_service_uuids[] = {
-    RAVEN_DEVICE_INFO_SERVICE,
-    RAVEN_GPS_SERVICE,
-    RAVEN_POWER_SERVICE,
-    RAVEN_NETWORK_SERVICE,
-    RAVEN_UPLOAD_SERVICE,
-    RAVEN_ERROR_SERVICE,
-    RAVEN_OLD_HEALTH_SERVICE,
-    RAVEN_OLD_LOCATION_SERVICE
-};
-
 // ============================================================================
 // DETECTION STORAGE
 // ============================================================================
+// Detections live in a pool allocated once at boot (PSRAM when present) and
+// are found by binary MAC through an open-addressing hash index, so a
+// sighting costs O(1) under fyMutex. Slots 0..fyDetCount-1 are always in
+// use, so exports still walk the pool in slot order. A recency list over the
+// slots drives FY_EVICT_LRU; every detection that is evicted or cannot be
+// stored is counted and reported by /api/stats. Changed detections are
+// queued on a dirty list for the next session checkpoint and stamped with a
+// change sequence; since every change also moves the slot to the head of
+// the recency list, /api/detections?since= walks only what changed.
+
+#define FY_SLOT_NONE 0xFFFF
 
 struct FYDetection {
+    uint64_t macKey;      // 48-bit MAC, index key
     char mac[18];
     char name[48];
     int rssi;
-    char method[24];
+    char method[24];      // Strongest signal (fySignalMethod)
+    uint8_t signals;      // FY_SIG_BIT()s seen so far
     unsigned long firstSeen;
     unsigned long lastSeen;
     int count;
@@ -136,10 +154,39 @@ struct FYDetection {
     double gpsLon;
     float gpsAcc;
     bool hasGPS;
+    // Where the device probably is: RSSI-weighted centroid of every fix it
+    // was heard at (fyUpdateEstimate)
+    double estLat;
+    double estLon;
+    float estW;           // Sum of weights
+    float estM2;          // Weighted squared distance from the centroid, m^2
+    float estAccW;        // Weighted sum of fix accuracy, m
+    float estR;           // Uncertainty radius, m
+    uint16_t estN;        // Fixes folded in, 0 = no estimate
+    AdvInterval adv;      // Gaps between advertisements, every one heard
+    bool dirty;           // On fyDirty, not yet checkpointed
+    uint32_t seq;         // fyDetSeq of the last change
 };
 
-static FYDetection fyDet[MAX_DETECTIONS];
+static FYDetection* fyDet = NULL;
+static int fyDetCapacity = 0;
 static int fyDetCount = 0;
+static AdvInterval* fyAdvLive = NULL;    // Per slot, BLE host task only (see BLE SCANNING)
+static uint16_t* fyDetIndex = NULL;      // Hash bucket -> slot
+static uint32_t fyDetIndexMask = 0;
+static uint16_t* fyLruPrev = NULL;       // Toward more recently seen
+static uint16_t* fyLruNext = NULL;       // Toward less recently seen
+static uint16_t fyLruHead = FY_SLOT_NONE; // Most recently seen
+static uint16_t fyLruTail = FY_SLOT_NONE; // Least recently seen
+static uint32_t fyDetEvicted = 0;        // Old detections replaced by new ones
+static uint32_t fyDetDropped = 0;        // New detections that could not be stored
+static uint16_t* fyDirty = NULL;         // Slots changed since the last checkpoint
+static int fyDirtyCount = 0;
+static uint32_t fyDetSeq = 0;            // Last change sequence handed out
+static uint32_t fyDetRemovedSeq = 0;     // Sequence of the last eviction or clear
+static uint32_t fyDetBootId = 0;         // Tells delta clients the sequence restarted
+static int fyDetRaven = 0;               // Stored detections with isRaven
+static int fyDetWithGPS = 0;             // Stored detections with hasGPS
 static SemaphoreHandle_t fyMutex = NULL;
 
 // ============================================================================
@@ -156,83 +203,96 @@ static unsigned long fyLastDetTime = 0;
 static unsigned long fyLastHB = 0;
 static NimBLEScan* fyBLEScan = NULL;
 static AsyncWebServer fyServer(80);
+static AsyncEventSource fyEvents("/api/events");  // Live push, see LIVE EVENTS
 
-// Phone GPS state (updated via browser Geolocation API -> /api/gps)
-static double fyGPSLat = 0;
-static double fyGPSLon = 0;
-static float  fyGPSAcc = 0;
-static bool   fyGPSValid = false;
-static unsigned long fyGPSLastUpdate = 0;
+// Current position fix from hardware GPS or the phone (browser Geolocation
+// API -> /api/gps), see GPS HELPERS
+static FYFixLock fyFixLock;
+static portMUX_TYPE fyFixWriteMux = portMUX_INITIALIZER_UNLOCKED;
 #define GPS_STALE_MS 30000  // GPS considered stale after 30s without update
 
-// Hardware GPS state (Seeed L76K GNSS module on UART1)
+// Hardware GPS state (Seeed L76K GNSS module on UART1), owned by fyGPSTask
 static TinyGPSPlus fyGPS;
 static HardwareSerial fyGPSSerial(1);
-static bool fyHWGPSDetected = false;     // Any NMEA received = module present
-static bool fyHWGPSFix = false;          // Valid position fix
-static int  fyHWGPSSats = 0;             // Satellite count
+static TaskHandle_t fyGPSTaskHandle = NULL;
+static volatile bool fyHWGPSDetected = false;  // Any NMEA received = module present
+static volatile bool fyHWGPSFix = false;       // Valid position fix
+static volatile int  fyHWGPSSats = 0;          // Satellite count
 static unsigned long fyHWGPSLastChar = 0;
-static bool fyGPSIsHardware = false;     // Current GPS source is hardware
 #define GPS_HW_TIMEOUT_MS 5000
-
-// Session persistence (SPIFFS)
-#define FY_SESSION_FILE  "/session.json"
-#define FY_PREV_FILE     "/prev_session.json"
-#define FY_SAVE_INTERVAL 15000  // Auto-save every 15 seconds (prevent data loss on quick power-cycle)
+#define GPS_RX_BUFFER     1024  // UART driver ring buffer (~1 s of NMEA)
+#define GPS_TASK_STACK    4096
+#define GPS_TASK_PRIORITY 2
+
+// Session persistence (SPIFFS, see SESSION PERSISTENCE below)
+#define FY_SESSION_FILE  "/session.rec"
+#define FY_SESSION_TMP   "/session.tmp"     // Compaction output
+#define FY_LEGACY_SESSION_FILE "/session.json"       // Older firmware (JSON)
+#define FY_LEGACY_PREV_FILE    "/prev_session.json"  // Older firmware (JSON)
+#define FY_SAVE_INTERVAL 15000  // Checkpoint every 15 seconds (prevent data loss on quick power-cycle)
+#define FY_SPIFFS_RESERVE (64UL * 1024)    // Signature DB and small files
 static unsigned long fyLastSave = 0;
-static int fyLastSaveCount = 0;  // Track changes to avoid unnecessary writes
+static FYLogState fyLog = {0, 0, true, 0, 0};  // FY_SESSION_FILE: size, budget, retry state
+static uint32_t fyLogBudget = 0;       // Log budget from the partition size, set in setup()
+static bool fyLogFullNoted = false;    // "log full" printed since the last write
 static bool fySpiffsReady = false;
 
+// Session history (SPIFFS, see SESSION HISTORY below)
+#define FY_HIST_INDEX    "/hist.idx"
+#define FY_HIST_INDEX_TMP "/hist.tmp"
+#define FY_HIST_DATA     "/hist.dat"
+#define FY_HIST_DATA_TMP "/hist.dtmp"        // Ring being cut down to a smaller size
+#define FY_HIST_SESSIONS 16                 // Sessions kept in the index
+static uint32_t fyHistBytes = 0;            // Ring size of FY_HIST_DATA, set in setup()
+
+// Wall clock, learned from hardware GPS or the dashboard's browser
+static uint32_t fyEpochAtBoot = 0;     // Unix time at boot, 0 = unknown
+
 // ============================================================================
 // AUDIO SYSTEM
 // ============================================================================
 
-static void fyBeep(int freq, int dur) {
-    if (!fyBuzzerOn) return;
-    tone(BUZZER_PIN, freq, dur);
-    delay(dur + 50);
-}
+// Sounds are queued on the shared alert sequencer and play in its task, so
+// alerts can fire from the BLE callback without stalling the scan.
+
+// Crow caw: harsh sweep from startFreq to endFreq with warble texture
+#define FY_CAW(startFreq, endFreq, durationMs, warbleHz) \
+    {startFreq, endFreq, durationMs, warbleHz, 0}
+#define FY_REST(durationMs) {0, 0, durationMs, 0, 0}
+
+static const AlertStep FY_BOOT_SOUND[] = {
+    FY_CAW(850, 380, 180, 40),   // Caw 1: sharp descending caw
+    FY_REST(100),
+    FY_CAW(780, 350, 150, 50),   // Caw 2: slightly lower, shorter
+    FY_REST(100),
+    FY_CAW(820, 280, 220, 60),   // Caw 3: longer trailing caw with more rasp
+    FY_REST(80),
+    {600, 0, 25, 0, 0},          // Quick staccato ending "kk-kk"
+    FY_REST(15),
+    {550, 0, 25, 0, 0},
+    FY_REST(15)
+};
 
-// Crow caw: harsh descending sweep with warble texture
-static void fyCaw(int startFreq, int endFreq, int durationMs, int warbleHz) {
-    if (!fyBuzzerOn) return;
-    int steps = durationMs / 8;  // 8ms per step
-    float fStep = (float)(endFreq - startFreq) / steps;
-    for (int i = 0; i < steps; i++) {
-        int f = startFreq + (int)(fStep * i);
-        // Add warble: oscillate frequency +/- for raspy texture
-        if (warbleHz > 0 && (i % 3 == 0)) {
-            f += ((i % 6 < 3) ? warbleHz : -warbleHz);
-        }
-        if (f < 100) f = 100;
-        tone(BUZZER_PIN, f, 10);
-        delay(8);
-    }
-    noTone(BUZZER_PIN);
-}
+// Alarm crow: two sharp ascending chirps then a caw
+static const AlertStep FY_DETECT_SOUND[] = {
+    FY_CAW(400, 900, 100, 30),   // rising alarm chirp
+    FY_REST(60),
+    FY_CAW(450, 950, 100, 30),   // second chirp, higher
+    FY_REST(60),
+    FY_CAW(900, 350, 200, 50)    // descending caw
+};
+
+// Soft double coo - like a distant crow
+static const AlertStep FY_HEARTBEAT_SOUND[] = {
+    FY_CAW(500, 400, 80, 20),
+    FY_REST(120),
+    FY_CAW(480, 380, 80, 20)
+};
 
 static void fyBootBeep() {
     printf("[FLOCK-YOU] Boot sound (buzzer %s)\n", fyBuzzerOn ? "ON" : "OFF");
     if (!fyBuzzerOn) return;
-
-    // === CROW CALL SEQUENCE ===
-    // Caw 1: sharp descending caw
-    fyCaw(850, 380, 180, 40);
-    delay(100);
-
-    // Caw 2: slightly lower, shorter
-    fyCaw(780, 350, 150, 50);
-    delay(100);
-
-    // Caw 3: longer trailing caw with more rasp
-    fyCaw(820, 280, 220, 60);
-    delay(80);
-
-    // Quick staccato ending "kk-kk"
-    tone(BUZZER_PIN, 600, 25); delay(40);
-    tone(BUZZER_PIN, 550, 25); delay(40);
-    noTone(BUZZER_PIN);
-
+    alertPlay(FY_BOOT_SOUND, true, false);
     printf("[FLOCK-YOU] *caw caw caw*\n");
 }
 
@@ -241,20 +301,12 @@ static void fyDetectBeep() {
     fyPixelAlertMode = true;
     fyPixelAlertStart = millis();
     if (!fyBuzzerOn) return;
-    // Alarm crow: two sharp ascending chirps then a caw
-    fyCaw(400, 900, 100, 30);   // rising alarm chirp
-    delay(60);
-    fyCaw(450, 950, 100, 30);   // second chirp, higher
-    delay(60);
-    fyCaw(900, 350, 200, 50);   // descending caw
+    alertPlay(FY_DETECT_SOUND, true, false);
 }
 
 static void fyHeartbeat() {
     if (!fyBuzzerOn) return;
-    // Soft double coo - like a distant crow
-    fyCaw(500, 400, 80, 20);
-    delay(120);
-    fyCaw(480, 380, 80, 20);
+    alertPlay(FY_HEARTBEAT_SOUND, true, false);
 }
 
 // ============================================================================
@@ -331,84 +383,266 @@ static void fyUpdatePixel() {
 }
 
 // ============================================================================
-// DETECTION HELPERS
+// NAME MATCHER
 // ============================================================================
+// device_name_patterns is compiled once into a case-folded Aho-Corasick
+// automaton (name_matcher.h) so a name is scanned in a single pass
+// regardless of how many patterns there are.
+
+static NameMatcher fyNames;
+
+// ============================================================================
+// DETECTION SCORING
+// ============================================================================
+// Weighted signals and the rule table they are evaluated by live in
+// fy_scoring.h; fySigApply() recompiles fyRules with the signatures.
+
+static std::vector<FYRule> fyRules;
 
-static bool checkMACPrefix(const uint8_t* mac) {
-    char mac_str[9];
-    snprintf(mac_str, sizeof(mac_str), "%02x:%02x:%02x", mac[0], mac[1], mac[2]);
+// ============================================================================
+// SIGNATURE DATABASE
+// ============================================================================
+// Active signatures, either built from the compiled-in tables or loaded from
+// FY_SIGDB_FILE. The file is produced by scripts/build_sigdb.py and is laid
+// out so every section can be copied straight into these tables:
+//
+//   header     FYSigHeader (32 bytes, little-endian)
+//   ouis       uint32_t[ouiCount]      0x00AABBCC for AA:BB:CC, ascending
+//   services   FYSigService[svcCount]  native 128-bit UUID, ascending memcmp
+//   mfr        uint16_t[mfrCount]      company IDs, ascending
+//   names      nameBytes of NUL-terminated patterns (nameCount of them)
+//
+// crc is CRC-32 (IEEE, as zlib) over everything after the header. fySigMutex
+// guards the tables and the name matcher while a new file is swapped in.
+
+#define FY_SIGDB_FILE      "/sigdb.bin"
+#define FY_SIGDB_TMP_FILE  "/sigdb.tmp"
+#define FY_SIGDB_OLD_FILE  "/sigdb.old"   // Previous file while an upload is swapped in
+#define FY_SIGDB_MAGIC     0x47535946UL   // "FYSG"
+#define FY_SIGDB_FORMAT    1
+#define FY_SIGDB_MAX_BYTES 65536
+
+struct FYSigHeader {
+    uint32_t magic;
+    uint16_t format;
+    uint16_t headerSize;
+    uint32_t version;      // Publisher's database version, 0 = compiled-in
+    uint32_t crc;
+    uint16_t ouiCount;
+    uint16_t svcCount;
+    uint16_t mfrCount;
+    uint16_t nameCount;
+    uint32_t nameBytes;
+    uint32_t reserved;
+};
+static_assert(sizeof(FYSigHeader) == 32, "FYSigHeader is part of the file format");
+
+struct FYSigDB {
+    uint32_t version;
+    bool fromFile;
+    std::vector<uint32_t> ouis;
+    std::vector<FYSigService> services;
+    std::vector<uint16_t> mfrIds;
+    std::vector<char> nameBlob;        // Backing store for names loaded from file
+    std::vector<const char*> names;
+};
+
+static FYSigDB fySig;
+static SemaphoreHandle_t fySigMutex = NULL;
+static File fySigUpload;                     // /api/patterns/upload in progress
+static const char* fySigUploadError = NULL;
+
+static void fySigLoadBuiltin(FYSigDB& db) {
+    db.version = 0;
+    db.fromFile = false;
+
+    db.ouis.clear();
     for (size_t i = 0; i < sizeof(mac_prefixes)/sizeof(mac_prefixes[0]); i++) {
-        if (strncasecmp(mac_str, mac_prefixes[i], 8) == 0) return true;
+        unsigned a, b, c;
+        if (sscanf(mac_prefixes[i], "%x:%x:%x", &a, &b, &c) == 3) {
+            db.ouis.push_back(((uint32_t)a << 16) | ((uint32_t)b << 8) | c);
+        }
     }
-    return false;
+    std::sort(db.ouis.begin(), db.ouis.end());
+    db.ouis.erase(std::unique(db.ouis.begin(), db.ouis.end()), db.ouis.end());
+
+    fyRavenServices(db.services);
+
+    db.mfrIds.assign(ble_manufacturer_ids,
+        ble_manufacturer_ids + sizeof(ble_manufacturer_ids)/sizeof(ble_manufacturer_ids[0]));
+    std::sort(db.mfrIds.begin(), db.mfrIds.end());
+
+    db.nameBlob.clear();
+    db.names.assign(device_name_patterns,
+        device_name_patterns + sizeof(device_name_patterns)/sizeof(device_name_patterns[0]));
 }
 
-static bool checkDeviceName(const char* name) {
-    if (!name || !name[0]) return false;
-    for (size_t i = 0; i < sizeof(device_name_patterns)/sizeof(device_name_patterns[0]); i++) {
-        if (strcasestr(name, device_name_patterns[i])) return true;
+// Validate and load a signature file. Returns NULL on success, otherwise a
+// short reason; db is only meaningful on success.
+static const char* fySigLoadFile(const char* path, FYSigDB& db) {
+    File f = SPIFFS.open(path, "r");
+    if (!f) return "cannot open file";
+    size_t size = f.size();
+    if (size < sizeof(FYSigHeader) || size > FY_SIGDB_MAX_BYTES) { f.close(); return "bad file size"; }
+
+    std::vector<uint8_t> buf(size);
+    size_t got = f.read(buf.data(), size);
+    f.close();
+    if (got != size) return "short read";
+
+    FYSigHeader h;
+    memcpy(&h, buf.data(), sizeof(h));
+    if (h.magic != FY_SIGDB_MAGIC) return "not a signature file";
+    if (h.format != FY_SIGDB_FORMAT) return "unsupported format";
+    if (h.headerSize != sizeof(FYSigHeader)) return "bad header size";
+
+    size_t expect = sizeof(FYSigHeader) + (size_t)h.ouiCount * sizeof(uint32_t) +
+                    (size_t)h.svcCount * sizeof(FYSigService) +
+                    (size_t)h.mfrCount * sizeof(uint16_t) + h.nameBytes;
+    if (expect != size) return "section sizes do not match file";
+    if (fyCrc32(0, buf.data() + sizeof(h), size - sizeof(h)) != h.crc) return "CRC mismatch";
+
+    const uint8_t* p = buf.data() + sizeof(h);
+
+    db.ouis.resize(h.ouiCount);
+    memcpy(db.ouis.data(), p, h.ouiCount * sizeof(uint32_t));
+    p += h.ouiCount * sizeof(uint32_t);
+    for (size_t i = 0; i < db.ouis.size(); i++) {
+        if (db.ouis[i] > 0xFFFFFF || (i > 0 && db.ouis[i] <= db.ouis[i - 1])) return "OUIs not sorted";
     }
-    return false;
-}
 
-static bool checkManufacturerID(uint16_t id) {
-    for (size_t i = 0; i < sizeof(ble_manufacturer_ids)/sizeof(ble_manufacturer_ids[0]); i++) {
-        if (ble_manufacturer_ids[i] == id) return true;
+    db.services.resize(h.svcCount);
+    memcpy(db.services.data(), p, h.svcCount * sizeof(FYSigService));
+    p += h.svcCount * sizeof(FYSigService);
+    for (size_t i = 0; i < db.services.size(); i++) {
+        if (db.services[i].bit >= 32) return "service bit out of range";
+        if (i > 0 && !fySigServiceLess(db.services[i - 1], db.services[i])) return "services not sorted";
     }
-    return false;
-}
 
-// ============================================================================
-// RAVEN UUID DETECTION
-// ============================================================================
+    db.mfrIds.resize(h.mfrCount);
+    memcpy(db.mfrIds.data(), p, h.mfrCount * sizeof(uint16_t));
+    p += h.mfrCount * sizeof(uint16_t);
+    for (size_t i = 1; i < db.mfrIds.size(); i++) {
+        if (db.mfrIds[i] <= db.mfrIds[i - 1]) return "manufacturer IDs not sorted";
+    }
 
-static bool checkRavenUUID(NimBLEAdvertisedDevice* device, char* out_uuid = nullptr) {
-    if (!device || !device->haveServiceUUID()) return false;
-    int count = device->getServiceUUIDCount();
-    if (count == 0) return false;
-    for (int i = 0; i < count; i++) {
-        NimBLEUUID svc = device->getServiceUUID(i);
-        std::string str = svc.toString();
-        for (size_t j = 0; j < sizeof(raven_service_uuids)/sizeof(raven_service_uuids[0]); j++) {
-            if (strcasecmp(str.c_str(), raven_service_uuids[j]) == 0) {
-                if (out_uuid) strncpy(out_uuid, str.c_str(), 40);
-                return true;
-            }
+    if (h.nameBytes > 0 && p[h.nameBytes - 1] != '\0') return "unterminated name";
+    db.nameBlob.assign(p, p + h.nameBytes);
+    db.names.clear();
+    for (size_t off = 0; off < db.nameBlob.size(); ) {
+        const char* n = &db.nameBlob[off];
+        size_t len = strlen(n);
+        if (len == 0) return "empty name";
+        for (size_t i = 0; i < len; i++) {
+            // Served back unescaped by /api/patterns
+            if ((uint8_t)n[i] < 0x20 || n[i] == '"' || n[i] == '\\') return "bad character in name";
         }
+        db.names.push_back(n);
+        off += len + 1;
     }
-    return false;
+    if (db.names.size() != h.nameCount) return "name count mismatch";
+
+    db.version = h.version;
+    db.fromFile = true;
+    return NULL;
 }
 
-static const char* estimateRavenFW(NimBLEAdvertisedDevice* device) {
-    if (!device || !device->haveServiceUUID()) return "?";
-    bool has_new_gps = false, has_old_loc = false, has_power = false;
-    int count = device->getServiceUUIDCount();
-    for (int i = 0; i < count; i++) {
-        std::string u = device->getServiceUUID(i).toString();
-        if (strcasecmp(u.c_str(), RAVEN_GPS_SERVICE) == 0)          has_new_gps = true;
-        if (strcasecmp(u.c_str(), RAVEN_OLD_LOCATION_SERVICE) == 0) has_old_loc = true;
-        if (strcasecmp(u.c_str(), RAVEN_POWER_SERVICE) == 0)        has_power = true;
+// Swap db in as the active set (db receives the old one) and recompile
+// the name matcher and scoring rules
+static bool fySigApply(FYSigDB& db) {
+    if (!fySigMutex || xSemaphoreTake(fySigMutex, pdMS_TO_TICKS(1000)) != pdTRUE) return false;
+    std::swap(fySig, db);
+    size_t acNodes = fyNames.build(fySig.names.data(), fySig.names.size());
+    uint32_t svcBits = 0;
+    for (size_t i = 0; i < fySig.services.size(); i++) svcBits |= FY_SVC_BIT(fySig.services[i].bit);
+    fyCompileRules(fyRules, !fySig.ouis.empty(), !fySig.names.empty(), !fySig.mfrIds.empty(), svcBits);
+    xSemaphoreGive(fySigMutex);
+    printf("[FLOCK-YOU] Signatures v%u (%s): %u OUIs, %u names (%u states), %u mfr IDs, %u UUIDs\n",
+           (unsigned)fySig.version, fySig.fromFile ? "file" : "built-in",
+           (unsigned)fySig.ouis.size(), (unsigned)fySig.names.size(), (unsigned)acNodes,
+           (unsigned)fySig.mfrIds.size(), (unsigned)fySig.services.size());
+    return true;
+}
+
+// Boot: file if present and valid, otherwise the compiled-in tables
+static void fySigInit() {
+    fySigMutex = xSemaphoreCreateMutex();
+    FYSigDB db;
+    const char* err = "no file";
+    // A reset in the middle of an upload's swap leaves only the previous file
+    if (fySpiffsReady && !SPIFFS.exists(FY_SIGDB_FILE) && SPIFFS.exists(FY_SIGDB_OLD_FILE)) {
+        SPIFFS.rename(FY_SIGDB_OLD_FILE, FY_SIGDB_FILE);
+    }
+    if (fySpiffsReady && SPIFFS.exists(FY_SIGDB_FILE)) {
+        err = fySigLoadFile(FY_SIGDB_FILE, db);
+        if (err) printf("[FLOCK-YOU] %s rejected: %s\n", FY_SIGDB_FILE, err);
     }
-    if (has_old_loc && !has_new_gps) return "1.1.x";
-    if (has_new_gps && !has_power)   return "1.2.x";
-    if (has_new_gps && has_power)    return "1.3.x";
-    return "?";
+    if (err) fySigLoadBuiltin(db);
+    fySigApply(db);
 }
 
 // ============================================================================
 // GPS HELPERS
 // ============================================================================
 
-static bool fyGPSIsFresh() {
-    return fyGPSValid && (millis() - fyGPSLastUpdate < GPS_STALE_MS);
+// Fixes go through a seqlock: readers (BLE callback, loop, web handlers)
+// never block. The two writers (fyGPSTask and /api/gps) are serialized by
+// a spinlock held only for the copy.
+static void fyPublishFix(const FYFix& f) {
+    portENTER_CRITICAL(&fyFixWriteMux);
+    fyFixLock.write(f);
+    portEXIT_CRITICAL(&fyFixWriteMux);
+}
+
+// Latest fix, however old. Returns false if there has never been one.
+static bool fyReadFix(FYFix& out) {
+    return fyFixLock.read(out);
+}
+
+static bool fyFreshFix(FYFix& out) {
+    return fyReadFix(out) && millis() - out.ms < GPS_STALE_MS;
+}
+
+// Fold the current fix into d's location estimate in O(1). Fixes are
+// weighted by received amplitude (x10 per 20 dB) over fix accuracy, so the
+// centroid leans toward where the device was loudest. The radius combines
+// the weighted spread of the fixes, their mean accuracy and FY_EST_RANGE_M
+// of BLE range shrinking with the number of fixes.
+#define FY_EST_RANGE_M   30.0f
+#define FY_EST_MIN_ACC_M 5.0f
+
+static void fyUpdateEstimate(FYDetection& d) {
+    float w = powf(10.0f, (d.rssi + 100) / 20.0f) / fmaxf(d.gpsAcc, FY_EST_MIN_ACC_M);
+    if (d.estN == 0) {
+        d.estLat = d.gpsLat;
+        d.estLon = d.gpsLon;
+        d.estW = w;
+        d.estM2 = 0;
+        d.estAccW = w * d.gpsAcc;
+    } else {
+        // Weighted Welford update, distances in metres
+        float my = 111320.0f, mx = my * cosf(d.gpsLat * M_PI / 180.0);
+        float dy0 = (d.gpsLat - d.estLat) * my, dx0 = (d.gpsLon - d.estLon) * mx;
+        d.estW += w;
+        d.estLat += (d.gpsLat - d.estLat) * (w / d.estW);
+        d.estLon += (d.gpsLon - d.estLon) * (w / d.estW);
+        float dy1 = (d.gpsLat - d.estLat) * my, dx1 = (d.gpsLon - d.estLon) * mx;
+        d.estM2 += w * (dy0 * dy1 + dx0 * dx1);
+        d.estAccW += w * d.gpsAcc;
+    }
+    if (d.estN < 0xFFFF) d.estN++;
+    float acc = d.estAccW / d.estW;
+    d.estR = sqrtf(d.estM2 / d.estW + acc * acc + FY_EST_RANGE_M * FY_EST_RANGE_M / d.estN);
 }
 
 static void fyAttachGPS(FYDetection& d) {
-    if (fyGPSIsFresh()) {
+    FYFix f;
+    if (fyFreshFix(f)) {
         d.hasGPS = true;
-        d.gpsLat = fyGPSLat;
-        d.gpsLon = fyGPSLon;
-        d.gpsAcc = fyGPSAcc;
+        d.gpsLat = f.lat;
+        d.gpsLon = f.lon;
+        d.gpsAcc = f.acc;
+        fyUpdateEstimate(d);
     }
 }
 
@@ -416,82 +650,322 @@ static void fyAttachGPS(FYDetection& d) {
 // HARDWARE GPS PROCESSING
 // ============================================================================
 
-static void fyProcessHardwareGPS() {
-    // Read all available UART bytes into TinyGPSPlus parser
-    while (fyGPSSerial.available()) {
-        char c = fyGPSSerial.read();
-        fyGPS.encode(c);
-        fyHWGPSLastChar = millis();
-        if (!fyHWGPSDetected) {
-            fyHWGPSDetected = true;
-            printf("[FLOCK-YOU] Hardware GPS module detected (NMEA data received)\n");
-        }
-    }
+// First wall-clock source wins; the running session's start goes into the
+// index from loop()
+static void fySetClock(uint32_t epochNow) {
+    if (fyEpochAtBoot || epochNow < 1600000000UL) return;  // Unset GPS dates read as 2000
+    fyEpochAtBoot = epochNow - millis() / 1000;
+    printf("[FLOCK-YOU] Clock set: boot at %u\n", (unsigned)fyEpochAtBoot);
+}
 
-    // Timeout: no NMEA data for 5s → module disconnected or absent
-    if (fyHWGPSDetected && (millis() - fyHWGPSLastChar > GPS_HW_TIMEOUT_MS)) {
-        if (fyGPSIsHardware) {
-            printf("[FLOCK-YOU] Hardware GPS timeout — falling back to phone GPS\n");
-        }
-        fyHWGPSDetected = false;
-        fyHWGPSFix = false;
-        fyHWGPSSats = 0;
-        fyGPSIsHardware = false;
-    }
+static uint32_t fyEpochFromCivil(int y, int m, int d, int hh, int mm, int ss) {
+    // Days from 1970-01-01 (proleptic Gregorian, y >= 1970)
+    y -= m <= 2;
+    uint32_t era = y / 400;
+    uint32_t yoe = y - era * 400;
+    uint32_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    uint32_t days = era * 146097 + doe - 719468;
+    return days * 86400UL + hh * 3600UL + mm * 60UL + ss;
+}
+
+// ISO 8601 UTC ("2026-10-16T12:34:56Z"), the inverse of fyEpochFromCivil
+static void fyFormatUTC(uint32_t epoch, char* out, size_t n) {
+    uint32_t z = epoch / 86400 + 719468;
+    uint32_t era = z / 146097;
+    uint32_t doe = z - era * 146097;
+    uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    uint32_t mp = (5 * doy + 2) / 153;
+    uint32_t d = doy - (153 * mp + 2) / 5 + 1;
+    uint32_t m = mp < 10 ? mp + 3 : mp - 9;
+    uint32_t y = yoe + era * 400 + (m <= 2);
+    uint32_t s = epoch % 86400;
+    snprintf(out, n, "%04u-%02u-%02uT%02u:%02u:%02uZ",
+             (unsigned)y, (unsigned)m, (unsigned)d,
+             (unsigned)(s / 3600), (unsigned)(s / 60 % 60), (unsigned)(s % 60));
+}
 
-    // Update satellite count whenever available
+// A completed NMEA sentence; position updates are published at once so the
+// fix is stamped within a sentence of arriving
+static void fyGPSOnSentence() {
     if (fyGPS.satellites.isUpdated()) {
         fyHWGPSSats = fyGPS.satellites.value();
     }
 
-    // Update position when valid fix is available
-    if (fyGPS.location.isUpdated() && fyGPS.location.isValid()) {
+    FYFix f;
+    if (fyGPSTakeFix(fyGPS, GPS_HDOP_SCALE, f)) {
         if (!fyHWGPSFix) {
             printf("[FLOCK-YOU] First GPS fix acquired! Sats:%d Lat:%.6f Lon:%.6f\n",
-                   fyHWGPSSats, fyGPS.location.lat(), fyGPS.location.lng());
+                   fyHWGPSSats, f.lat, f.lon);
         }
         fyHWGPSFix = true;
-        fyGPSIsHardware = true;
-        fyGPSLat = fyGPS.location.lat();
-        fyGPSLon = fyGPS.location.lng();
-        fyGPSAcc = fyGPS.hdop.isValid() ? (float)(fyGPS.hdop.hdop() * GPS_HDOP_SCALE) : 10.0f;
-        fyGPSValid = true;
-        fyGPSLastUpdate = millis();
-    } else if (fyHWGPSFix && fyGPS.location.isValid()) {
-        // Keep updating timestamp while fix is held
-        fyGPSLastUpdate = millis();
+        // Every update refreshes the timestamp, so a held fix never goes stale
+        fyPublishFix(f);
     }
+
+    // GPS time dates the session history
+    if (!fyEpochAtBoot && fyGPS.date.isValid() && fyGPS.time.isValid() && fyGPS.date.year() >= 2020) {
+        fySetClock(fyEpochFromCivil(fyGPS.date.year(), fyGPS.date.month(), fyGPS.date.day(),
+                                    fyGPS.time.hour(), fyGPS.time.minute(), fyGPS.time.second()));
+    }
+}
+
+// Runs in the UART driver's event task: data reached the FIFO threshold or
+// the line went idle after a burst
+static void fyGPSOnReceive() {
+    if (fyGPSTaskHandle) xTaskNotifyGive(fyGPSTaskHandle);
+}
+
+// Parses NMEA off the main loop: sleeps until the UART has data (or a second
+// passes, for the timeout), drains the driver's ring buffer in blocks and
+// feeds TinyGPS++
+static void fyGPSTask(void*) {
+    uint8_t buf[128];
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(1000));
+        size_t n;
+        while ((n = fyGPSSerial.read(buf, sizeof(buf))) > 0) {
+            fyHWGPSLastChar = millis();
+            if (!fyHWGPSDetected) {
+                fyHWGPSDetected = true;
+                printf("[FLOCK-YOU] Hardware GPS module detected (NMEA data received)\n");
+            }
+            for (size_t i = 0; i < n; i++) {
+                if (fyGPS.encode((char)buf[i])) fyGPSOnSentence();
+            }
+        }
+
+        // Timeout: no NMEA data for 5s → module disconnected or absent
+        if (fyHWGPSDetected && (millis() - fyHWGPSLastChar > GPS_HW_TIMEOUT_MS)) {
+            FYFix f;
+            if (fyHWGPSFix && fyReadFix(f) && f.hw) {
+                printf("[FLOCK-YOU] Hardware GPS timeout — falling back to phone GPS\n");
+            }
+            fyHWGPSDetected = false;
+            fyHWGPSFix = false;
+            fyHWGPSSats = 0;
+        }
+    }
+}
+
+static void fyStartGPS() {
+    fyGPSSerial.setRxBufferSize(GPS_RX_BUFFER);
+    fyGPSSerial.begin(GPS_BAUD, SERIAL_8N1, GPS_RX_PIN, GPS_TX_PIN);
+    xTaskCreate(fyGPSTask, "fy_gps", GPS_TASK_STACK, nullptr, GPS_TASK_PRIORITY, &fyGPSTaskHandle);
+    fyGPSSerial.onReceive(fyGPSOnReceive);
+}
+
+// ============================================================================
+// DETECTION POOL + INDEX
+// ============================================================================
+
+// Allocate the pool, index, recency and dirty lists in one block
+static bool fyAllocDetections(int capacity, uint32_t caps) {
+    uint32_t buckets = 1;
+    while (buckets < (uint32_t)capacity * 2) buckets <<= 1;  // load factor <= 0.5
+
+    size_t bytes = capacity * (sizeof(FYDetection) + sizeof(AdvInterval) + 3 * sizeof(uint16_t)) +
+                   buckets * sizeof(uint16_t);
+    uint8_t* mem = (uint8_t*)heap_caps_malloc(bytes, caps);
+    if (!mem) return false;
+    memset(mem, 0, capacity * (sizeof(FYDetection) + sizeof(AdvInterval)));  // Clear dirty flags
+
+    fyDet = (FYDetection*)mem;
+    fyAdvLive = (AdvInterval*)(mem + capacity * sizeof(FYDetection));
+    fyLruPrev = (uint16_t*)(fyAdvLive + capacity);
+    fyLruNext = fyLruPrev + capacity;
+    fyDirty = fyLruNext + capacity;
+    fyDetIndex = fyDirty + capacity;
+    fyDetIndexMask = buckets - 1;
+    fyDetCapacity = capacity;
+    return true;
+}
+
+// Caller holds fyMutex. The session file is rewritten at the next checkpoint.
+static void fyClearDetections() {
+    for (int i = 0; i < fyDirtyCount; i++) fyDet[fyDirty[i]].dirty = false;
+    fyDirtyCount = 0;
+    fyLog.compact = true;
+    fyLog.backoffMs = 0;      // A cleared pool always fits, retry right away
+    fyDetCount = 0;
+    fyDetRemovedSeq = ++fyDetSeq;
+    fyDetRaven = fyDetWithGPS = 0;
+    fyLruHead = fyLruTail = FY_SLOT_NONE;
+    memset(fyDetIndex, 0xFF, (fyDetIndexMask + 1) * sizeof(uint16_t));
+}
+
+// Caller holds fyMutex, after moving the slot to the recency head. A slot's
+// dirty flag is set exactly while it is on fyDirty, so the list never holds
+// more than fyDetCapacity entries.
+static void fyQueueDirty(uint16_t slot) {
+    if (fyDet[slot].dirty) return;
+    fyDet[slot].dirty = true;
+    fyDirty[fyDirtyCount++] = slot;
+}
+
+static void fyMarkDirty(uint16_t slot) {
+    fyDet[slot].seq = ++fyDetSeq;
+    fyQueueDirty(slot);
+}
+
+static uint64_t fyMacKey(const uint8_t* native) {
+    // NimBLE native order is little-endian (native[0] = last octet)
+    uint64_t key = 0;
+    for (int i = 5; i >= 0; i--) key = (key << 8) | native[i];
+    return key;
+}
+
+static uint32_t fyHashBucket(uint64_t key) {
+    return (uint32_t)((key * 0x9E3779B97F4A7C15ULL) >> 32) & fyDetIndexMask;
+}
+
+// Bucket holding key, or the empty bucket where it would go
+static uint32_t fyIndexProbe(uint64_t key) {
+    uint32_t b = fyHashBucket(key);
+    while (fyDetIndex[b] != FY_SLOT_NONE && fyDet[fyDetIndex[b]].macKey != key) {
+        b = (b + 1) & fyDetIndexMask;
+    }
+    return b;
+}
+
+// Slot of a stored device, for the BLE host task without fyMutex. That task
+// is the only writer of the index and of a slot's macKey and lastSeen,
+// except fyClearDetections(), which only empties buckets (possibly torn
+// mid-memset, hence the range check). Racing a clear can at worst treat a
+// cleared device as stored for one more FY_REPEAT_MS.
+static uint16_t fyFindUnlocked(uint64_t key) {
+    uint32_t b = fyHashBucket(key);
+    for (uint32_t n = 0; n <= fyDetIndexMask; n++) {
+        uint16_t slot = __atomic_load_n(&fyDetIndex[b], __ATOMIC_RELAXED);
+        if (slot >= fyDetCapacity) return FY_SLOT_NONE;  // Includes FY_SLOT_NONE
+        if (fyDet[slot].macKey == key) return slot;
+        b = (b + 1) & fyDetIndexMask;
+    }
+    return FY_SLOT_NONE;
+}
+
+// Backward-shift delete keeps probe chains intact without tombstones
+static void fyIndexRemove(uint64_t key) {
+    uint32_t hole = fyIndexProbe(key);
+    if (fyDetIndex[hole] == FY_SLOT_NONE) return;
+    uint32_t b = hole;
+    for (;;) {
+        b = (b + 1) & fyDetIndexMask;
+        uint16_t slot = fyDetIndex[b];
+        if (slot == FY_SLOT_NONE) break;
+        uint32_t home = fyHashBucket(fyDet[slot].macKey);
+        // Move the entry back if its home is not within (hole, b]
+        if (((b - home) & fyDetIndexMask) >= ((b - hole) & fyDetIndexMask)) {
+            fyDetIndex[hole] = slot;
+            hole = b;
+        }
+    }
+    fyDetIndex[hole] = FY_SLOT_NONE;
+}
+
+// Keep the /api/stats counters in step with the pool: dir = -1 before a
+// detection is changed or dropped, +1 once it is stored
+static void fyCountDetection(const FYDetection& d, int dir) {
+    if (d.isRaven) fyDetRaven += dir;
+    if (d.hasGPS) fyDetWithGPS += dir;
+}
+
+static void fyLruUnlink(uint16_t slot) {
+    uint16_t p = fyLruPrev[slot], n = fyLruNext[slot];
+    if (p != FY_SLOT_NONE) fyLruNext[p] = n; else fyLruHead = n;
+    if (n != FY_SLOT_NONE) fyLruPrev[n] = p; else fyLruTail = p;
+}
+
+static void fyLruPushFront(uint16_t slot) {
+    fyLruPrev[slot] = FY_SLOT_NONE;
+    fyLruNext[slot] = fyLruHead;
+    if (fyLruHead != FY_SLOT_NONE) fyLruPrev[fyLruHead] = slot;
+    fyLruHead = slot;
+    if (fyLruTail == FY_SLOT_NONE) fyLruTail = slot;
+}
+
+// Slot for a new detection: next free slot, or the evicted one when full.
+// Returns FY_SLOT_NONE when the pool is full and eviction is disabled.
+static uint16_t fyTakeSlot() {
+    if (fyDetCount < fyDetCapacity) return fyDetCount++;
+#if FY_EVICT_POLICY == FY_EVICT_LRU
+    uint16_t victim = fyLruTail;
+    fyIndexRemove(fyDet[victim].macKey);
+    fyLruUnlink(victim);
+    fyCountDetection(fyDet[victim], -1);
+    fyDetEvicted++;
+    fyDetRemovedSeq = fyDetSeq + 1;  // The new detection's change
+    return victim;
+#else
+    return FY_SLOT_NONE;
+#endif
 }
 
 // ============================================================================
 // DETECTION MANAGEMENT
 // ============================================================================
 
-static int fyAddDetection(const char* mac, const char* name, int rssi,
-                          const char* method, bool isRaven = false,
-                          const char* ravenFW = "") {
-    if (!fyMutex || xSemaphoreTake(fyMutex, pdMS_TO_TICKS(100)) != pdTRUE) return -1;
+// Record a sighting. Returns the device's sighting count (1 = new device),
+// 0 for a repeat advertisement within FY_REPEAT_MS of the last sighting,
+// or -1 if it could not be stored. BLE host task only: the interval
+// statistics of a stored device were already updated by onResult and are
+// copied into the pool entry here.
+static int fyAddDetection(uint64_t macKey, const char* mac, const char* name, int rssi,
+                          uint8_t signals, const char* ravenFW = "") {
+    bool isRaven = signals & FY_SIG_BIT(FY_SIG_RAVEN_SVC);
+
+    if (!fyMutex || !fyDet || xSemaphoreTake(fyMutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+        fyDetDropped++;
+        return -1;
+    }
 
     // Update existing by MAC
-    for (int i = 0; i < fyDetCount; i++) {
-        if (strcasecmp(fyDet[i].mac, mac) == 0) {
-            fyDet[i].count++;
-            fyDet[i].lastSeen = millis();
-            fyDet[i].rssi = rssi;
-            if (name && name[0]) {
-                strncpy(fyDet[i].name, name, sizeof(fyDet[i].name) - 1);
-            }
-            // Update GPS on every re-sighting (captures movement)
-            fyAttachGPS(fyDet[i]);
+    uint32_t bucket = fyIndexProbe(macKey);
+    if (fyDetIndex[bucket] != FY_SLOT_NONE) {
+        uint16_t i = fyDetIndex[bucket];
+        unsigned long now = millis();
+        fyDet[i].adv = fyAdvLive[i];
+        if (advIntervalSteady(fyDet[i].adv)) signals |= FY_SIG_BIT(FY_SIG_STEADY);
+        if (now - fyDet[i].lastSeen < FY_REPEAT_MS && !(signals & ~fyDet[i].signals)) {
             xSemaphoreGive(fyMutex);
-            return i;
+            return 0;
+        }
+        fyCountDetection(fyDet[i], -1);
+        fyDet[i].count++;
+        fyDet[i].lastSeen = millis();
+        fyDet[i].rssi = rssi;
+        if (name && name[0]) {
+            strncpy(fyDet[i].name, name, sizeof(fyDet[i].name) - 1);
+        }
+        // Signals accumulate over sightings
+        if (signals & ~fyDet[i].signals) {
+            fyDet[i].signals |= signals;
+            strncpy(fyDet[i].method, fySignalMethod(fyDet[i].signals), sizeof(fyDet[i].method) - 1);
+        }
+        if (isRaven) {
+            fyDet[i].isRaven = true;
+            strncpy(fyDet[i].ravenFW, ravenFW, sizeof(fyDet[i].ravenFW) - 1);
         }
+        // Update GPS on every re-sighting (captures movement)
+        fyAttachGPS(fyDet[i]);
+        fyCountDetection(fyDet[i], 1);
+        fyLruUnlink(i);
+        fyLruPushFront(i);
+        fyMarkDirty(i);
+        int count = fyDet[i].count;
+        xSemaphoreGive(fyMutex);
+        return count;
     }
 
     // Add new
-    if (fyDetCount < MAX_DETECTIONS) {
-        FYDetection& d = fyDet[fyDetCount];
+    uint16_t slot = fyTakeSlot();
+    if (slot != FY_SLOT_NONE) {
+        FYDetection& d = fyDet[slot];
+        bool queued = d.dirty;  // An evicted slot may still be on fyDirty
         memset(&d, 0, sizeof(d));
+        d.dirty = queued;
+        d.macKey = macKey;
         strncpy(d.mac, mac, sizeof(d.mac) - 1);
         // Sanitize name for JSON safety
         if (name) {
@@ -500,19 +974,28 @@ static int fyAddDetection(const char* mac, const char* name, int rssi,
             }
         }
         d.rssi = rssi;
-        strncpy(d.method, method, sizeof(d.method) - 1);
+        d.signals = signals;
+        strncpy(d.method, fySignalMethod(signals), sizeof(d.method) - 1);
         d.firstSeen = millis();
         d.lastSeen = millis();
         d.count = 1;
+        memset(&fyAdvLive[slot], 0, sizeof(AdvInterval));
+        advIntervalAdd(fyAdvLive[slot], d.firstSeen, fyLastBleScan);
+        d.adv = fyAdvLive[slot];
         d.isRaven = isRaven;
         strncpy(d.ravenFW, ravenFW ? ravenFW : "", sizeof(d.ravenFW) - 1);
         // Attach GPS from phone
         fyAttachGPS(d);
-        int idx = fyDetCount++;
+        fyCountDetection(d, 1);
+        // Eviction may have moved entries, so probe again for the bucket
+        fyDetIndex[fyIndexProbe(macKey)] = slot;
+        fyLruPushFront(slot);
+        fyMarkDirty(slot);
         xSemaphoreGive(fyMutex);
-        return idx;
+        return 1;
     }
 
+    fyDetDropped++;
     xSemaphoreGive(fyMutex);
     return -1;
 }
@@ -520,100 +1003,91 @@ static int fyAddDetection(const char* mac, const char* name, int rssi,
 // ============================================================================
 // BLE SCANNING
 // ============================================================================
+// Interval statistics are kept in fyAdvLive, which only this callback and
+// fyAddDetection() write. A device's statistics are copied into its pool
+// entry whenever it is reported, so exports trail them by FY_REPEAT_MS at
+// most.
 
 class FYBLECallbacks : public NimBLEAdvertisedDeviceCallbacks {
     void onResult(NimBLEAdvertisedDevice* dev) override {
         NimBLEAddress addr = dev->getAddress();
-        std::string addrStr = addr.toString();
-
-        // Safe MAC byte extraction
-        unsigned int m[6];
-        sscanf(addrStr.c_str(), "%02x:%02x:%02x:%02x:%02x:%02x",
-               &m[0], &m[1], &m[2], &m[3], &m[4], &m[5]);
-        uint8_t mac[6] = {(uint8_t)m[0], (uint8_t)m[1], (uint8_t)m[2],
-                          (uint8_t)m[3], (uint8_t)m[4], (uint8_t)m[5]};
-
-        int rssi = dev->getRSSI();
-        std::string name = dev->haveName() ? dev->getName() : "";
 
-        bool detected = false;
-        const char* method = "";
-        bool isRaven = false;
-        const char* ravenFW = "";
-
-        // 1. Check MAC prefix against known Flock Safety OUIs
-        if (checkMACPrefix(mac)) {
-            detected = true;
-            method = "mac_prefix";
-        }
-
-        // 2. Check BLE device name patterns
-        if (!detected && !name.empty() && checkDeviceName(name.c_str())) {
-            detected = true;
-            method = "device_name";
-        }
-
-        // 3. Check BLE manufacturer company IDs (from wgreenberg/flock-you)
-        if (!detected) {
-            for (int i = 0; i < (int)dev->getManufacturerDataCount(); i++) {
-                std::string data = dev->getManufacturerData(i);
-                if (data.size() >= 2) {
-                    uint16_t code = ((uint16_t)(uint8_t)data[1] << 8) |
-                                     (uint16_t)(uint8_t)data[0];
-                    if (checkManufacturerID(code)) {
-                        detected = true;
-                        method = "ble_mfr_id";
-                        break;
-                    }
-                }
+        // Binary MAC straight from the stack (native order is reversed)
+        const uint8_t* native = addr.getNative();
+        uint64_t macKey = fyMacKey(native);
+
+        // Duplicates are reported, so most calls are repeats from stored
+        // devices: fold them into the interval statistics and stop before
+        // any parsing, formatting or locking
+        uint16_t known = fyFindUnlocked(macKey);
+        if (known != FY_SLOT_NONE) {
+            unsigned long now = millis();
+            advIntervalAdd(fyAdvLive[known], now, fyLastBleScan);
+            if (now - fyDet[known].lastSeen < FY_REPEAT_MS) {
+                fyDeviceInRange = true;
+                fyLastDetTime = now;
+                return;
             }
         }
 
-        // 4. Check Raven gunshot detector service UUIDs
-        if (!detected) {
-            char detUUID[41] = {0};
-            if (checkRavenUUID(dev, detUUID)) {
-                detected = true;
-                method = "raven_uuid";
-                isRaven = true;
-                ravenFW = estimateRavenFW(dev);
-            }
-        }
+        uint8_t mac[6];
+        for (int i = 0; i < 6; i++) mac[i] = native[5 - i];
 
-        if (detected) {
-            int idx = fyAddDetection(addrStr.c_str(), name.c_str(), rssi,
-                                     method, isRaven, ravenFW);
+        int rssi = dev->getRSSI();
+
+        // Signatures may be swapped by an upload; skip the advert rather than block the host
+        if (!fySigMutex || xSemaphoreTake(fySigMutex, pdMS_TO_TICKS(20)) != pdTRUE) return;
+        FYAdvert adv;
+        fyParseAdvert(mac, dev->getPayload(), dev->getPayloadLength(), fySig.services, adv);
+        uint8_t signals = fyEvalRules(fyRules, adv, fySig.ouis, fySig.mfrIds, fyNames);
+        xSemaphoreGive(fySigMutex);
+
+        uint8_t score = fyScoreSignals(signals);
+        if (score >= FY_SCORE_DETECT) {
+            char addrStr[18];
+            snprintf(addrStr, sizeof(addrStr), "%02x:%02x:%02x:%02x:%02x:%02x",
+                     mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+            const char* method = fySignalMethod(signals);
+            bool isRaven = signals & FY_SIG_BIT(FY_SIG_RAVEN_SVC);
+            const char* ravenFW = isRaven ? estimateRavenFW(adv.svcMask) : "";
+            int count = fyAddDetection(macKey, addrStr, adv.name, rssi,
+                                       signals, ravenFW);
+            fyDeviceInRange = true;
+            fyLastDetTime = millis();
+            if (count == 0) return;  // Repeat advert, already reported
 
             // Human-readable log
             printf("[FLOCK-YOU] DETECTED: %s %s RSSI:%d [%s] count:%d\n",
-                   addrStr.c_str(), name.c_str(), rssi, method,
-                   idx >= 0 ? fyDet[idx].count : 0);
+                   addrStr, adv.name, rssi, method,
+                   count > 0 ? count : 0);
 
             // JSON serial output (Flask-compatible format for live ingestion)
             // Build GPS fragment if available
             char gpsBuf[80] = "";
-            if (fyGPSIsFresh()) {
+            FYFix fix;
+            if (fyFreshFix(fix)) {
                 snprintf(gpsBuf, sizeof(gpsBuf),
                     ",\"gps\":{\"latitude\":%.8f,\"longitude\":%.8f,\"accuracy\":%.1f}",
-                    fyGPSLat, fyGPSLon, fyGPSAcc);
+                    fix.lat, fix.lon, fix.acc);
             }
             if (isRaven) {
                 printf("{\"detection_method\":\"%s\",\"protocol\":\"bluetooth_le\","
                        "\"mac_address\":\"%s\",\"device_name\":\"%s\","
-                       "\"rssi\":%d,\"is_raven\":true,\"raven_fw\":\"%s\"%s}\n",
-                       method, addrStr.c_str(), name.c_str(), rssi, ravenFW, gpsBuf);
+                       "\"rssi\":%d,\"confidence\":%u,\"signals\":%u,"
+                       "\"is_raven\":true,\"raven_fw\":\"%s\"%s}\n",
+                       method, addrStr, adv.name, rssi, (unsigned)score,
+                       (unsigned)signals, ravenFW, gpsBuf);
             } else {
                 printf("{\"detection_method\":\"%s\",\"protocol\":\"bluetooth_le\","
                        "\"mac_address\":\"%s\",\"device_name\":\"%s\","
-                       "\"rssi\":%d%s}\n",
-                       method, addrStr.c_str(), name.c_str(), rssi, gpsBuf);
+                       "\"rssi\":%d,\"confidence\":%u,\"signals\":%u%s}\n",
+                       method, addrStr, adv.name, rssi, (unsigned)score,
+                       (unsigned)signals, gpsBuf);
             }
 
-            if (idx >= 0 && fyDet[idx].count == 1) {
+            if (count == 1) {
                 fyDetectBeep();  // Flash + sound on every NEW device
             }
-            fyDeviceInRange = true;
-            fyLastDetTime = millis();
             fyLastHB = millis();
         }
     }
@@ -623,256 +1097,1320 @@ class FYBLECallbacks : public NimBLEAdvertisedDeviceCallbacks {
 // JSON HELPER
 // ============================================================================
 
-static void writeDetectionsJSON(AsyncResponseStream *resp) {
-    resp->print("[");
-    if (fyMutex && xSemaphoreTake(fyMutex, pdMS_TO_TICKS(200)) == pdTRUE) {
-        for (int i = 0; i < fyDetCount; i++) {
-            if (i > 0) resp->print(",");
-            resp->printf(
-                "{\"mac\":\"%s\",\"name\":\"%s\",\"rssi\":%d,\"method\":\"%s\","
-                "\"first\":%lu,\"last\":%lu,\"count\":%d,"
-                "\"raven\":%s,\"fw\":\"%s\"",
-                fyDet[i].mac, fyDet[i].name, fyDet[i].rssi, fyDet[i].method,
-                fyDet[i].firstSeen, fyDet[i].lastSeen, fyDet[i].count,
-                fyDet[i].isRaven ? "true" : "false", fyDet[i].ravenFW);
-            // Append GPS if present
-            if (fyDet[i].hasGPS) {
-                resp->printf(",\"gps\":{\"lat\":%.8f,\"lon\":%.8f,\"acc\":%.1f}",
-                    fyDet[i].gpsLat, fyDet[i].gpsLon, fyDet[i].gpsAcc);
-            }
-            resp->print("}");
-        }
-        xSemaphoreGive(fyMutex);
+// One detection object; shared by the live export and session history.
+// History adds the session id and, when the session's clock is known, the
+// Unix time of the last sighting.
+static void fyPrintDetectionJSON(Print& out, const FYDetection& d,
+                                 uint32_t sessionId = 0, uint32_t startEpoch = 0) {
+    out.printf(
+        "{\"mac\":\"%s\",\"name\":\"%s\",\"rssi\":%d,\"method\":\"%s\","
+        "\"first\":%lu,\"last\":%lu,\"count\":%d,"
+        "\"raven\":%s,\"fw\":\"%s\"",
+        d.mac, d.name, d.rssi, d.method,
+        d.firstSeen, d.lastSeen, d.count,
+        d.isRaven ? "true" : "false", d.ravenFW);
+    // Records from before scoring have no signals
+    if (d.signals) {
+        out.printf(",\"signals\":%u,\"score\":%u", (unsigned)d.signals, (unsigned)fyScoreSignals(d.signals));
+    }
+    // Append GPS if present: last fix, and the estimated device location
+    if (d.hasGPS) {
+        out.printf(",\"gps\":{\"lat\":%.8f,\"lon\":%.8f,\"acc\":%.1f}",
+            d.gpsLat, d.gpsLon, d.gpsAcc);
     }
-    resp->print("]");
+    if (d.estN) {
+        out.printf(",\"est\":{\"lat\":%.8f,\"lon\":%.8f,\"r\":%.1f,\"n\":%u}",
+            d.estLat, d.estLon, d.estR, (unsigned)d.estN);
+    }
+    if (d.adv.n) {
+        out.print(",\"adv\":");
+        advIntervalPrintJSON(out, d.adv);
+    }
+    if (sessionId) out.printf(",\"session\":%u", (unsigned)sessionId);
+    if (startEpoch) out.printf(",\"time\":%u", (unsigned)(startEpoch + d.lastSeen / 1000));
+    out.print("}");
 }
 
 // ============================================================================
 // SESSION PERSISTENCE (SPIFFS)
 // ============================================================================
+// The live session is an append-only log of fixed-size FYSessionRecords
+// (fy_record.h). Each checkpoint appends only the detections on fyDirty,
+// copying them out FY_REC_BATCH at a time so fyMutex is never held across
+// a flash write. Later records for the same MAC supersede earlier ones; once stale records
+// outnumber live detections (plus FY_LOG_SLACK), or the log nears its
+// budget, the live pool is written to FY_SESSION_TMP and swapped in, if the
+// old log and the copy fit in the budget together (fyLogPlan). The budget
+// is the log's share from fyStoragePlan() in setup(), which also caps the
+// pool so a compaction always fits. Detections stay on fyDirty until a
+// write that holds them succeeds. At boot the log is replayed, stopping at
+// the first record with a bad magic or CRC (a torn final write), and moved
+// into the session history.
+
+#define FY_REC_BATCH 32             // Records copied per fyMutex hold
+
+static FYSessionRecord fyRecBatch[FY_REC_BATCH];
+static SemaphoreHandle_t fySessionMutex = NULL;   // Serializes checkpoints (loop, /api/clear)
+
+// seal = false skips the CRC for records that never reach flash (snapshots)
+static void fyRecordFromDetection(const FYDetection& d, FYSessionRecord& r, bool seal = true) {
+    memset(&r, 0, sizeof(r));
+    r.magic = FY_REC_MAGIC;
+    r.macKey = d.macKey;
+    r.gpsLat = d.gpsLat;
+    r.gpsLon = d.gpsLon;
+    r.firstSeen = d.firstSeen;
+    r.lastSeen = d.lastSeen;
+    r.count = d.count;
+    r.gpsAcc = d.gpsAcc;
+    r.rssi = d.rssi;
+    r.flags = (d.isRaven ? FY_REC_RAVEN : 0) | (d.hasGPS ? FY_REC_GPS : 0);
+    r.signals = d.signals;
+    memcpy(r.name, d.name, sizeof(r.name) - 1);
+    if (d.estN) {
+        r.estN = d.estN;
+        r.estR = d.estR < 65535.0f ? (uint16_t)lroundf(d.estR) : 65535;
+        r.estDLat = (float)(d.estLat - d.gpsLat);
+        r.estDLon = (float)(d.estLon - d.gpsLon);
+    }
+    memcpy(r.method, d.method, sizeof(r.method));
+    memcpy(r.ravenFW, d.ravenFW, sizeof(r.ravenFW));
+    if (seal) fyRecordSeal(r);
+}
 
-static void fySaveSession() {
-    if (!fySpiffsReady || !fyMutex) return;
-    if (xSemaphoreTake(fyMutex, pdMS_TO_TICKS(300)) != pdTRUE) return;
-
-    File f = SPIFFS.open(FY_SESSION_FILE, "w");
-    if (!f) { xSemaphoreGive(fyMutex); return; }
-
-    f.print("[");
-    for (int i = 0; i < fyDetCount; i++) {
-        if (i > 0) f.print(",");
-        FYDetection& d = fyDet[i];
-        f.printf("{\"mac\":\"%s\",\"name\":\"%s\",\"rssi\":%d,\"method\":\"%s\","
-                 "\"first\":%lu,\"last\":%lu,\"count\":%d,"
-                 "\"raven\":%s,\"fw\":\"%s\"",
-                 d.mac, d.name, d.rssi, d.method,
-                 d.firstSeen, d.lastSeen, d.count,
-                 d.isRaven ? "true" : "false", d.ravenFW);
-        if (d.hasGPS) {
-            f.printf(",\"gps\":{\"lat\":%.8f,\"lon\":%.8f,\"acc\":%.1f}", d.gpsLat, d.gpsLon, d.gpsAcc);
+static void fyRecordToDetection(const FYSessionRecord& r, FYDetection& d) {
+    memset(&d, 0, sizeof(d));
+    d.macKey = r.macKey;
+    snprintf(d.mac, sizeof(d.mac), "%02x:%02x:%02x:%02x:%02x:%02x",
+             (unsigned)(r.macKey >> 40) & 0xFF, (unsigned)(r.macKey >> 32) & 0xFF,
+             (unsigned)(r.macKey >> 24) & 0xFF, (unsigned)(r.macKey >> 16) & 0xFF,
+             (unsigned)(r.macKey >> 8) & 0xFF, (unsigned)r.macKey & 0xFF);
+    memcpy(d.name, r.name, sizeof(r.name) - 1);
+    d.rssi = r.rssi;
+    memcpy(d.method, r.method, sizeof(d.method) - 1);
+    d.signals = r.signals;
+    d.firstSeen = r.firstSeen;
+    d.lastSeen = r.lastSeen;
+    d.count = r.count;
+    d.isRaven = r.flags & FY_REC_RAVEN;
+    memcpy(d.ravenFW, r.ravenFW, sizeof(d.ravenFW) - 1);
+    d.hasGPS = r.flags & FY_REC_GPS;
+    d.gpsLat = r.gpsLat;
+    d.gpsLon = r.gpsLon;
+    d.gpsAcc = r.gpsAcc;
+    if (r.estN) {
+        d.estN = r.estN;
+        d.estR = r.estR;
+        d.estLat = r.gpsLat + r.estDLat;
+        d.estLon = r.gpsLon + r.estDLon;
+    }
+}
+
+// Boot only (no other task touches the pool yet): later copies of a MAC
+// replace earlier ones
+static void fyRestoreDetection(const FYDetection& src) {
+    uint16_t slot = fyDetIndex[fyIndexProbe(src.macKey)];
+    if (slot == FY_SLOT_NONE) {
+        slot = fyTakeSlot();
+        if (slot == FY_SLOT_NONE) return;
+        fyDetIndex[fyIndexProbe(src.macKey)] = slot;
+    } else {
+        fyLruUnlink(slot);
+        fyCountDetection(fyDet[slot], -1);
+    }
+    fyLruPushFront(slot);
+    fyDet[slot] = src;
+    fyAdvLive[slot] = src.adv;
+    fyDet[slot].dirty = false;
+    fyDet[slot].seq = ++fyDetSeq;
+    fyCountDetection(fyDet[slot], 1);
+}
+
+// Rewrite the file from the live pool. Returns false if it must be retried.
+static bool fyCompactSession() {
+    File f = SPIFFS.open(FY_SESSION_TMP, "w");
+    if (!f) { fyLogCompactFailed(fyLog, millis()); return false; }
+
+    // Everything live as of startSeq goes into the new file; the dirty marks
+    // are only dropped once it has replaced the old one. A clear while this
+    // runs asks for another rewrite.
+    if (xSemaphoreTake(fyMutex, pdMS_TO_TICKS(300)) != pdTRUE) { f.close(); return false; }
+    uint32_t startSeq = fyDetSeq;
+    bool forced = fyLog.compact;
+    fyLog.compact = false;
+    xSemaphoreGive(fyMutex);
+
+    uint32_t written = 0;
+    bool ok = true;
+    for (int start = 0; ok; start += FY_REC_BATCH) {
+        if (xSemaphoreTake(fyMutex, pdMS_TO_TICKS(300)) != pdTRUE) { ok = false; break; }
+        int n = 0;
+        while (n < FY_REC_BATCH && start + n < fyDetCount) {
+            fyRecordFromDetection(fyDet[start + n], fyRecBatch[n]);
+            n++;
         }
-        f.print("}");
+        xSemaphoreGive(fyMutex);
+        if (n == 0) break;
+        size_t bytes = n * sizeof(FYSessionRecord);
+        if (f.write((const uint8_t*)fyRecBatch, bytes) != bytes) ok = false;
+        else written += n;
     }
-    f.print("]");
     f.close();
-    fyLastSaveCount = fyDetCount;
-    printf("[FLOCK-YOU] Session saved: %d detections\n", fyDetCount);
-    xSemaphoreGive(fyMutex);
+
+    if (ok) {
+        SPIFFS.remove(FY_SESSION_FILE);
+        ok = SPIFFS.rename(FY_SESSION_TMP, FY_SESSION_FILE);
+    }
+    if (!ok) {
+        SPIFFS.remove(FY_SESSION_TMP);
+        if (forced) fyLog.compact = true;
+        fyLogCompactFailed(fyLog, millis());
+        printf("[FLOCK-YOU] Session compaction failed, retry in %us\n",
+               (unsigned)(fyLog.backoffMs / 1000));
+        return false;
+    }
+    printf("[FLOCK-YOU] Session compacted: %u -> %u records\n",
+           (unsigned)fyLog.records, (unsigned)written);
+    fyLogCompacted(fyLog, written);
+    fyLogFullNoted = false;
+
+    // Slots that changed after startSeq may have been copied before the
+    // change, so they stay queued and get appended at the next checkpoint
+    if (xSemaphoreTake(fyMutex, pdMS_TO_TICKS(300)) == pdTRUE) {
+        int kept = 0;
+        for (int i = 0; i < fyDirtyCount; i++) {
+            uint16_t slot = fyDirty[i];
+            if ((int32_t)(fyDet[slot].seq - startSeq) > 0) fyDirty[kept++] = slot;
+            else fyDet[slot].dirty = false;
+        }
+        fyDirtyCount = kept;
+        xSemaphoreGive(fyMutex);
+    }
+    return true;
 }
 
-static void fyPromotePrevSession() {
-    // Copy current session to prev_session on boot, then delete original
-    // NOTE: SPIFFS.rename() is unreliable on ESP32 — use copy+delete instead
-    if (!fySpiffsReady) return;
-    if (!SPIFFS.exists(FY_SESSION_FILE)) {
-        printf("[FLOCK-YOU] No prior session file to promote\n");
+// Append changed detections, or compact, as fyLogPlan() decides. Other
+// files share the partition, so the budget is also capped by the flash
+// actually free. Caller holds fySessionMutex.
+static void fyCheckpointSession() {
+    size_t total = SPIFFS.totalBytes(), used = SPIFFS.usedBytes();
+    uint32_t freeRec = (total > used ? total - used : 0) / sizeof(FYSessionRecord);
+    fyLog.budget = fyLog.records + freeRec < fyLogBudget ? fyLog.records + freeRec : fyLogBudget;
+
+    uint32_t room;
+    FYLogAction act = fyLogPlan(fyLog, fyDetCount, fyDirtyCount, millis(), &room);
+    if (act == FY_LOG_COMPACT) {
+        fyCompactSession();
         return;
     }
-
-    File src = SPIFFS.open(FY_SESSION_FILE, "r");
-    if (!src) {
-        printf("[FLOCK-YOU] Failed to open session file for promotion\n");
+    if (fyDirtyCount == 0) return;
+    if (act == FY_LOG_FULL) {
+        if (!fyLogFullNoted) {
+            printf("[FLOCK-YOU] Session log full (%u records), %d changes not saved\n",
+                   (unsigned)fyLog.records, fyDirtyCount);
+            fyLogFullNoted = true;
+        }
         return;
     }
-    String data = src.readString();
-    src.close();
 
-    if (data.length() == 0) {
-        printf("[FLOCK-YOU] Session file empty, skipping promotion\n");
-        SPIFFS.remove(FY_SESSION_FILE);
+    File f = SPIFFS.open(FY_SESSION_FILE, "a");
+    if (!f) return;
+    uint32_t written = 0;
+    uint16_t slots[FY_REC_BATCH];
+    while (written < room) {
+        if (xSemaphoreTake(fyMutex, pdMS_TO_TICKS(300)) != pdTRUE) break;
+        int n = 0;
+        while (n < FY_REC_BATCH && written + n < room && fyDirtyCount > 0) {
+            uint16_t slot = fyDirty[--fyDirtyCount];
+            fyDet[slot].dirty = false;
+            slots[n] = slot;
+            fyRecordFromDetection(fyDet[slot], fyRecBatch[n++]);
+        }
+        xSemaphoreGive(fyMutex);
+        if (n == 0) break;
+        size_t bytes = n * sizeof(FYSessionRecord);
+        size_t put = f.write((const uint8_t*)fyRecBatch, bytes);
+        int done = put / sizeof(FYSessionRecord);
+        fyLog.records += done;
+        if (put != bytes) {
+            // Short write: queue what did not make it again. The file may
+            // now end in a torn record, so nothing more is appended to it
+            // until it has been rewritten.
+            fyLog.compact = true;
+            if (xSemaphoreTake(fyMutex, pdMS_TO_TICKS(300)) == pdTRUE) {
+                for (int i = done; i < n; i++) fyQueueDirty(slots[i]);
+                xSemaphoreGive(fyMutex);
+            }
+            break;
+        }
+        written += n;
+    }
+    f.close();
+    if (written > 0) {
+        fyLogFullNoted = false;
+        printf("[FLOCK-YOU] Session checkpoint: %u records (%u in file)\n",
+               (unsigned)written, (unsigned)fyLog.records);
+    }
+}
+
+static void fySaveSession() {
+    if (!fySpiffsReady || !fyMutex || !fyDet || !fySessionMutex) return;
+    if (xSemaphoreTake(fySessionMutex, pdMS_TO_TICKS(1000)) != pdTRUE) return;
+    fyCheckpointSession();
+    xSemaphoreGive(fySessionMutex);
+}
+
+// ============================================================================
+// KML EXPORT
+// ============================================================================
+
+static void fyPrintKMLHeader(Print& out, const char* name, const char* desc) {
+    out.print("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+              "<kml xmlns=\"http://www.opengis.net/kml/2.2\">\n<Document>\n");
+    out.printf("<name>%s</name>\n<description>%s</description>\n", name, desc);
+
+    // Detection pin style
+    out.print("<Style id=\"det\"><IconStyle><color>ff4489ec</color>"
+              "<scale>1.0</scale></IconStyle></Style>\n"
+              "<Style id=\"raven\"><IconStyle><color>ff4444ef</color>"
+              "<scale>1.2</scale></IconStyle></Style>\n");
+}
+
+// Caller skips detections without GPS
+static void fyPrintPlacemarkKML(Print& out, const FYDetection& d) {
+    out.print("<Placemark>\n");
+    out.printf("<name>%s</name>\n", d.mac);
+    out.printf("<styleUrl>#%s</styleUrl>\n", d.isRaven ? "raven" : "det");
+    out.print("<description><![CDATA[");
+    if (d.name[0]) out.printf("<b>Name:</b> %s<br/>", d.name);
+    out.printf("<b>Method:</b> %s<br/>", d.method);
+    if (d.signals) out.printf("<b>Confidence:</b> %u%%<br/>", (unsigned)fyScoreSignals(d.signals));
+    out.printf("<b>RSSI:</b> %d dBm<br/>"
+               "<b>Count:</b> %d<br/>",
+               d.rssi, d.count);
+    if (d.isRaven) out.printf("<b>Raven FW:</b> %s<br/>", d.ravenFW);
+    // Pin the estimated location when there is one
+    if (d.estN) {
+        out.printf("<b>Estimate:</b> &plusmn;%.0f m from %u fixes<br/>"
+                   "<b>Last fix:</b> %.6f, %.6f (&plusmn;%.1f m)",
+                   d.estR, (unsigned)d.estN, d.gpsLat, d.gpsLon, d.gpsAcc);
+    } else {
+        out.printf("<b>Accuracy:</b> %.1f m", d.gpsAcc);
+    }
+    out.print("]]></description>\n");
+    out.printf("<Point><coordinates>%.8f,%.8f,0</coordinates></Point>\n",
+               d.estN ? d.estLon : d.gpsLon, d.estN ? d.estLat : d.gpsLat);
+    out.print("</Placemark>\n");
+}
+
+// ============================================================================
+// SESSION HISTORY
+// ============================================================================
+// Finished sessions are kept as FYSessionRecords (one per device, most
+// recently seen first) in FY_HIST_DATA, used as a ring of fyHistBytes: a
+// session is written whole after the previous one, or from offset 0 when it
+// would run past the end. FY_HIST_INDEX lists the sessions still intact
+// (oldest first) with their start time, detection count and byte offset;
+// it is replaced via FY_HIST_INDEX_TMP and carries a CRC. Sessions are only
+// added in setup(), so web handlers can read the ring without locking.
+
+#define FY_HIST_MAGIC 0x48535946UL   // "FYSH"
+
+struct FYHistSession {
+    uint32_t id;           // 1, 2, 3... never reused
+    uint32_t startEpoch;   // Unix time the session booted, 0 = clock never set
+    uint32_t spanS;        // Last sighting, seconds after boot
+    uint32_t detections;
+    uint32_t offset;       // Records start here in FY_HIST_DATA
+    uint32_t reserved;
+};
+
+struct FYHistIndex {
+    uint32_t magic;
+    uint32_t nextId;       // Id the running session will get when promoted
+    uint32_t liveEpoch;    // Running session's start time once known
+    uint32_t head;         // Next write offset in FY_HIST_DATA
+    uint32_t count;
+    FYHistSession sessions[FY_HIST_SESSIONS];
+    uint32_t crc;          // CRC-32 of every byte before it
+};
+
+static FYHistIndex fyHist;
+
+static void fyHistSave() {
+    fyHist.crc = fyCrc32(0, (const uint8_t*)&fyHist, offsetof(FYHistIndex, crc));
+    File f = SPIFFS.open(FY_HIST_INDEX_TMP, "w");
+    if (!f) return;
+    bool ok = f.write((const uint8_t*)&fyHist, sizeof(fyHist)) == sizeof(fyHist);
+    f.close();
+    if (ok) {
+        SPIFFS.remove(FY_HIST_INDEX);
+        ok = SPIFFS.rename(FY_HIST_INDEX_TMP, FY_HIST_INDEX);
+    }
+    if (!ok) printf("[FLOCK-YOU] History index write failed\n");
+}
+
+static bool fyHistRead(const char* path) {
+    File f = SPIFFS.open(path, "r");
+    if (!f) return false;
+    bool ok = f.read((uint8_t*)&fyHist, sizeof(fyHist)) == sizeof(fyHist);
+    f.close();
+    return ok && fyHist.magic == FY_HIST_MAGIC && fyHist.count <= FY_HIST_SESSIONS &&
+           fyHist.crc == fyCrc32(0, (const uint8_t*)&fyHist, offsetof(FYHistIndex, crc));
+}
+
+static void fyHistLoad() {
+    // An interrupted save leaves only the tmp copy
+    if (fyHistRead(FY_HIST_INDEX) || fyHistRead(FY_HIST_INDEX_TMP)) return;
+    if (SPIFFS.exists(FY_HIST_INDEX) || SPIFFS.exists(FY_HIST_DATA)) {
+        printf("[FLOCK-YOU] History index unreadable, starting a new history\n");
+    }
+    SPIFFS.remove(FY_HIST_DATA);
+    memset(&fyHist, 0, sizeof(fyHist));
+    fyHist.magic = FY_HIST_MAGIC;
+    fyHist.nextId = 1;
+}
+
+static const FYHistSession* fyHistFind(uint32_t id) {
+    for (uint32_t i = 0; i < fyHist.count; i++) {
+        if (fyHist.sessions[i].id == id) return &fyHist.sessions[i];
+    }
+    return NULL;
+}
+
+// Move the (boot-time) pool into the ring as the next session. The caller
+// saves the index.
+static void fyHistAppendPool(uint32_t startEpoch) {
+    if (fyDetCount == 0) return;
+    uint32_t n = fyDetCount;
+    if (n > fyHistBytes / sizeof(FYSessionRecord)) n = fyHistBytes / sizeof(FYSessionRecord);
+    if (n == 0) return;
+    uint32_t bytes = n * sizeof(FYSessionRecord);
+    uint32_t off = (fyHist.head + bytes > fyHistBytes) ? 0 : fyHist.head;
+
+    // Drop sessions the new one overwrites, those past the end of a ring that
+    // has shrunk, and the oldest if the index is full
+    uint32_t keep = 0;
+    for (uint32_t i = 0; i < fyHist.count; i++) {
+        const FYHistSession& h = fyHist.sessions[i];
+        uint32_t end = h.offset + h.detections * sizeof(FYSessionRecord);
+        if (h.offset < off + bytes && off < end) continue;
+        if (end > fyHistBytes) continue;
+        fyHist.sessions[keep++] = h;
+    }
+    if (keep == FY_HIST_SESSIONS) {
+        memmove(&fyHist.sessions[0], &fyHist.sessions[1], (keep - 1) * sizeof(FYHistSession));
+        keep--;
+    }
+    fyHist.count = keep;
+
+    File f = SPIFFS.exists(FY_HIST_DATA) ? SPIFFS.open(FY_HIST_DATA, "r+")
+                                          : SPIFFS.open(FY_HIST_DATA, "w");
+    if (!f || !f.seek(off)) {
+        printf("[FLOCK-YOU] History data file unavailable\n");
         return;
     }
 
-    // Write to prev_session (overwrite any existing)
-    File dst = SPIFFS.open(FY_PREV_FILE, "w");
-    if (!dst) {
-        printf("[FLOCK-YOU] Failed to create prev_session file\n");
+    // Most recently seen first; a session larger than the ring keeps its newest
+    uint32_t written = 0, spanS = 0;
+    uint16_t slot = fyLruHead;
+    while (written < n && slot != FY_SLOT_NONE) {
+        int k = 0;
+        while (k < FY_REC_BATCH && written + k < n && slot != FY_SLOT_NONE) {
+            if (fyDet[slot].lastSeen / 1000 > spanS) spanS = fyDet[slot].lastSeen / 1000;
+            fyRecordFromDetection(fyDet[slot], fyRecBatch[k++]);
+            slot = fyLruNext[slot];
+        }
+        size_t put = f.write((const uint8_t*)fyRecBatch, k * sizeof(FYSessionRecord));
+        written += put / sizeof(FYSessionRecord);
+        if (put != k * sizeof(FYSessionRecord)) break;
+    }
+    f.close();
+    if (written == 0) return;
+
+    FYHistSession& h = fyHist.sessions[fyHist.count++];
+    memset(&h, 0, sizeof(h));
+    h.id = fyHist.nextId++;
+    h.startEpoch = startEpoch;
+    h.spanS = spanS;
+    h.detections = written;
+    h.offset = off;
+    fyHist.head = off + written * sizeof(FYSessionRecord);
+    printf("[FLOCK-YOU] Session #%u archived: %u detections at offset %u (%u sessions kept)\n",
+           (unsigned)h.id, (unsigned)written, (unsigned)off, (unsigned)fyHist.count);
+}
+
+// A ring that got smaller (a new storage plan) still has its old file
+// size, since SPIFFS files can't be truncated: copy the part still in use
+// and drop the sessions past the end. Boot only, after the session log is
+// gone so the copy has room.
+static void fyHistShrink() {
+    File src = SPIFFS.open(FY_HIST_DATA, "r");
+    if (!src) return;
+    if (src.size() <= fyHistBytes) { src.close(); return; }
+
+    uint32_t keep = 0;
+    for (uint32_t i = 0; i < fyHist.count; i++) {
+        const FYHistSession& h = fyHist.sessions[i];
+        if (h.offset + h.detections * sizeof(FYSessionRecord) <= fyHistBytes) fyHist.sessions[keep++] = h;
+    }
+    fyHist.count = keep;
+    if (fyHist.head > fyHistBytes) fyHist.head = 0;
+
+    File dst = SPIFFS.open(FY_HIST_DATA_TMP, "w");
+    bool ok = dst;
+    for (uint32_t done = 0; ok && done < fyHistBytes; ) {
+        size_t n = fyHistBytes - done < sizeof(fyRecBatch) ? fyHistBytes - done : sizeof(fyRecBatch);
+        n = src.read((uint8_t*)fyRecBatch, n);
+        if (n == 0) break;
+        ok = dst.write((const uint8_t*)fyRecBatch, n) == n;
+        done += n;
+    }
+    src.close();
+    if (dst) dst.close();
+    if (ok) {
+        SPIFFS.remove(FY_HIST_DATA);
+        ok = SPIFFS.rename(FY_HIST_DATA_TMP, FY_HIST_DATA);
+    }
+    if (!ok) {
+        SPIFFS.remove(FY_HIST_DATA_TMP);
+        printf("[FLOCK-YOU] History ring resize failed\n");
         return;
     }
-    dst.print(data);
-    dst.close();
+    printf("[FLOCK-YOU] History ring cut to %u KB, %u sessions kept\n",
+           (unsigned)(fyHistBytes / 1024), (unsigned)keep);
+}
+
+// SPIFFS File as a read callback (fy_json_split.h, fy_record.h)
+static size_t fyFileRead(void* ctx, uint8_t* buf, size_t len) {
+    return ((File*)ctx)->read(buf, len);
+}
+
+// Older firmware kept sessions as a JSON array; bring one in as a session
+static void fyImportLegacyJSON(const char* path) {
+    if (!SPIFFS.exists(path)) return;
+    File src = SPIFFS.open(path, "r");
+    if (src) {
+        FYJsonSplitter* split = (FYJsonSplitter*)calloc(1, sizeof(FYJsonSplitter));
+        if (split) {
+            split->read = fyFileRead;
+            split->ctx = &src;
+            JsonDocument doc;
+            while (fyJsonNextObject(*split)) {
+                if (deserializeJson(doc, split->obj, split->objLen)) {
+                    split->skipped++;
+                    continue;
+                }
+                JsonObject o = doc.as<JsonObject>();
+                FYDetection d;
+                memset(&d, 0, sizeof(d));
+                unsigned m[6];
+                const char* mac = o["mac"] | "";
+                if (sscanf(mac, "%x:%x:%x:%x:%x:%x", &m[0], &m[1], &m[2], &m[3], &m[4], &m[5]) != 6) continue;
+                for (int i = 0; i < 6; i++) d.macKey = (d.macKey << 8) | (m[i] & 0xFF);
+                strncpy(d.mac, mac, sizeof(d.mac) - 1);
+                strncpy(d.name, o["name"] | "", sizeof(d.name) - 1);
+                d.rssi = o["rssi"] | 0;
+                strncpy(d.method, o["method"] | "", sizeof(d.method) - 1);
+                // Old sessions stopped at the first method that matched
+                for (int k = 0; k < FY_SIG_COUNT; k++) {
+                    if (strcmp(d.method, fy_signals[k].method) == 0) d.signals = FY_SIG_BIT(k);
+                }
+                d.firstSeen = o["first"] | 0UL;
+                d.lastSeen = o["last"] | 0UL;
+                d.count = o["count"] | 1;
+                d.isRaven = o["raven"] | false;
+                strncpy(d.ravenFW, o["fw"] | "", sizeof(d.ravenFW) - 1);
+                JsonObject gps = o["gps"];
+                if (gps && gps.containsKey("lat")) {
+                    d.hasGPS = true;
+                    d.gpsLat = gps["lat"] | 0.0;
+                    d.gpsLon = gps["lon"] | 0.0;
+                    d.gpsAcc = gps["acc"] | 0.0f;
+                }
+                fyRestoreDetection(d);
+            }
+            if (split->skipped) {
+                printf("[FLOCK-YOU] Legacy %s: skipped %u malformed entries\n",
+                       path, (unsigned)split->skipped);
+            }
+            free(split);
+        }
+        src.close();
+    }
+    printf("[FLOCK-YOU] Imported legacy %s: %d detections\n", path, fyDetCount);
+    fyHistAppendPool(0);
+    fyClearDetections();
+    SPIFFS.remove(path);
+}
+
+static void fyReplayRecord(void*, const FYSessionRecord& r) {
+    FYDetection d;
+    fyRecordToDetection(r, d);
+    fyRestoreDetection(d);
+}
+
+// Replay the last session's log into the (still empty) pool and archive it,
+// then reserve the next id for the session starting now. Runs once in setup().
+static void fyPromotePrevSession() {
+    if (!fySpiffsReady || !fyDet) return;
+    fyHistLoad();
+    fyImportLegacyJSON(FY_LEGACY_PREV_FILE);
+    fyImportLegacyJSON(FY_LEGACY_SESSION_FILE);
+
+    // A compaction interrupted after the old file was removed leaves only tmp
+    const char* path = SPIFFS.exists(FY_SESSION_FILE) ? FY_SESSION_FILE :
+                       SPIFFS.exists(FY_SESSION_TMP) ? FY_SESSION_TMP : NULL;
+    File src = path ? SPIFFS.open(path, "r") : File();
+    if (src) {
+        uint32_t records = fyRecordReplay(fyFileRead, &src, fyReplayRecord, NULL);
+        size_t tail = src.size() - records * sizeof(FYSessionRecord);
+        src.close();
+        if (tail > 0) {
+            printf("[FLOCK-YOU] Session log: ignored %u bytes after record %u (torn write)\n",
+                   (unsigned)tail, (unsigned)records);
+        }
+        printf("[FLOCK-YOU] Prior session: %d detections from %u records\n",
+               fyDetCount, (unsigned)records);
+        fyHistAppendPool(fyHist.liveEpoch);
+    } else {
+        printf("[FLOCK-YOU] No prior session file to promote\n");
+    }
 
-    // Delete the old session file so it doesn't get re-promoted next boot
+    // Delete the log so it doesn't get re-promoted next boot
     SPIFFS.remove(FY_SESSION_FILE);
-    printf("[FLOCK-YOU] Prior session promoted: %d bytes\n", data.length());
+    SPIFFS.remove(FY_SESSION_TMP);
+    fyClearDetections();
+    fyDetEvicted = 0;
+    fyHistShrink();
+
+    fyHist.liveEpoch = 0;
+    fyHistSave();
+}
+
+// Print into a fixed buffer. Output that does not fit is dropped and
+// flagged in overflow, never written past cap.
+class FYBufPrint : public Print {
+public:
+    FYBufPrint(char* buf, size_t cap) : buf(buf), cap(cap), len(0), overflow(false) {}
+    size_t write(uint8_t c) override {
+        if (len >= cap) { overflow = true; return 0; }
+        buf[len++] = (char)c;
+        return 1;
+    }
+    size_t write(const uint8_t* data, size_t n) override {
+        if (n > cap - len) { n = cap - len; overflow = true; }
+        memcpy(buf + len, data, n);
+        len += n;
+        return n;
+    }
+    char* buf;
+    size_t cap;
+    size_t len;
+    bool overflow;
+};
+
+// A truncated chunk would leave malformed JSON/XML in the middle of a
+// response, so the cursors end the response there instead and say why
+static bool fyChunkFits(const FYBufPrint& out, const char* what) {
+    if (!out.overflow) return true;
+    Serial.printf("[FLOCK-YOU] %s: output chunk exceeds %u bytes, response cut short\n",
+                  what, (unsigned)out.cap);
+    return false;
+}
+
+#define FY_HIST_JSON 0
+#define FY_HIST_KML  1
+
+// One /api/history response: walks the selected sessions record by record,
+// so a response never needs more than one formatted record in RAM
+struct FYHistCursor {
+    int format;
+    bool range;
+    uint32_t from, to;                  // Unix time, when range
+    FYHistSession sessions[FY_HIST_SESSIONS];
+    uint32_t count;
+    uint32_t si, ri;                    // Current session / record
+    File f;
+    int stage;                          // 0 header, 1 records, 2 footer, 3 done
+    bool first;
+    char text[768];
+    size_t len, pos2;                   // Formatted bytes / bytes sent
+};
+
+// Format the next chunk of output into c.text. Returns false at the end.
+static bool fyHistNext(FYHistCursor& c) {
+    FYBufPrint out(c.text, sizeof(c.text));
+    c.pos2 = 0;
+    if (c.stage == 0) {
+        if (c.format == FY_HIST_KML) {
+            fyPrintKMLHeader(out, "Flock-You Session History",
+                             "Surveillance device detections from prior sessions");
+        } else {
+            out.print("[");
+        }
+        c.stage = 1;
+    }
+    while (c.stage == 1 && out.len == 0) {
+        if (c.si >= c.count) { c.stage = 2; break; }
+        const FYHistSession& h = c.sessions[c.si];
+        if (c.ri >= h.detections) { c.si++; c.ri = 0; continue; }
+        FYSessionRecord r;
+        if (c.ri == 0 && !c.f.seek(h.offset)) { c.si++; continue; }
+        if (c.f.read((uint8_t*)&r, sizeof(r)) != sizeof(r)) { c.si++; c.ri = 0; continue; }
+        c.ri++;
+        if (!fyRecordValid(r)) continue;
+
+        FYDetection d;
+        fyRecordToDetection(r, d);
+        if (c.range && (h.startEpoch + d.lastSeen / 1000 < c.from ||
+                        h.startEpoch + d.firstSeen / 1000 > c.to)) continue;
+        if (c.format == FY_HIST_KML) {
+            if (!d.hasGPS) continue;
+            fyPrintPlacemarkKML(out, d);
+        } else {
+            if (!c.first) out.print(",");
+            fyPrintDetectionJSON(out, d, h.id, h.startEpoch);
+        }
+        c.first = false;
+    }
+    if (c.stage == 2) {
+        out.print(c.format == FY_HIST_KML ? "</Document>\n</kml>" : "]");
+        c.stage = 3;
+    } else if (c.stage == 3 && out.len == 0) {
+        return false;
+    }
+    if (!fyChunkFits(out, "history export")) return false;
+    c.len = out.len;
+    return true;
+}
+
+// Pick sessions from ?session=<id> or ?from=&to= (Unix seconds); by default
+// the most recent session. Returns false if nothing matches.
+static bool fyHistSelect(AsyncWebServerRequest *r, FYHistCursor& c) {
+    c.count = 0;
+    c.range = false;
+    if (r->hasParam("session")) {
+        const FYHistSession* h = fyHistFind(r->getParam("session")->value().toInt());
+        if (h) c.sessions[c.count++] = *h;
+    } else if (r->hasParam("from") || r->hasParam("to")) {
+        c.range = true;
+        c.from = r->hasParam("from") ? strtoul(r->getParam("from")->value().c_str(), NULL, 10) : 0;
+        c.to = r->hasParam("to") ? strtoul(r->getParam("to")->value().c_str(), NULL, 10) : UINT32_MAX;
+        // Sessions without a clock cannot be placed in time
+        for (uint32_t i = 0; i < fyHist.count; i++) {
+            const FYHistSession& h = fyHist.sessions[i];
+            if (h.startEpoch && h.startEpoch <= c.to && h.startEpoch + h.spanS >= c.from) {
+                c.sessions[c.count++] = h;
+            }
+        }
+    } else if (fyHist.count > 0) {
+        c.sessions[c.count++] = fyHist.sessions[fyHist.count - 1];
+    }
+    return c.count > 0;
+}
+
+// Chunked response fed by a cursor: next(c) formats the following piece into
+// c.text / c.len and returns false at the end. The cursor lives as long as
+// the response.
+template <typename Cursor>
+static void fySendCursor(AsyncWebServerRequest *r, const char* type, const char* attachment,
+                         std::shared_ptr<Cursor> c, bool (*next)(Cursor&)) {
+    AsyncWebServerResponse *resp = r->beginChunkedResponse(type,
+        [c, next](uint8_t *buf, size_t maxLen, size_t index) -> size_t {
+            size_t n = 0;
+            while (n < maxLen) {
+                if (c->pos2 == c->len && !next(*c)) break;
+                size_t k = c->len - c->pos2;
+                if (k > maxLen - n) k = maxLen - n;
+                memcpy(buf + n, c->text + c->pos2, k);
+                c->pos2 += k;
+                n += k;
+            }
+            return n;
+        });
+    if (attachment) {
+        resp->addHeader("Content-Disposition", String("attachment; filename=\"") + attachment + "\"");
+    }
+    r->send(resp);
+}
+
+static void fyHistRespond(AsyncWebServerRequest *r, int format, const char* attachment) {
+    std::shared_ptr<FYHistCursor> c(new FYHistCursor());
+    c->format = format;
+    if (!fySpiffsReady || !fyHistSelect(r, *c)) {
+        if (attachment) r->send(404, "application/json", "{\"error\":\"no matching session\"}");
+        else r->send(200, "application/json", "[]");
+        return;
+    }
+    c->f = SPIFFS.open(FY_HIST_DATA, "r");
+    c->first = true;
+    fySendCursor(r, format == FY_HIST_KML ? "application/vnd.google-earth.kml+xml" : "application/json",
+                 attachment, c, fyHistNext);
 }
 
 // ============================================================================
-// KML EXPORT
+// EXPORT SNAPSHOTS
 // ============================================================================
+// Live exports are never formatted under fyMutex. The pool (or, for a
+// delta, what changed) is packed into an immutable snapshot of
+// FYSessionRecords plus the interval statistics, and the response is
+// streamed from it by a cursor while the BLE callback keeps adding
+// detections. Packing takes FY_SNAP_BATCH records per fyMutex hold, so the
+// lock is never held for longer than one batch whatever the pool size.
+//
+// Between holds the pool moves on: a record is always copied whole, but one
+// that changes during the copy may appear in either state, and the
+// snapshot's seq is taken before the first batch so a delta client that
+// continues from it is sent those records again. A copy that saw an
+// eviction or clear (which can move a device to a later slot) is retried.
+// A copy during which nothing changed is kept as the current generation:
+// repeated and concurrent downloads of an unchanged pool copy nothing, and
+// a response holds on to its generation until it has been sent.
+
+#define FY_SNAP_JSON  0
+#define FY_SNAP_DELTA 1
+#define FY_SNAP_CSV   2
+#define FY_SNAP_KML   3
+
+#define FY_SNAP_BATCH 64    // Records packed per fyMutex hold
+#define FY_SNAP_TRIES 3     // Copies attempted before one that saw an eviction is accepted
+#define FY_DELTA_MAX  128   // Changes a delta packs in a single hold
+
+struct FYSnapEntry {
+    FYSessionRecord rec;        // Unsealed (no CRC)
+    AdvInterval adv;            // Not kept on flash
+};
+
+static void fySnapPack(const FYDetection& d, FYSnapEntry& e) {
+    fyRecordFromDetection(d, e.rec, false);
+    e.adv = d.adv;
+}
 
-static void writeDetectionsKML(AsyncResponseStream *resp) {
-    resp->print("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
-                "<kml xmlns=\"http://www.opengis.net/kml/2.2\">\n<Document>\n"
-                "<name>Flock-You Detections</name>\n"
-                "<description>Surveillance device detections with GPS</description>\n");
+struct FYSnapshot {
+    uint32_t boot;
+    uint32_t seq;               // fyDetSeq before the copy started
+    bool full;                  // Whole pool, not just changes
+    FYSnapEntry* recs;
+    uint32_t count;
+    ~FYSnapshot() { heap_caps_free(recs); }
+};
 
-    // Detection pin style
-    resp->print("<Style id=\"det\"><IconStyle><color>ff4489ec</color>"
-                "<scale>1.0</scale></IconStyle></Style>\n"
-                "<Style id=\"raven\"><IconStyle><color>ff4444ef</color>"
-                "<scale>1.2</scale></IconStyle></Style>\n");
-
-    if (fyMutex && xSemaphoreTake(fyMutex, pdMS_TO_TICKS(300)) == pdTRUE) {
-        for (int i = 0; i < fyDetCount; i++) {
-            FYDetection& d = fyDet[i];
-            if (!d.hasGPS) continue;  // Skip detections without GPS
-            resp->print("<Placemark>\n");
-            resp->printf("<name>%s</name>\n", d.mac);
-            resp->printf("<styleUrl>#%s</styleUrl>\n", d.isRaven ? "raven" : "det");
-            resp->print("<description><![CDATA[");
-            if (d.name[0]) resp->printf("<b>Name:</b> %s<br/>", d.name);
-            resp->printf("<b>Method:</b> %s<br/>"
-                         "<b>RSSI:</b> %d dBm<br/>"
-                         "<b>Count:</b> %d<br/>",
-                         d.method, d.rssi, d.count);
-            if (d.isRaven) resp->printf("<b>Raven FW:</b> %s<br/>", d.ravenFW);
-            resp->printf("<b>Accuracy:</b> %.1f m", d.gpsAcc);
-            resp->print("]]></description>\n");
-            resp->printf("<Point><coordinates>%.8f,%.8f,0</coordinates></Point>\n",
-                         d.gpsLon, d.gpsLat);
-            resp->print("</Placemark>\n");
+static std::shared_ptr<FYSnapshot> fySnap;   // Current whole-pool generation
+
+// Room for `cap` records. NULL when there is no memory for the copy.
+static FYSnapshot* fySnapNew(uint32_t cap, uint32_t boot, uint32_t seq, bool full) {
+    FYSnapEntry* recs = NULL;
+    if (cap) {
+        size_t bytes = cap * sizeof(FYSnapEntry);
+        recs = (FYSnapEntry*)heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (!recs) recs = (FYSnapEntry*)heap_caps_malloc(bytes, MALLOC_CAP_8BIT);
+        if (!recs) return NULL;
+    }
+    FYSnapshot* snap = new FYSnapshot();
+    snap->boot = boot;
+    snap->seq = seq;
+    snap->full = full;
+    snap->recs = recs;
+    snap->count = 0;
+    return snap;
+}
+
+// Pack the slots changed after `since` (all of them for since = 0) into s,
+// in slot order, up to the room allocated for `cap` records. Slots added
+// beyond that are newer than s->seq and left for the next delta. Returns
+// false if the pool stayed busy; `clean` tells whether nothing changed and
+// `evicted` whether anything was removed while copying.
+static bool fySnapFill(FYSnapshot* s, uint32_t cap, uint32_t since, bool& clean, bool& evicted) {
+    uint32_t removedSeq = 0;
+    for (uint32_t slot = 0;;) {
+        if (xSemaphoreTake(fyMutex, pdMS_TO_TICKS(200)) != pdTRUE) return false;
+        if (slot == 0) removedSeq = fyDetRemovedSeq;
+        uint32_t end = min(cap, (uint32_t)fyDetCount);
+        for (int n = 0; n < FY_SNAP_BATCH && slot < end; n++, slot++) {
+            if (fyDet[slot].seq > since) fySnapPack(fyDet[slot], s->recs[s->count++]);
+        }
+        bool done = slot >= end;
+        if (done) {
+            clean = fyDetSeq == s->seq;
+            evicted = fyDetRemovedSeq != removedSeq;
+        }
+        xSemaphoreGive(fyMutex);
+        if (done) return true;
+    }
+}
+
+// The whole pool in slot order. NULL if the pool is busy or out of memory.
+static std::shared_ptr<FYSnapshot> fySnapshotAll() {
+    std::shared_ptr<FYSnapshot> snap;
+    if (!fyMutex || !fyDet) return snap;
+    for (int attempt = 1; attempt <= FY_SNAP_TRIES; attempt++) {
+        if (xSemaphoreTake(fyMutex, pdMS_TO_TICKS(200)) != pdTRUE) return snap;
+        if (fySnap && fySnap->seq == fyDetSeq) {
+            snap = fySnap;
+            xSemaphoreGive(fyMutex);
+            return snap;
+        }
+        uint32_t cap = fyDetCount, boot = fyDetBootId, seq = fyDetSeq;
+        xSemaphoreGive(fyMutex);
+
+        FYSnapshot* s = fySnapNew(cap, boot, seq, true);
+        if (!s) return snap;
+        bool clean = false, evicted = false;
+        if (!fySnapFill(s, cap, 0, clean, evicted)) { delete s; return snap; }
+        if (evicted && attempt < FY_SNAP_TRIES) { delete s; continue; }
+
+        snap.reset(s);
+        if (clean && xSemaphoreTake(fyMutex, pdMS_TO_TICKS(200)) == pdTRUE) {
+            fySnap = snap;  // Responses still sending the old one keep their own reference
+            xSemaphoreGive(fyMutex);
+        }
+        break;
+    }
+    return snap;
+}
+
+// Detections changed after change sequence `since` of boot `boot`. A few
+// changes are packed newest first in one hold; more than FY_DELTA_MAX are
+// gathered by a batched slot scan instead. After a reboot, or when
+// something was evicted or cleared since then, the whole pool is sent with
+// "full":true and the client replaces its list.
+static std::shared_ptr<FYSnapshot> fySnapshotSince(uint32_t boot, uint32_t since) {
+    std::shared_ptr<FYSnapshot> snap;
+    if (!fyMutex || !fyDet || xSemaphoreTake(fyMutex, pdMS_TO_TICKS(200)) != pdTRUE) return snap;
+    bool full = boot != fyDetBootId || since < fyDetRemovedSeq || since > fyDetSeq;
+    if (full) {
+        xSemaphoreGive(fyMutex);
+        return fySnapshotAll();
+    }
+    uint32_t n = 0;
+    for (uint16_t slot = fyLruHead; slot != FY_SLOT_NONE && fyDet[slot].seq > since && n <= FY_DELTA_MAX;
+         slot = fyLruNext[slot]) n++;
+    if (n <= FY_DELTA_MAX) {
+        FYSnapshot* s = fySnapNew(n, fyDetBootId, fyDetSeq, false);
+        if (s) {
+            for (uint16_t slot = fyLruHead; s->count < n; slot = fyLruNext[slot]) {
+                fySnapPack(fyDet[slot], s->recs[s->count++]);
+            }
+            snap.reset(s);
         }
         xSemaphoreGive(fyMutex);
+        return snap;
+    }
+    uint32_t cap = fyDetCount, seq = fyDetSeq;
+    xSemaphoreGive(fyMutex);
+
+    FYSnapshot* s = fySnapNew(cap, fyDetBootId, seq, false);
+    if (!s) return snap;
+    bool clean, evicted;
+    if (!fySnapFill(s, cap, since, clean, evicted)) { delete s; return snap; }
+    snap.reset(s);
+    return snap;
+}
+
+static void fyPrintDetectionCSV(Print& out, const FYDetection& d) {
+    out.printf("\"%s\",\"%s\",%d,\"%s\",%lu,%lu,%d,%s,\"%s\",",
+        d.mac, d.name, d.rssi, d.method,
+        d.firstSeen, d.lastSeen, d.count,
+        d.isRaven ? "true" : "false", d.ravenFW);
+    if (d.hasGPS) {
+        out.printf("%.8f,%.8f,%.1f,", d.gpsLat, d.gpsLon, d.gpsAcc);
+    } else {
+        out.print(",,,");
+    }
+    if (d.estN) {
+        out.printf("%.8f,%.8f,%.1f,%u,", d.estLat, d.estLon, d.estR, (unsigned)d.estN);
+    } else {
+        out.print(",,,,");
+    }
+    if (d.signals) {
+        out.printf("%u,%u,", (unsigned)d.signals, (unsigned)fyScoreSignals(d.signals));
+    } else {
+        out.print(",,");
+    }
+    if (d.adv.n) {
+        out.printf("%.1f,%.1f,%u\n", d.adv.mean, advIntervalStddev(d.adv), (unsigned)d.adv.n);
+    } else {
+        out.print(",,\n");
+    }
+}
+
+struct FYSnapCursor {
+    int format;
+    std::shared_ptr<FYSnapshot> snap;
+    uint32_t i;                         // Next record
+    int stage;                          // 0 header, 1 records, 2 footer, 3 done
+    bool first;
+    char text[768];
+    size_t len, pos2;                   // Formatted bytes / bytes sent
+};
+
+static bool fySnapNext(FYSnapCursor& c) {
+    FYBufPrint out(c.text, sizeof(c.text));
+    const FYSnapshot& s = *c.snap;
+    c.pos2 = 0;
+    if (c.stage == 0) {
+        if (c.format == FY_SNAP_KML) {
+            fyPrintKMLHeader(out, "Flock-You Detections", "Surveillance device detections with GPS");
+        } else if (c.format == FY_SNAP_CSV) {
+            out.println("mac,name,rssi,method,first_seen_ms,last_seen_ms,count,is_raven,raven_fw,latitude,longitude,gps_accuracy,"
+                        "est_latitude,est_longitude,est_radius,est_fixes,signals,score,adv_mean_ms,adv_sd_ms,adv_gaps");
+        } else if (c.format == FY_SNAP_DELTA) {
+            out.printf("{\"boot\":%u,\"seq\":%u,\"full\":%s,\"detections\":[",
+                       (unsigned)s.boot, (unsigned)s.seq, s.full ? "true" : "false");
+        } else {
+            out.print("[");
+        }
+        c.stage = 1;
+    }
+    while (c.stage == 1 && out.len == 0) {
+        if (c.i >= s.count) { c.stage = 2; break; }
+        FYDetection d;
+        const FYSnapEntry& e = s.recs[c.i++];
+        fyRecordToDetection(e.rec, d);
+        d.adv = e.adv;
+        if (c.format == FY_SNAP_KML) {
+            if (!d.hasGPS) continue;  // Skip detections without GPS
+            fyPrintPlacemarkKML(out, d);
+        } else if (c.format == FY_SNAP_CSV) {
+            fyPrintDetectionCSV(out, d);
+        } else {
+            if (!c.first) out.print(",");
+            fyPrintDetectionJSON(out, d);
+        }
+        c.first = false;
+    }
+    if (c.stage == 2) {
+        if (c.format == FY_SNAP_KML) out.print("</Document>\n</kml>");
+        else if (c.format == FY_SNAP_DELTA) out.print("]}");
+        else if (c.format == FY_SNAP_JSON) out.print("]");
+        c.stage = 3;
+    } else if (c.stage == 3 && out.len == 0) {
+        return false;
+    }
+    if (!fyChunkFits(out, "detection export")) return false;
+    c.len = out.len;
+    return true;
+}
+
+static void fySnapRespond(AsyncWebServerRequest *r, int format, std::shared_ptr<FYSnapshot> snap,
+                          const char* attachment) {
+    if (!snap) {
+        r->send(503, "application/json", "{\"error\":\"busy\"}");
+        return;
+    }
+    std::shared_ptr<FYSnapCursor> c(new FYSnapCursor());
+    c->format = format;
+    c->snap = snap;
+    c->first = true;
+    const char* type = "application/json";
+    if (format == FY_SNAP_CSV) type = "text/csv";
+    else if (format == FY_SNAP_KML) type = "application/vnd.google-earth.kml+xml";
+    fySendCursor(r, type, attachment, c, fySnapNext);
+}
+
+// ============================================================================
+// TRACK LOG
+// ============================================================================
+// Position fixes (hardware GPS or phone) that move the unit at least
+// FY_TRACK_MIN_MOVE_M, or come FY_TRACK_IDLE_S after the last point, are kept
+// as a breadcrumb track in FY_TRACK_FILE, a ring of FY_TRACK_BLOCKS
+// delta-encoded blocks (fy_track.h). The block being filled lives in RAM
+// (loop() adds to it) and is rewritten in place at each checkpoint.
+
+#define FY_TRACK_FILE       "/track.bin"
+#define FY_TRACK_BLOCKS     256            // 128 KB, ~40000 points
+#define FY_TRACK_MIN_MOVE_M 10
+#define FY_TRACK_IDLE_S     300
+
+static FYTrackBlock fyTrackCur;            // Being filled, count 0 = none yet
+static uint32_t fyTrackIdx = 0;            // Ring slot of fyTrackCur
+static uint32_t fyTrackNextSeq = 1;
+static int32_t fyTrackLastLat = 0, fyTrackLastLon = 0;
+static uint32_t fyTrackLastT = 0;
+static unsigned long fyTrackLastFix = 0;   // FYFix.ms of the last fix looked at
+static bool fyTrackDirty = false;          // fyTrackCur changed since written
+static bool fyTrackReady = false;
+static SemaphoreHandle_t fyTrackMutex = NULL;  // fyTrackCur and file writes
+
+// Caller holds fyTrackMutex
+static void fyTrackWriteLocked() {
+    if (fyTrackCur.count == 0) return;
+    if (!fyTrackCur.bootEpoch) fyTrackCur.bootEpoch = fyEpochAtBoot;
+    fyTrackCur.crc = fyTrackCrc(fyTrackCur);
+    fyTrackDirty = false;
+
+    File f = SPIFFS.exists(FY_TRACK_FILE) ? SPIFFS.open(FY_TRACK_FILE, "r+")
+                                           : SPIFFS.open(FY_TRACK_FILE, "w");
+    if (!f) return;
+    uint32_t off = fyTrackIdx * FY_TRACK_BLOCK;
+    if (f.size() < off) {
+        // A failed write left a gap; fill it with (invalid) empty blocks
+        static const uint8_t zero[64] = {0};
+        f.seek(f.size());
+        for (size_t n = f.size(); n < off; n += sizeof(zero)) {
+            if (f.write(zero, sizeof(zero)) != sizeof(zero)) break;
+        }
+    }
+    if (!f.seek(off) || f.write((const uint8_t*)&fyTrackCur, sizeof(fyTrackCur)) != sizeof(fyTrackCur)) {
+        printf("[FLOCK-YOU] Track block %u write failed\n", (unsigned)fyTrackIdx);
+    }
+    f.close();
+}
+
+// Checkpoint from loop()
+static void fyTrackFlush() {
+    if (!fyTrackReady || !fyTrackDirty) return;
+    if (xSemaphoreTake(fyTrackMutex, pdMS_TO_TICKS(100)) != pdTRUE) return;
+    fyTrackWriteLocked();
+    xSemaphoreGive(fyTrackMutex);
+}
+
+// Find the newest block; the next session starts a block after it
+static void fyTrackInit() {
+    fyTrackMutex = xSemaphoreCreateMutex();
+    if (!fySpiffsReady || !fyTrackMutex) return;
+    uint32_t newest = 0, newestIdx = 0;
+    File f = SPIFFS.open(FY_TRACK_FILE, "r");
+    if (f) {
+        FYTrackBlock hdr;
+        uint32_t blocks = f.size() / FY_TRACK_BLOCK;
+        for (uint32_t i = 0; i < blocks && i < FY_TRACK_BLOCKS; i++) {
+            if (!f.seek(i * FY_TRACK_BLOCK) ||
+                f.read((uint8_t*)&hdr, offsetof(FYTrackBlock, data)) != offsetof(FYTrackBlock, data)) break;
+            if (hdr.magic == FY_TRACK_MAGIC && hdr.seq > newest) {
+                newest = hdr.seq;
+                newestIdx = i;
+            }
+        }
+        f.close();
+    }
+    memset(&fyTrackCur, 0, sizeof(fyTrackCur));
+    fyTrackNextSeq = newest + 1;
+    fyTrackIdx = newest ? (newestIdx + 1) % FY_TRACK_BLOCKS : 0;
+    fyTrackReady = true;
+    printf("[FLOCK-YOU] Track log: next block %u (seq %u)\n",
+           (unsigned)fyTrackIdx, (unsigned)fyTrackNextSeq);
+}
+
+// Called from loop(); looks at the latest published fix
+static void fyTrackSample() {
+    FYFix fix;
+    if (!fyTrackReady || !fyFreshFix(fix) || fix.ms == fyTrackLastFix) return;
+    fyTrackLastFix = fix.ms;
+
+    uint32_t t = fix.ms / 1000;
+    int32_t lat = (int32_t)lround(fix.lat * FY_TRACK_SCALE);
+    int32_t lon = (int32_t)lround(fix.lon * FY_TRACK_SCALE);
+    if (fyTrackCur.count > 0) {
+        if (t == fyTrackLastT) return;
+        float m = 111320.0f / FY_TRACK_SCALE;  // Metres per unit of latitude
+        float dy = (lat - fyTrackLastLat) * m;
+        float dx = (lon - fyTrackLastLon) * m * cosf(fix.lat * M_PI / 180.0);
+        if (dx * dx + dy * dy < FY_TRACK_MIN_MOVE_M * FY_TRACK_MIN_MOVE_M &&
+            t - fyTrackLastT < FY_TRACK_IDLE_S) return;
+    }
+    if (xSemaphoreTake(fyTrackMutex, pdMS_TO_TICKS(20)) != pdTRUE) return;
+
+    FYTrackBlock& b = fyTrackCur;
+    if (!fyTrackBlockAppend(b, t - fyTrackLastT, lat - fyTrackLastLat, lon - fyTrackLastLon)) {
+        if (b.count > 0) {
+            fyTrackWriteLocked();
+            fyTrackIdx = (fyTrackIdx + 1) % FY_TRACK_BLOCKS;
+        }
+        fyTrackBlockStart(b, fyTrackNextSeq++, fyHist.nextId, t, lat, lon);
+    }
+    fyTrackDirty = true;
+    xSemaphoreGive(fyTrackMutex);
+
+    fyTrackLastT = t;
+    fyTrackLastLat = lat;
+    fyTrackLastLon = lon;
+}
+
+// Unix time of a block's boot: the history index knows it once the clock
+// was set, even for blocks written before that
+static uint32_t fyTrackEpoch(const FYTrackBlock& b) {
+    if (b.session == fyHist.nextId) return fyEpochAtBoot;
+    const FYHistSession* h = fyHistFind(b.session);
+    return (h && h->startEpoch) ? h->startEpoch : b.bootEpoch;
+}
+
+#define FY_TRACK_GPX 0
+#define FY_TRACK_KML 1
+
+// One /api/track export: blocks oldest first, one point per chunk of text.
+// Each recording session becomes a GPX track segment / KML line.
+struct FYTrackCursor {
+    int format;
+    uint32_t session;                   // 0 = all
+    File f;
+    uint32_t start, step;               // Ring walk from the oldest slot
+    uint32_t lastSeq;                   // Guards against blocks rewritten mid-export
+    FYTrackBlock b;
+    FYTrackReader rd;                   // Position in b
+    uint32_t epoch;
+    uint32_t segSession;                // 0 = no segment open
+    int stage;                          // 0 header, 1 points, 2 done
+    char text[768];                     // KML header alone is ~380 bytes
+    size_t len, pos2;
+};
+
+static bool fyTrackNextBlock(FYTrackCursor& c) {
+    while (c.step < FY_TRACK_BLOCKS) {
+        uint32_t idx = (c.start + c.step++) % FY_TRACK_BLOCKS;
+        if (!c.f.seek(idx * FY_TRACK_BLOCK) ||
+            c.f.read((uint8_t*)&c.b, sizeof(c.b)) != sizeof(c.b)) continue;
+        if (!fyTrackValid(c.b) || c.b.seq <= c.lastSeq) continue;
+        if (c.session && c.b.session != c.session) continue;
+        c.lastSeq = c.b.seq;
+        memset(&c.rd, 0, sizeof(c.rd));
+        c.epoch = fyTrackEpoch(c.b);
+        return true;
+    }
+    return false;
+}
+
+static bool fyTrackNextPoint(FYTrackCursor& c) {
+    for (;;) {
+        if (c.b.magic == FY_TRACK_MAGIC && fyTrackBlockNext(c.b, c.rd)) return true;
+        c.b.magic = 0;
+        if (!fyTrackNextBlock(c)) return false;
+    }
+}
+
+static bool fyTrackNext(FYTrackCursor& c) {
+    FYBufPrint out(c.text, sizeof(c.text));
+    c.pos2 = 0;
+    if (c.stage == 0) {
+        if (c.format == FY_TRACK_KML) {
+            fyPrintKMLHeader(out, "Flock-You Track", "Route recorded by the Flock-You GPS track log");
+        } else {
+            out.print("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                      "<gpx version=\"1.1\" creator=\"Flock-You\" "
+                      "xmlns=\"http://www.topografix.com/GPX/1/1\">\n"
+                      "<trk><name>Flock-You Track</name>\n");
+        }
+        c.stage = 1;
+    } else if (c.stage == 1) {
+        bool more = fyTrackNextPoint(c);
+        const char* close = c.format == FY_TRACK_KML ? "</coordinates></LineString></Placemark>\n"
+                                                     : "</trkseg>\n";
+        if (c.segSession && (!more || c.b.session != c.segSession)) {
+            out.print(close);
+            c.segSession = 0;
+        }
+        if (!more) {
+            out.print(c.format == FY_TRACK_KML ? "</Document>\n</kml>" : "</trk>\n</gpx>\n");
+            c.stage = 2;
+        } else {
+            if (!c.segSession) {
+                c.segSession = c.b.session;
+                if (c.format == FY_TRACK_KML) {
+                    out.printf("<Placemark><name>Session #%u</name><LineString>"
+                               "<tessellate>1</tessellate><coordinates>\n", (unsigned)c.segSession);
+                } else {
+                    out.print("<trkseg>\n");
+                }
+            }
+            double lat = c.rd.lat / FY_TRACK_SCALE, lon = c.rd.lon / FY_TRACK_SCALE;
+            if (c.format == FY_TRACK_KML) {
+                out.printf("%.5f,%.5f,0\n", lon, lat);
+            } else if (c.epoch) {
+                char when[24];
+                fyFormatUTC(c.epoch + c.rd.t, when, sizeof(when));
+                out.printf("<trkpt lat=\"%.5f\" lon=\"%.5f\"><time>%s</time></trkpt>\n", lat, lon, when);
+            } else {
+                out.printf("<trkpt lat=\"%.5f\" lon=\"%.5f\"/>\n", lat, lon);
+            }
+        }
+    } else {
+        return false;
+    }
+    if (!fyChunkFits(out, "track export")) return false;
+    c.len = out.len;
+    return true;
+}
+
+// ?session=<id> limits the export to one session
+static void fyTrackRespond(AsyncWebServerRequest *r, int format) {
+    std::shared_ptr<FYTrackCursor> c(new FYTrackCursor());
+    c->format = format;
+    c->session = r->hasParam("session") ? r->getParam("session")->value().toInt() : 0;
+    c->b.magic = 0;
+    if (fyTrackReady && xSemaphoreTake(fyTrackMutex, pdMS_TO_TICKS(200)) == pdTRUE) {
+        fyTrackWriteLocked();  // Include the block being filled
+        c->start = (fyTrackIdx + 1) % FY_TRACK_BLOCKS;
+        xSemaphoreGive(fyTrackMutex);
+        c->f = SPIFFS.open(FY_TRACK_FILE, "r");
+    }
+    if (!c->f) c->step = FY_TRACK_BLOCKS;
+    if (format == FY_TRACK_KML) {
+        fySendCursor(r, "application/vnd.google-earth.kml+xml", "flockyou_track.kml", c, fyTrackNext);
+    } else {
+        fySendCursor(r, "application/gpx+xml", "flockyou_track.gpx", c, fyTrackNext);
+    }
+}
+
+// ============================================================================
+// LIVE EVENTS (SSE)
+// ============================================================================
+// /api/events pushes one "det" event (a detection JSON line, id = its change
+// sequence) per new or updated detection. loop() picks changes up through
+// the same sequence /api/detections?since= uses, so the BLE callback never
+// formats or sends anything, and several sightings of one device between
+// passes go out once. Each client's queue is capped by the server library
+// (SSE_MAX_QUEUED_MESSAGES); a slow client loses events rather than holding
+// anything up. Bursts larger than FY_EVENT_BURST, evictions and clears send
+// a single "reset" event instead, and the dashboard re-syncs with the delta
+// feed (which it also polls slowly as a backstop for dropped events).
+
+#define FY_EVENT_BURST 16
+
+static uint32_t fyEventSeq = 0;            // Last change sequence pushed
+static FYDetection fyEventBuf[FY_EVENT_BURST];
+
+static void fyPushEvents() {
+    uint32_t seq = fyDetSeq;
+    if (seq == fyEventSeq) return;
+    if (fyEvents.count() == 0) {
+        fyEventSeq = seq;
+        return;
+    }
+    if (!fyMutex || xSemaphoreTake(fyMutex, pdMS_TO_TICKS(20)) != pdTRUE) return;
+    int n = 0;
+    bool reset = fyDetRemovedSeq > fyEventSeq;
+    for (uint16_t slot = fyLruHead; !reset && slot != FY_SLOT_NONE; slot = fyLruNext[slot]) {
+        if (fyDet[slot].seq <= fyEventSeq) break;
+        if (n == FY_EVENT_BURST) reset = true;
+        else fyEventBuf[n++] = fyDet[slot];
+    }
+    seq = fyDetSeq;
+    xSemaphoreGive(fyMutex);
+    fyEventSeq = seq;
+
+    char line[768];
+    if (reset) {
+        snprintf(line, sizeof(line), "{\"boot\":%u,\"seq\":%u}", (unsigned)fyDetBootId, (unsigned)seq);
+        fyEvents.send(line, "reset", seq);
+        return;
+    }
+    // Oldest change first
+    for (int i = n - 1; i >= 0; i--) {
+        FYBufPrint out(line, sizeof(line) - 1);
+        fyPrintDetectionJSON(out, fyEventBuf[i]);
+        if (!fyChunkFits(out, "live event")) continue;
+        line[out.len] = '\0';
+        fyEvents.send(line, "det", fyEventBuf[i].seq);
     }
-    resp->print("</Document>\n</kml>");
 }
 
 // ============================================================================
 // DASHBOARD HTML
 // ============================================================================
 
-static const char FY_HTML[] PROGMEM = R"rawliteral(
-<!DOCTYPE html><html><head><meta charset="utf-8">
-<meta name="viewport" content="width=device-width,initial-scale=1,maximum-scale=1,user-scalable=no">
-<title>FLOCK-YOU</title>
-<style>
-*{margin:0;padding:0;box-sizing:border-box}
-html,body{height:100%;overflow:hidden}
-body{font-family:'Courier New',monospace;background:#0a0012;color:#e0e0e0;display:flex;flex-direction:column}
-.hd{background:#1a0033;padding:10px 14px;border-bottom:2px solid #ec4899;flex-shrink:0}
-.hd h1{font-size:22px;color:#ec4899;letter-spacing:3px}
-.hd .sub{font-size:11px;color:#8b5cf6;margin-top:2px}
-.st{display:flex;gap:8px;padding:8px 12px;background:rgba(139,92,246,.08);border-bottom:1px solid rgba(139,92,246,.19);flex-shrink:0}
-.sc{flex:1;text-align:center;padding:6px;border:1px solid rgba(139,92,246,.25);border-radius:5px}
-.sc .n{font-size:22px;font-weight:bold;color:#ec4899}
-.sc .l{font-size:10px;color:#8b5cf6;margin-top:2px}
-.tb{display:flex;border-bottom:1px solid #8b5cf6;flex-shrink:0}
-.tb button{flex:1;padding:9px;text-align:center;cursor:pointer;color:#8b5cf6;border:none;background:none;font-family:inherit;font-size:13px;font-weight:bold;letter-spacing:1px}
-.tb button.a{color:#ec4899;border-bottom:2px solid #ec4899;background:rgba(236,72,153,.08)}
-.cn{flex:1;overflow-y:auto;padding:10px}
-.pn{display:none}.pn.a{display:block}
-.det{background:rgba(45,27,105,.4);border:1px solid rgba(139,92,246,.25);border-radius:7px;padding:10px;margin-bottom:8px}
-.det .mac{color:#ec4899;font-weight:bold;font-size:14px}
-.det .nm{color:#c084fc;font-size:13px;margin-left:4px}
-.det .inf{display:flex;flex-wrap:wrap;gap:5px;margin-top:5px;font-size:12px}
-.det .inf span{background:rgba(139,92,246,.15);padding:3px 6px;border-radius:4px}
-.det .rv{background:rgba(239,68,68,.15)!important;color:#ef4444;font-weight:bold}
-.pg{margin-bottom:12px}
-.pg h3{color:#ec4899;font-size:14px;margin-bottom:4px;border-bottom:1px solid rgba(139,92,246,.19);padding-bottom:4px}
-.pg .it{display:flex;flex-wrap:wrap;gap:4px;font-size:12px}
-.pg .it span{background:rgba(139,92,246,.15);padding:3px 6px;border-radius:4px;border:1px solid rgba(139,92,246,.12)}
-.btn{display:block;width:100%;padding:10px;margin-bottom:8px;background:#8b5cf6;color:#fff;border:none;border-radius:5px;cursor:pointer;font-family:inherit;font-size:14px;font-weight:bold}
-.btn:active{background:#ec4899}
-.btn.dng{background:#ef4444}
-.empty{text-align:center;color:rgba(139,92,246,.5);padding:28px;font-size:14px}
-.sep{border:none;border-top:1px solid rgba(139,92,246,.12);margin:12px 0}
-h4{color:#ec4899;font-size:14px;margin-bottom:8px}
-</style></head><body>
-<div class="hd"><h1>FLOCK-YOU</h1><div class="sub">Surveillance Device Detector &bull; Wardriving + GPS</div></div>
-<div class="st">
-<div class="sc"><div class="n" id="sT">0</div><div class="l">DETECTED</div></div>
-<div class="sc"><div class="n" id="sR">0</div><div class="l">RAVEN</div></div>
-<div class="sc"><div class="n" id="sB">ON</div><div class="l">BLE</div></div>
-<div class="sc" onclick="reqGPS()" style="cursor:pointer"><div class="n" id="sG" style="font-size:14px">TAP</div><div class="l" id="sGL">GPS</div></div>
-</div>
-<div class="tb">
-<button class="a" onclick="tab(0,this)">LIVE</button>
-<button onclick="tab(1,this)">PREV</button>
-<button onclick="tab(2,this)">DB</button>
-<button onclick="tab(3,this)">TOOLS</button>
-</div>
-<div class="cn">
-<div class="pn a" id="p0">
-<div id="dL"><div class="empty">Scanning for surveillance devices...<br>BLE active on all channels</div></div>
-</div>
-<div class="pn" id="p1"><div id="hL"><div class="empty">Loading prior session...</div></div></div>
-<div class="pn" id="p2"><div id="pC">Loading patterns...</div></div>
-<div class="pn" id="p3">
-<h4>EXPORT DETECTIONS</h4>
-<p style="font-size:10px;color:#8b5cf6;margin-bottom:8px">Download current session to import into Flask dashboard</p>
-<button class="btn" onclick="location.href='/api/export/json'">DOWNLOAD JSON</button>
-<button class="btn" onclick="location.href='/api/export/csv'">DOWNLOAD CSV</button>
-<button class="btn" onclick="location.href='/api/export/kml'" style="background:#22c55e">DOWNLOAD KML (GPS MAP)</button>
-<hr class="sep">
-<h4>PRIOR SESSION</h4>
-<button class="btn" onclick="location.href='/api/history/json'" style="background:#6366f1">DOWNLOAD PREV JSON</button>
-<button class="btn" onclick="location.href='/api/history/kml'" style="background:#22c55e">DOWNLOAD PREV KML</button>
-<hr class="sep">
-<button class="btn dng" onclick="if(confirm('Clear all detections?'))fetch('/api/clear').then(()=>refresh())">CLEAR ALL DETECTIONS</button>
-</div>
-</div>
-<script>
-let D=[],H=[];
-function tab(i,el){document.querySelectorAll('.tb button').forEach(b=>b.classList.remove('a'));document.querySelectorAll('.pn').forEach(p=>p.classList.remove('a'));el.classList.add('a');document.getElementById('p'+i).classList.add('a');if(i===1&&!window._hL)loadHistory();if(i===2&&!window._pL)loadPat();}
-function refresh(){fetch('/api/detections').then(r=>r.json()).then(d=>{D=d;render();stats();}).catch(()=>{});}
-function render(){const el=document.getElementById('dL');if(!D.length){el.innerHTML='<div class="empty">Scanning for surveillance devices...<br>BLE active on all channels</div>';return;}
-D.sort((a,b)=>b.last-a.last);el.innerHTML=D.map(card).join('');}
-function stats(){document.getElementById('sT').textContent=D.length;document.getElementById('sR').textContent=D.filter(d=>d.raven).length;
-fetch('/api/stats').then(r=>r.json()).then(s=>{let g=document.getElementById('sG'),gl=document.getElementById('sGL');if(s.gps_src==='hw'){g.textContent=s.gps_sats+'sat';g.style.color='#22c55e';gl.textContent='HW GPS';}else if(s.gps_src==='phone'){g.textContent=s.gps_tagged+'/'+s.total;g.style.color='#22c55e';gl.textContent='PHONE';}else if(s.gps_hw_detected){g.textContent=s.gps_sats+'sat';g.style.color='#facc15';gl.textContent='NO FIX';}else{g.textContent='TAP';g.style.color='#ef4444';gl.textContent='GPS';}}).catch(()=>{});}
-function card(d){return '<div class="det"><div class="mac">'+d.mac+(d.name?'<span class="nm">'+d.name+'</span>':'')+'</div><div class="inf"><span>RSSI: '+d.rssi+'</span><span>'+d.method+'</span><span style="color:#ec4899;font-weight:bold">&times;'+d.count+'</span>'+(d.raven?'<span class="rv">RAVEN '+d.fw+'</span>':'')+(d.gps?'<span style="color:#22c55e">&#9673; '+d.gps.lat.toFixed(5)+','+d.gps.lon.toFixed(5)+'</span>':'<span style="color:#666">no gps</span>')+'</div></div>';}
-function loadHistory(){fetch('/api/history').then(r=>r.json()).then(d=>{H=d;let el=document.getElementById('hL');if(!H.length){el.innerHTML='<div class="empty">No prior session data</div>';return;}
-H.sort((a,b)=>b.last-a.last);el.innerHTML='<div style="font-size:11px;color:#8b5cf6;margin-bottom:8px">'+H.length+' detections from prior session</div>'+H.map(card).join('');window._hL=1;}).catch(()=>{document.getElementById('hL').innerHTML='<div class="empty">No prior session data</div>';});}
-function loadPat(){fetch('/api/patterns').then(r=>r.json()).then(p=>{let h='';
-h+='<div class="pg"><h3>MAC Prefixes ('+p.macs.length+')</h3><div class="it">'+p.macs.map(m=>'<span>'+m+'</span>').join('')+'</div></div>';
-h+='<div class="pg"><h3>BLE Device Names ('+p.names.length+')</h3><div class="it">'+p.names.map(n=>'<span>'+n+'</span>').join('')+'</div></div>';
-h+='<div class="pg"><h3>BLE Manufacturer IDs ('+p.mfr.length+')</h3><div class="it">'+p.mfr.map(m=>'<span>0x'+m.toString(16).toUpperCase().padStart(4,'0')+'</span>').join('')+'</div></div>';
-h+='<div class="pg"><h3>Raven UUIDs ('+p.raven.length+')</h3><div class="it">'+p.raven.map(u=>'<span style="font-size:8px">'+u+'</span>').join('')+'</div></div>';
-document.getElementById('pC').innerHTML=h;window._pL=1;}).catch(()=>{});}
-// GPS from phone -> ESP32 (wardriving)
-// NOTE: Geolocation API needs secure context (HTTPS) on most browsers.
-// HTTP works on: Android Chrome (local IPs), some Android browsers.
-// Won't work on: iOS Safari (needs HTTPS always).
-// We only request on user tap (gesture) for best permission prompt chance.
-let _gW=null,_gOk=false,_gTried=false;
-function sendGPS(p){_gOk=true;let g=document.getElementById('sG');g.textContent='OK';g.style.color='#22c55e';
-fetch('/api/gps?lat='+p.coords.latitude+'&lon='+p.coords.longitude+'&acc='+(p.coords.accuracy||0)).catch(()=>{});}
-function gpsErr(e){_gOk=false;let g=document.getElementById('sG');
-var msg='ERR';if(e.code===1){msg='DENIED';g.style.color='#ef4444';alert('GPS permission denied. On iPhone, GPS requires HTTPS which this device cannot provide. On Android Chrome, tap the lock/info icon in the address bar and allow Location.');}
-else if(e.code===2){msg='N/A';g.style.color='#ef4444';}
-else if(e.code===3){msg='WAIT';g.style.color='#facc15';}
-g.textContent=msg;}
-function startGPS(){if(!navigator.geolocation){return false;}
-if(_gW!==null){navigator.geolocation.clearWatch(_gW);_gW=null;}
-let g=document.getElementById('sG');g.textContent='...';g.style.color='#facc15';
-_gW=navigator.geolocation.watchPosition(sendGPS,gpsErr,{enableHighAccuracy:true,maximumAge:5000,timeout:15000});return true;}
-function reqGPS(){if(!navigator.geolocation){alert('GPS not available in this browser.');return;}
-if(_gOk){return;}
-if(!window.isSecureContext){alert('GPS requires a secure context (HTTPS). This HTTP page may not get GPS permission.\\n\\nAndroid Chrome: try chrome://flags and enable "Insecure origins treated as secure", add http://192.168.4.1\\n\\niPhone: GPS will not work over HTTP.');}
-startGPS();_gTried=true;}
-refresh();setInterval(refresh,2500);
-</script></body></html>
-)rawliteral";
+// web/flockyou.html, minified + gzipped at build time by scripts/build_web.py
+#include "web/flockyou_html.h"
 
 // ============================================================================
 // WEB SERVER SETUP
@@ -881,213 +2419,245 @@ refresh();setInterval(refresh,2500);
 static void fySetupServer() {
     // Dashboard
     fyServer.on("/", HTTP_GET, [](AsyncWebServerRequest *r) {
-        r->send(200, "text/html", FY_HTML);
+        AsyncWebServerResponse *resp = r->beginResponse_P(200, "text/html", FLOCKYOU_HTML_GZ, FLOCKYOU_HTML_GZ_LEN);
+        resp->addHeader("Content-Encoding", "gzip");
+        r->send(resp);
     });
 
     // API: Detection list
     fyServer.on("/api/detections", HTTP_GET, [](AsyncWebServerRequest *r) {
-        AsyncResponseStream *resp = r->beginResponseStream("application/json");
-        writeDetectionsJSON(resp);
-        r->send(resp);
+        // ?since=<seq>&boot=<id>: only what changed, as {"boot","seq","full","detections"}
+        if (r->hasParam("since")) {
+            uint32_t boot = r->hasParam("boot") ? strtoul(r->getParam("boot")->value().c_str(), NULL, 10) : 0;
+            uint32_t since = strtoul(r->getParam("since")->value().c_str(), NULL, 10);
+            std::shared_ptr<FYSnapshot> snap = fySnapshotSince(boot, since);
+            if (!snap) {
+                // Busy: nothing new yet, the client asks again
+                char buf[96];
+                snprintf(buf, sizeof(buf), "{\"boot\":%u,\"seq\":%u,\"full\":false,\"detections\":[]}",
+                         (unsigned)boot, (unsigned)since);
+                r->send(200, "application/json", buf);
+                return;
+            }
+            fySnapRespond(r, FY_SNAP_DELTA, snap, NULL);
+        } else {
+            fySnapRespond(r, FY_SNAP_JSON, fySnapshotAll(), NULL);
+        }
     });
 
-    // API: Stats (includes GPS status)
+    // API: Stats (includes GPS status). Counters are kept by the pool, no scan.
     fyServer.on("/api/stats", HTTP_GET, [](AsyncWebServerRequest *r) {
-        int raven = 0, withGPS = 0;
-        if (fyMutex && xSemaphoreTake(fyMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-            for (int i = 0; i < fyDetCount; i++) {
-                if (fyDet[i].isRaven) raven++;
-                if (fyDet[i].hasGPS) withGPS++;
-            }
-            xSemaphoreGive(fyMutex);
-        }
+        FYFix fix;
+        bool haveFix = fyReadFix(fix);
+        bool fresh = haveFix && millis() - fix.ms < GPS_STALE_MS;
         const char* gpsSrc = "none";
-        if (fyGPSIsHardware && fyHWGPSFix) gpsSrc = "hw";
-        else if (fyGPSIsFresh()) gpsSrc = "phone";
-        char buf[320];
+        if (fresh && fix.hw && fyHWGPSFix) gpsSrc = "hw";
+        else if (fresh && !fix.hw) gpsSrc = "phone";
+        char buf[400];
         snprintf(buf, sizeof(buf),
             "{\"total\":%d,\"raven\":%d,\"ble\":\"active\","
             "\"gps_valid\":%s,\"gps_age\":%lu,\"gps_tagged\":%d,"
-            "\"gps_src\":\"%s\",\"gps_sats\":%d,\"gps_hw_detected\":%s}",
-            fyDetCount, raven,
-            fyGPSIsFresh() ? "true" : "false",
-            fyGPSValid ? (millis() - fyGPSLastUpdate) : 0UL,
-            withGPS,
+            "\"gps_src\":\"%s\",\"gps_sats\":%d,\"gps_hw_detected\":%s,"
+            "\"capacity\":%d,\"evicted\":%u,\"dropped\":%u}",
+            fyDetCount, fyDetRaven,
+            fresh ? "true" : "false",
+            haveFix ? (millis() - fix.ms) : 0UL,
+            fyDetWithGPS,
             gpsSrc, fyHWGPSSats,
-            fyHWGPSDetected ? "true" : "false");
+            fyHWGPSDetected ? "true" : "false",
+            fyDetCapacity, fyDetEvicted, fyDetDropped);
         r->send(200, "application/json", buf);
     });
 
     // API: Receive GPS from phone browser (ignored when hardware GPS has fix)
     fyServer.on("/api/gps", HTTP_GET, [](AsyncWebServerRequest *r) {
+        // Browser clock (Unix seconds) dates the session when there is no GPS time
+        if (r->hasParam("ts")) fySetClock(strtoul(r->getParam("ts")->value().c_str(), NULL, 10));
         if (fyHWGPSFix) {
             r->send(200, "application/json", "{\"status\":\"ignored\",\"reason\":\"hw_gps_active\"}");
             return;
         }
         if (r->hasParam("lat") && r->hasParam("lon")) {
-            fyGPSLat = r->getParam("lat")->value().toDouble();
-            fyGPSLon = r->getParam("lon")->value().toDouble();
-            fyGPSAcc = r->hasParam("acc") ? r->getParam("acc")->value().toFloat() : 0;
-            fyGPSValid = true;
-            fyGPSLastUpdate = millis();
-            fyGPSIsHardware = false;
+            FYFix f;
+            f.lat = r->getParam("lat")->value().toDouble();
+            f.lon = r->getParam("lon")->value().toDouble();
+            f.acc = r->hasParam("acc") ? r->getParam("acc")->value().toFloat() : 0;
+            f.ms = millis();
+            f.hw = false;
+            fyPublishFix(f);
             r->send(200, "application/json", "{\"status\":\"ok\"}");
         } else {
             r->send(400, "application/json", "{\"error\":\"lat,lon required\"}");
         }
     });
 
-    // API: Pattern database
+    // API: Pattern database (active signature set)
     fyServer.on("/api/patterns", HTTP_GET, [](AsyncWebServerRequest *r) {
+        if (!fySigMutex || xSemaphoreTake(fySigMutex, pdMS_TO_TICKS(200)) != pdTRUE) {
+            r->send(503, "application/json", "{\"error\":\"busy\"}");
+            return;
+        }
         AsyncResponseStream *resp = r->beginResponseStream("application/json");
-        resp->print("{\"macs\":[");
-        for (size_t i = 0; i < sizeof(mac_prefixes)/sizeof(mac_prefixes[0]); i++) {
+        resp->printf("{\"version\":%u,\"source\":\"%s\",\"macs\":[",
+                     (unsigned)fySig.version, fySig.fromFile ? "file" : "builtin");
+        for (size_t i = 0; i < fySig.ouis.size(); i++) {
             if (i > 0) resp->print(",");
-            resp->printf("\"%s\"", mac_prefixes[i]);
+            uint32_t o = fySig.ouis[i];
+            resp->printf("\"%02x:%02x:%02x\"", (unsigned)(o >> 16) & 0xFF,
+                         (unsigned)(o >> 8) & 0xFF, (unsigned)o & 0xFF);
         }
         resp->print("],\"names\":[");
-        for (size_t i = 0; i < sizeof(device_name_patterns)/sizeof(device_name_patterns[0]); i++) {
+        for (size_t i = 0; i < fySig.names.size(); i++) {
             if (i > 0) resp->print(",");
-            resp->printf("\"%s\"", device_name_patterns[i]);
+            resp->printf("\"%s\"", fySig.names[i]);
         }
         resp->print("],\"mfr\":[");
-        for (size_t i = 0; i < sizeof(ble_manufacturer_ids)/sizeof(ble_manufacturer_ids[0]); i++) {
+        for (size_t i = 0; i < fySig.mfrIds.size(); i++) {
             if (i > 0) resp->print(",");
-            resp->printf("%u", ble_manufacturer_ids[i]);
+            resp->printf("%u", fySig.mfrIds[i]);
         }
         resp->print("],\"raven\":[");
-        for (size_t i = 0; i < sizeof(raven_service_uuids)/sizeof(raven_service_uuids[0]); i++) {
+        for (size_t i = 0; i < fySig.services.size(); i++) {
+            char uuid[37];
+            fyFormatUUID128(fySig.services[i].uuid, uuid);
             if (i > 0) resp->print(",");
-            resp->printf("\"%s\"", raven_service_uuids[i]);
+            resp->printf("\"%s\"", uuid);
         }
         resp->print("]}");
+        xSemaphoreGive(fySigMutex);
         r->send(resp);
     });
 
+    // API: Upload a signature file (multipart, built by scripts/build_sigdb.py).
+    // Streamed to FY_SIGDB_TMP_FILE, validated, then promoted and applied.
+    // If it can't be promoted the signatures still apply until reboot, the
+    // reply says "persisted":false and the tmp file is left for a retry.
+    fyServer.on("/api/patterns/upload", HTTP_POST, [](AsyncWebServerRequest *r) {
+        if (fySigUploadError) {
+            r->send(400, "application/json",
+                    String("{\"error\":\"") + fySigUploadError + "\"}");
+            return;
+        }
+        FYSigDB db;
+        const char* err = fySigLoadFile(FY_SIGDB_TMP_FILE, db);
+        if (err) {
+            SPIFFS.remove(FY_SIGDB_TMP_FILE);
+            printf("[FLOCK-YOU] Signature upload rejected: %s\n", err);
+            r->send(400, "application/json", String("{\"error\":\"") + err + "\"}");
+            return;
+        }
+        // The old file is only set aside until the new one is in place
+        SPIFFS.remove(FY_SIGDB_OLD_FILE);
+        bool hadFile = SPIFFS.exists(FY_SIGDB_FILE);
+        bool persisted = (!hadFile || SPIFFS.rename(FY_SIGDB_FILE, FY_SIGDB_OLD_FILE)) &&
+                         SPIFFS.rename(FY_SIGDB_TMP_FILE, FY_SIGDB_FILE);
+        if (persisted) {
+            SPIFFS.remove(FY_SIGDB_OLD_FILE);
+        } else {
+            if (hadFile && !SPIFFS.exists(FY_SIGDB_FILE)) SPIFFS.rename(FY_SIGDB_OLD_FILE, FY_SIGDB_FILE);
+            printf("[FLOCK-YOU] Signature file not persisted (rename failed), %s kept\n",
+                   FY_SIGDB_TMP_FILE);
+        }
+        if (!fySigApply(db)) {
+            r->send(503, "application/json", "{\"error\":\"busy\"}");
+            return;
+        }
+        char buf[96];
+        snprintf(buf, sizeof(buf), "{\"status\":\"loaded\",\"version\":%u,\"persisted\":%s}",
+                 (unsigned)fySig.version, persisted ? "true" : "false");
+        r->send(200, "application/json", buf);
+    }, [](AsyncWebServerRequest *r, const String& filename, size_t index,
+          uint8_t *data, size_t len, bool final) {
+        if (index == 0) {
+            fySigUploadError = NULL;
+            if (fySigUpload) fySigUpload.close();
+            if (!fySpiffsReady) { fySigUploadError = "no filesystem"; return; }
+            fySigUpload = SPIFFS.open(FY_SIGDB_TMP_FILE, "w");
+            if (!fySigUpload) { fySigUploadError = "cannot create file"; return; }
+        }
+        if (fySigUploadError) return;
+        if (index + len > FY_SIGDB_MAX_BYTES) {
+            fySigUploadError = "file too large";
+        } else if (fySigUpload.write(data, len) != len) {
+            fySigUploadError = "write failed";
+        }
+        if (fySigUploadError || final) fySigUpload.close();
+        if (fySigUploadError) SPIFFS.remove(FY_SIGDB_TMP_FILE);
+    });
+
+    // API: Drop the uploaded file and go back to the compiled-in signatures
+    fyServer.on("/api/patterns/reset", HTTP_POST, [](AsyncWebServerRequest *r) {
+        if (fySpiffsReady) SPIFFS.remove(FY_SIGDB_FILE);
+        FYSigDB db;
+        fySigLoadBuiltin(db);
+        if (!fySigApply(db)) {
+            r->send(503, "application/json", "{\"error\":\"busy\"}");
+            return;
+        }
+        r->send(200, "application/json", "{\"status\":\"builtin\",\"version\":0}");
+    });
+
     // API: Export JSON (downloadable file)
     fyServer.on("/api/export/json", HTTP_GET, [](AsyncWebServerRequest *r) {
-        AsyncResponseStream *resp = r->beginResponseStream("application/json");
-        resp->addHeader("Content-Disposition", "attachment; filename=\"flockyou_detections.json\"");
-        writeDetectionsJSON(resp);
-        r->send(resp);
+        fySnapRespond(r, FY_SNAP_JSON, fySnapshotAll(), "flockyou_detections.json");
     });
 
     // API: Export CSV (downloadable file, includes GPS)
     fyServer.on("/api/export/csv", HTTP_GET, [](AsyncWebServerRequest *r) {
-        AsyncResponseStream *resp = r->beginResponseStream("text/csv");
-        resp->addHeader("Content-Disposition", "attachment; filename=\"flockyou_detections.csv\"");
-        resp->println("mac,name,rssi,method,first_seen_ms,last_seen_ms,count,is_raven,raven_fw,latitude,longitude,gps_accuracy");
-        if (fyMutex && xSemaphoreTake(fyMutex, pdMS_TO_TICKS(200)) == pdTRUE) {
-            for (int i = 0; i < fyDetCount; i++) {
-                FYDetection& d = fyDet[i];
-                if (d.hasGPS) {
-                    resp->printf("\"%s\",\"%s\",%d,\"%s\",%lu,%lu,%d,%s,\"%s\",%.8f,%.8f,%.1f\n",
-                        d.mac, d.name, d.rssi, d.method,
-                        d.firstSeen, d.lastSeen, d.count,
-                        d.isRaven ? "true" : "false", d.ravenFW,
-                        d.gpsLat, d.gpsLon, d.gpsAcc);
-                } else {
-                    resp->printf("\"%s\",\"%s\",%d,\"%s\",%lu,%lu,%d,%s,\"%s\",,,\n",
-                        d.mac, d.name, d.rssi, d.method,
-                        d.firstSeen, d.lastSeen, d.count,
-                        d.isRaven ? "true" : "false", d.ravenFW);
-                }
-            }
-            xSemaphoreGive(fyMutex);
-        }
-        r->send(resp);
+        fySnapRespond(r, FY_SNAP_CSV, fySnapshotAll(), "flockyou_detections.csv");
     });
 
     // API: Export KML (GPS-tagged detections for Google Earth)
     fyServer.on("/api/export/kml", HTTP_GET, [](AsyncWebServerRequest *r) {
-        AsyncResponseStream *resp = r->beginResponseStream("application/vnd.google-earth.kml+xml");
-        resp->addHeader("Content-Disposition", "attachment; filename=\"flockyou_detections.kml\"");
-        writeDetectionsKML(resp);
+        fySnapRespond(r, FY_SNAP_KML, fySnapshotAll(), "flockyou_detections.kml");
+    });
+
+    // API: Session history index (newest first)
+    fyServer.on("/api/history/sessions", HTTP_GET, [](AsyncWebServerRequest *r) {
+        AsyncResponseStream *resp = r->beginResponseStream("application/json");
+        resp->printf("{\"live\":%u,\"liveStart\":%u,\"sessions\":[",
+                     (unsigned)fyHist.nextId, (unsigned)fyEpochAtBoot);
+        for (int i = (int)fyHist.count - 1; i >= 0; i--) {
+            const FYHistSession& h = fyHist.sessions[i];
+            resp->printf("{\"id\":%u,\"start\":%u,\"span\":%u,\"detections\":%u,"
+                         "\"offset\":%u,\"bytes\":%u}%s",
+                         (unsigned)h.id, (unsigned)h.startEpoch, (unsigned)h.spanS,
+                         (unsigned)h.detections, (unsigned)h.offset,
+                         (unsigned)(h.detections * sizeof(FYSessionRecord)), i > 0 ? "," : "");
+        }
+        resp->print("]}");
         r->send(resp);
     });
 
-    // API: Prior session history (JSON)
+    // API: Session history as JSON (?session=<id> or ?from=&to=, default latest)
     fyServer.on("/api/history", HTTP_GET, [](AsyncWebServerRequest *r) {
-        if (fySpiffsReady && SPIFFS.exists(FY_PREV_FILE)) {
-            r->send(SPIFFS, FY_PREV_FILE, "application/json");
-        } else {
-            r->send(200, "application/json", "[]");
-        }
+        fyHistRespond(r, FY_HIST_JSON, NULL);
     });
 
-    // API: Download prior session as JSON file
+    // API: Download session history as JSON file
     fyServer.on("/api/history/json", HTTP_GET, [](AsyncWebServerRequest *r) {
-        if (fySpiffsReady && SPIFFS.exists(FY_PREV_FILE)) {
-            AsyncWebServerResponse *resp = r->beginResponse(SPIFFS, FY_PREV_FILE, "application/json");
-            resp->addHeader("Content-Disposition", "attachment; filename=\"flockyou_prev_session.json\"");
-            r->send(resp);
-        } else {
-            r->send(404, "application/json", "{\"error\":\"no prior session\"}");
-        }
+        fyHistRespond(r, FY_HIST_JSON, "flockyou_history.json");
     });
 
-    // API: Download prior session as KML (reads JSON from SPIFFS, converts)
+    // API: Download session history as KML (GPS-tagged detections only)
     fyServer.on("/api/history/kml", HTTP_GET, [](AsyncWebServerRequest *r) {
-        if (!fySpiffsReady || !SPIFFS.exists(FY_PREV_FILE)) {
-            r->send(404, "application/json", "{\"error\":\"no prior session\"}");
-            return;
-        }
-        File f = SPIFFS.open(FY_PREV_FILE, "r");
-        if (!f) { r->send(500, "text/plain", "read error"); return; }
-        String content = f.readString();
-        f.close();
-        if (content.length() == 0) {
-            r->send(404, "application/json", "{\"error\":\"prior session empty\"}");
-            return;
-        }
-        AsyncResponseStream *resp = r->beginResponseStream("application/vnd.google-earth.kml+xml");
-        resp->addHeader("Content-Disposition", "attachment; filename=\"flockyou_prev_session.kml\"");
-        resp->print("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
-                    "<kml xmlns=\"http://www.opengis.net/kml/2.2\">\n<Document>\n"
-                    "<name>Flock-You Prior Session</name>\n"
-                    "<description>Surveillance device detections from prior session</description>\n"
-                    "<Style id=\"det\"><IconStyle><color>ff4489ec</color>"
-                    "<scale>1.0</scale></IconStyle></Style>\n"
-                    "<Style id=\"raven\"><IconStyle><color>ff4444ef</color>"
-                    "<scale>1.2</scale></IconStyle></Style>\n");
-        // Parse JSON array and emit placemarks
-        JsonDocument doc;
-        DeserializationError err = deserializeJson(doc, content);
-        if (!err && doc.is<JsonArray>()) {
-            int placed = 0;
-            for (JsonObject d : doc.as<JsonArray>()) {
-                JsonObject gps = d["gps"];
-                if (!gps || !gps.containsKey("lat")) continue;
-                bool isRaven = d["raven"] | false;
-                resp->printf("<Placemark><name>%s</name>\n", d["mac"] | "?");
-                resp->printf("<styleUrl>#%s</styleUrl>\n", isRaven ? "raven" : "det");
-                resp->print("<description><![CDATA[");
-                if (d["name"].is<const char*>() && strlen(d["name"] | "") > 0)
-                    resp->printf("<b>Name:</b> %s<br/>", d["name"] | "");
-                resp->printf("<b>Method:</b> %s<br/><b>RSSI:</b> %d<br/><b>Count:</b> %d",
-                    d["method"] | "?", d["rssi"] | 0, d["count"] | 1);
-                if (isRaven && d["fw"].is<const char*>())
-                    resp->printf("<br/><b>Raven FW:</b> %s", d["fw"] | "");
-                resp->print("]]></description>\n");
-                resp->printf("<Point><coordinates>%.8f,%.8f,0</coordinates></Point>\n",
-                    (double)(gps["lon"] | 0.0), (double)(gps["lat"] | 0.0));
-                resp->print("</Placemark>\n");
-                placed++;
-            }
-            printf("[FLOCK-YOU] Prior session KML: %d placemarks\n", placed);
-        } else {
-            printf("[FLOCK-YOU] Prior session KML: JSON parse failed\n");
-        }
-        resp->print("</Document>\n</kml>");
-        r->send(resp);
+        fyHistRespond(r, FY_HIST_KML, "flockyou_history.kml");
+    });
+
+    // API: GPS track log (?session=<id> for one session)
+    fyServer.on("/api/track/gpx", HTTP_GET, [](AsyncWebServerRequest *r) {
+        fyTrackRespond(r, FY_TRACK_GPX);
+    });
+
+    fyServer.on("/api/track/kml", HTTP_GET, [](AsyncWebServerRequest *r) {
+        fyTrackRespond(r, FY_TRACK_KML);
     });
 
     // API: Clear all detections (saves current session first)
     fyServer.on("/api/clear", HTTP_GET, [](AsyncWebServerRequest *r) {
         fySaveSession();  // Persist before clearing
         if (fyMutex && xSemaphoreTake(fyMutex, pdMS_TO_TICKS(200)) == pdTRUE) {
-            fyDetCount = 0;
-            memset(fyDet, 0, sizeof(fyDet));
+            fyClearDetections();
             fyDeviceInRange = false;
             xSemaphoreGive(fyMutex);
         }
@@ -1095,6 +2665,14 @@ static void fySetupServer() {
         printf("[FLOCK-YOU] All detections cleared (session saved)\n");
     });
 
+    // Live detection push
+    fyEvents.onConnect([](AsyncEventSourceClient *c) {
+        char hello[48];
+        snprintf(hello, sizeof(hello), "{\"boot\":%u}", (unsigned)fyDetBootId);
+        c->send(hello, "hello", 0);
+    });
+    fyServer.addHandler(&fyEvents);
+
     fyServer.begin();
     printf("[FLOCK-YOU] Web server started on port 80\n");
 }
@@ -1132,30 +2710,60 @@ void setup() {
     fyPixel.show();
 
     fyMutex = xSemaphoreCreateMutex();
-
-    // Init hardware GPS UART (Seeed L76K on D6/D7)
-    fyGPSSerial.begin(GPS_BAUD, SERIAL_8N1, GPS_RX_PIN, GPS_TX_PIN);
-
-    // Init SPIFFS for session persistence
+    fySessionMutex = xSemaphoreCreateMutex();
+    fyDetBootId = esp_random() | 1;  // Never 0, which clients send first
+
+    // Init SPIFFS for session persistence. What the track log and small
+    // files leave, less an eighth SPIFFS needs free to stay fast, is split
+    // between the session log and the history ring, and the pool is no
+    // bigger than those can persist.
+    uint32_t capacity = FY_DET_CAPACITY;
     if (SPIFFS.begin(true)) {
         fySpiffsReady = true;
-        printf("[FLOCK-YOU] SPIFFS ready\n");
-        // Promote last session to prev_session before we start a new one
-        fyPromotePrevSession();
+        size_t total = SPIFFS.totalBytes();
+        size_t taken = total / 8 + FY_TRACK_BLOCKS * FY_TRACK_BLOCK + FY_SPIFFS_RESERVE;
+        FYStoragePlan plan = fyStoragePlan(total > taken ? total - taken : 0, FY_DET_CAPACITY);
+        fyLogBudget = plan.logRecords;
+        fyHistBytes = plan.histRecords * sizeof(FYSessionRecord);
+        if (plan.capacity < capacity) capacity = plan.capacity;
+        if (capacity < FY_DET_FALLBACK_CAPACITY) capacity = FY_DET_FALLBACK_CAPACITY;
+        printf("[FLOCK-YOU] SPIFFS ready: log %u records, history %u records\n",
+               (unsigned)plan.logRecords, (unsigned)plan.histRecords);
     } else {
         printf("[FLOCK-YOU] SPIFFS init failed - no persistence\n");
     }
 
+    // Detection pool: PSRAM sized, internal RAM fallback
+    if (fyAllocDetections(capacity, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT) ||
+        fyAllocDetections(FY_DET_FALLBACK_CAPACITY, MALLOC_CAP_8BIT)) {
+        fyClearDetections();
+        printf("[FLOCK-YOU] Detection pool: %d entries (%s eviction)\n", fyDetCapacity,
+               FY_EVICT_POLICY == FY_EVICT_LRU ? "LRU" : "no");
+    } else {
+        printf("[FLOCK-YOU] Detection pool allocation failed\n");
+    }
+
+    // Init hardware GPS UART (Seeed L76K on D6/D7) and its NMEA task
+    fyStartGPS();
+
+    // Archive the last session into the history before we start a new one
+    fyPromotePrevSession();
+    fyTrackInit();
+
     printf("\n========================================\n");
     printf("  FLOCK-YOU Surveillance Detector\n");
     printf("  Buzzer: %s\n", fyBuzzerOn ? "ON" : "OFF");
     printf("  GPS: auto-detect (L76K on D6/D7)\n");
     printf("========================================\n");
 
+    // Signature tables + name matcher (needs SPIFFS for an uploaded file)
+    fySigInit();
+
     // Init BLE scanner FIRST -- start scanning immediately
     NimBLEDevice::init("");
     fyBLEScan = NimBLEDevice::getScan();
-    fyBLEScan->setAdvertisedDeviceCallbacks(new FYBLECallbacks());
+    // Every advertisement, not one per scan, so advertising intervals can be measured
+    fyBLEScan->setAdvertisedDeviceCallbacks(new FYBLECallbacks(), true);
     fyBLEScan->setActiveScan(true);
     fyBLEScan->setInterval(100);
     fyBLEScan->setWindow(99);
@@ -1178,14 +2786,15 @@ void setup() {
     // Start web dashboard
     fySetupServer();
 
-    printf("[FLOCK-YOU] Detection methods: MAC prefix, device name, manufacturer ID, Raven UUID\n");
+    printf("[FLOCK-YOU] Detection methods: MAC prefix, device name, manufacturer ID, Raven UUID, advertising interval\n");
     printf("[FLOCK-YOU] Dashboard: http://192.168.4.1\n");
     printf("[FLOCK-YOU] Ready - no WiFi connection needed, BLE + AP only\n\n");
 }
 
 void loop() {
-    fyProcessHardwareGPS();
+    fyTrackSample();
     fyUpdatePixel();
+    fyPushEvents();
 
     // BLE scanning cycle
     if (millis() - fyLastBleScan >= BLE_SCAN_INTERVAL && !fyBLEScan->isScanning()) {
@@ -1209,14 +2818,20 @@ void loop() {
         }
     }
 
-    // Auto-save session to SPIFFS every 15s if detections changed
+    // Date the running session in the history index once a clock is known
+    if (fySpiffsReady && fyEpochAtBoot && !fyHist.liveEpoch) {
+        fyHist.liveEpoch = fyEpochAtBoot;
+        fyHistSave();
+    }
+
+    // Checkpoint changed detections to SPIFFS every 15s; compaction is
+    // checked on the same timer even when nothing changed
     // Also triggers an early save 5s after first detection to minimize loss on power-cycle
     if (fySpiffsReady && millis() - fyLastSave >= FY_SAVE_INTERVAL) {
-        if (fyDetCount > 0 && fyDetCount != fyLastSaveCount) {
-            fySaveSession();
-        }
+        fySaveSession();
+        fyTrackFlush();
         fyLastSave = millis();
-    } else if (fySpiffsReady && fyDetCount > 0 && fyLastSaveCount == 0 &&
+    } else if (fySpiffsReady && fyDirtyCount > 0 && fyLog.records == 0 &&
                millis() - fyLastSave >= 5000) {
         // Quick first-save: persist within 5s of first detection
         fySaveSession();
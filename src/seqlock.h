@@ -0,0 +1,64 @@
+/*
+ * SeqLock - single-writer publication of a small value to lock-free readers.
+ *
+ * The writer bumps the sequence to odd, stores the value and bumps it to
+ * even again; a reader copies the value and retries if the sequence was odd
+ * or moved meanwhile. Readers never block the writer or each other, which
+ * suits a value written a few times a second and read from BLE callbacks.
+ * The value is kept as relaxed atomic words, so a torn copy is discarded
+ * rather than being a data race.
+ *
+ * T must be trivially copyable. Concurrent writers must be serialized by
+ * the caller (e.g. with a spinlock held for write()).
+ */
+
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <atomic>
+#include <type_traits>
+
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock values are copied word by word");
+
+public:
+    void write(const T& value) {
+        uint32_t tmp[WORDS] = {};
+        memcpy(tmp, &value, sizeof(T));
+        uint32_t seq = sequence.load(std::memory_order_relaxed);
+        sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WORDS; i++) words[i].store(tmp[i], std::memory_order_relaxed);
+        sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    // Latest value. Returns false if nothing was ever written.
+    bool read(T& out) const {
+        uint32_t tmp[WORDS];
+        for (;;) {
+            uint32_t seq = sequence.load(std::memory_order_acquire);
+            if (seq == 0) return false;
+            if (seq & 1) continue;  // Writer is mid-copy (a few instructions)
+            for (size_t i = 0; i < WORDS; i++) tmp[i] = words[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence.load(std::memory_order_relaxed) == seq) break;
+        }
+        memcpy(&out, tmp, sizeof(T));
+        return true;
+    }
+
+    // Writes so far
+    uint32_t writes() const { return sequence.load(std::memory_order_acquire) / 2; }
+
+private:
+    static const size_t WORDS = (sizeof(T) + 3) / 4;
+
+    std::atomic<uint32_t> sequence{0};  // Odd while being written, 0 = never written
+    std::atomic<uint32_t> words[WORDS] = {};
+};
+
+#endif // SEQLOCK_H
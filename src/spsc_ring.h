@@ -0,0 +1,60 @@
+/*
+ * SPSC Ring - lock-free single-producer / single-consumer queue.
+ *
+ * A fixed array of N slots (N a power of two) with free-running head and
+ * tail counters. Each side only writes its own counter; release/acquire
+ * ordering publishes slot contents, so one task can push while another
+ * pops without a lock. A push onto a full ring fails and is counted.
+ *
+ * T must be trivially copyable. Exactly one producer and one consumer.
+ */
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+template <typename T, size_t N>
+class SpscRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing size must be a power of two");
+
+public:
+    // Producer side. Returns false (and counts the drop) when full.
+    bool push(const T& item) {
+        uint32_t head = headIndex.load(std::memory_order_relaxed);
+        uint32_t tail = tailIndex.load(std::memory_order_acquire);
+        if (head - tail >= N) {
+            overflowCount.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        slots[head & (N - 1)] = item;
+        headIndex.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Copies up to maxItems items out; returns the count.
+    size_t popBatch(T* out, size_t maxItems) {
+        uint32_t tail = tailIndex.load(std::memory_order_relaxed);
+        uint32_t head = headIndex.load(std::memory_order_acquire);
+        size_t n = head - tail;
+        if (n > maxItems) n = maxItems;
+        for (size_t i = 0; i < n; i++) {
+            out[i] = slots[(tail + i) & (N - 1)];
+        }
+        tailIndex.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+    // Items pushed on a full ring since start
+    uint32_t overflows() const { return overflowCount.load(std::memory_order_relaxed); }
+
+private:
+    T slots[N] = {};
+    std::atomic<uint32_t> headIndex{0};
+    std::atomic<uint32_t> tailIndex{0};
+    std::atomic<uint32_t> overflowCount{0};
+};
+
+#endif // SPSC_RING_H
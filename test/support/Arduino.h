@@ -0,0 +1,104 @@
+/*
+ * Host stand-in for the parts of the Arduino-ESP32 core used by the modules
+ * under test. Outputs (pins, LEDC) are recorded with a timestamp so tests
+ * can check what the firmware would have driven.
+ */
+
+#ifndef TEST_SUPPORT_ARDUINO_H
+#define TEST_SUPPORT_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#define HIGH 1
+#define LOW  0
+
+inline uint32_t millis() {
+    static const auto start = std::chrono::steady_clock::now();
+    return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+// Math helpers from Arduino.h (TinyGPS++ uses them)
+#define TWO_PI 6.283185307179586476925286766559
+#define radians(deg) ((deg) * 0.017453292519943295769236907684886)
+#define degrees(rad) ((rad) * 57.295779513082320876798154814105)
+#define sq(x) ((x) * (x))
+
+// ---- Recorded outputs ----------------------------------------------------
+
+enum ShimOutput : uint8_t {
+    SHIM_DIGITAL_WRITE,
+    SHIM_LEDC_TONE,
+    SHIM_LEDC_DUTY,
+    SHIM_LEDC_ATTACH
+};
+
+struct ShimEvent {
+    uint32_t ms;
+    ShimOutput what;
+    int target;  // Pin or LEDC channel
+    int value;
+};
+
+inline std::mutex& shimMutex() { static std::mutex m; return m; }
+inline std::vector<ShimEvent>& shimLog() { static std::vector<ShimEvent> log; return log; }
+
+inline void shimRecord(ShimOutput what, int target, int value) {
+    std::lock_guard<std::mutex> lock(shimMutex());
+    shimLog().push_back({millis(), what, target, value});
+}
+
+// Copy of the log so far; clear = start a fresh one
+inline std::vector<ShimEvent> shimEvents(bool clear = false) {
+    std::lock_guard<std::mutex> lock(shimMutex());
+    std::vector<ShimEvent> copy = shimLog();
+    if (clear) shimLog().clear();
+    return copy;
+}
+
+inline void digitalWrite(uint8_t pin, uint8_t value) { shimRecord(SHIM_DIGITAL_WRITE, pin, value); }
+inline double ledcSetup(uint8_t, double freq, uint8_t) { return freq; }
+inline void ledcAttachPin(uint8_t pin, uint8_t channel) { shimRecord(SHIM_LEDC_ATTACH, channel, pin); }
+inline double ledcWriteTone(uint8_t channel, double freq) { shimRecord(SHIM_LEDC_TONE, channel, (int)freq); return freq; }
+inline void ledcWrite(uint8_t channel, uint32_t duty) { shimRecord(SHIM_LEDC_DUTY, channel, (int)duty); }
+
+// ---- Print ---------------------------------------------------------------
+
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size) {
+        size_t n = 0;
+        while (size--) n += write(*buffer++);
+        return n;
+    }
+    size_t print(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+        char buf[256];
+        va_list args;
+        va_start(args, format);
+        int n = vsnprintf(buf, sizeof(buf), format, args);
+        va_end(args);
+        if (n < 0) return 0;
+        return write((const uint8_t*)buf, (size_t)n < sizeof(buf) ? (size_t)n : sizeof(buf) - 1);
+    }
+};
+
+// Print into a std::string
+class StringPrint : public Print {
+public:
+    std::string text;
+    size_t write(uint8_t c) override { text += (char)c; return 1; }
+};
+
+#endif // TEST_SUPPORT_ARDUINO_H
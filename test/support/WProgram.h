@@ -0,0 +1,6 @@
+/*
+ * Libraries that predate Arduino 1.0 (TinyGPS++) include WProgram.h unless
+ * ARDUINO >= 100 is defined.
+ */
+
+#include "Arduino.h"
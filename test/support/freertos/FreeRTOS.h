@@ -0,0 +1,21 @@
+/*
+ * Host stand-in for the FreeRTOS types and tick macros used by the modules
+ * under test. One tick is one millisecond.
+ */
+
+#ifndef TEST_SUPPORT_FREERTOS_H
+#define TEST_SUPPORT_FREERTOS_H
+
+#include <stdint.h>
+
+typedef int BaseType_t;
+typedef unsigned UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdTRUE  1
+#define pdFALSE 0
+#define pdPASS  pdTRUE
+#define portMAX_DELAY ((TickType_t)0xFFFFFFFF)
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+#endif // TEST_SUPPORT_FREERTOS_H
@@ -0,0 +1,62 @@
+/*
+ * Host stand-in for FreeRTOS queues: fixed-size items copied by value
+ * into a bounded deque guarded by a mutex and condition variable.
+ */
+
+#ifndef TEST_SUPPORT_FREERTOS_QUEUE_H
+#define TEST_SUPPORT_FREERTOS_QUEUE_H
+
+#include <string.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <vector>
+#include "FreeRTOS.h"
+
+struct ShimQueue {
+    std::mutex lock;
+    std::condition_variable ready;
+    std::deque<std::vector<uint8_t>> items;
+    UBaseType_t depth;
+    UBaseType_t itemSize;
+};
+
+typedef ShimQueue* QueueHandle_t;
+
+inline QueueHandle_t xQueueCreate(UBaseType_t depth, UBaseType_t itemSize) {
+    ShimQueue* q = new ShimQueue();
+    q->depth = depth;
+    q->itemSize = itemSize;
+    return q;
+}
+
+// Never blocks on a full queue (the modules under test only send with 0 ticks)
+inline BaseType_t xQueueSend(QueueHandle_t q, const void* item, TickType_t) {
+    std::lock_guard<std::mutex> guard(q->lock);
+    if (q->items.size() >= q->depth) return pdFALSE;
+    const uint8_t* bytes = (const uint8_t*)item;
+    q->items.emplace_back(bytes, bytes + q->itemSize);
+    q->ready.notify_one();
+    return pdTRUE;
+}
+
+inline BaseType_t xQueueReceive(QueueHandle_t q, void* item, TickType_t ticks) {
+    std::unique_lock<std::mutex> guard(q->lock);
+    auto hasItem = [q] { return !q->items.empty(); };
+    if (ticks == portMAX_DELAY) {
+        q->ready.wait(guard, hasItem);
+    } else if (!q->ready.wait_for(guard, std::chrono::milliseconds(ticks), hasItem)) {
+        return pdFALSE;
+    }
+    memcpy(item, q->items.front().data(), q->itemSize);
+    q->items.pop_front();
+    return pdTRUE;
+}
+
+inline UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q) {
+    std::lock_guard<std::mutex> guard(q->lock);
+    return (UBaseType_t)q->items.size();
+}
+
+#endif // TEST_SUPPORT_FREERTOS_QUEUE_H
@@ -0,0 +1,26 @@
+/*
+ * Host stand-in for FreeRTOS tasks: each task is a detached std::thread.
+ */
+
+#ifndef TEST_SUPPORT_FREERTOS_TASK_H
+#define TEST_SUPPORT_FREERTOS_TASK_H
+
+#include <chrono>
+#include <thread>
+#include "FreeRTOS.h"
+
+typedef void (*TaskFunction_t)(void*);
+typedef void* TaskHandle_t;
+
+inline void vTaskDelay(TickType_t ticks) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+}
+
+inline BaseType_t xTaskCreate(TaskFunction_t fn, const char*, uint32_t, void* arg,
+                              UBaseType_t, TaskHandle_t* handle) {
+    std::thread(fn, arg).detach();
+    if (handle) *handle = nullptr;
+    return pdPASS;
+}
+
+#endif // TEST_SUPPORT_FREERTOS_TASK_H
@@ -0,0 +1,112 @@
+/*
+ * Advertising interval statistics: Welford mean/spread, repeat and gap
+ * handling, steady-timer detection and the JSON report.
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "adv_interval.h"
+
+static uint64_t rngState = 0x9E3779B97F4A7C15ULL;
+
+static uint32_t nextRandom() {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 7;
+    rngState ^= rngState << 17;
+    return (uint32_t)rngState;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_mean_and_spread(void) {
+    AdvInterval s;
+    memset(&s, 0, sizeof(s));
+    // Gaps alternate 90 / 110 ms: mean 100, sample sd ~10
+    uint32_t t = 1000;
+    for (int i = 0; i < 201; i++) {
+        advIntervalAdd(s, t);
+        t += (i & 1) ? 110 : 90;
+    }
+    TEST_ASSERT_EQUAL_UINT16(200, s.n);
+    TEST_ASSERT_TRUE(fabsf(s.mean - 100.0f) < 0.5f);
+    TEST_ASSERT_TRUE(fabsf(advIntervalStddev(s) - 10.0f) < 0.5f);
+    TEST_ASSERT_EQUAL_UINT32(64, advIntervalMode(s));  // 64-127 ms bucket
+    TEST_ASSERT_TRUE(advIntervalSteady(s));
+}
+
+void test_repeats_and_gaps_are_not_counted(void) {
+    AdvInterval s;
+    memset(&s, 0, sizeof(s));
+    advIntervalAdd(s, 0);                        // Time 0 still counts as a sighting
+    TEST_ASSERT_EQUAL_UINT32(1, s.lastMs);
+    advIntervalAdd(s, 1 + ADV_INTERVAL_MIN_MS - 1);  // Same advertising event
+    TEST_ASSERT_EQUAL_UINT16(0, s.n);
+    TEST_ASSERT_EQUAL_UINT32(1, s.lastMs);
+    advIntervalAdd(s, 1 + ADV_INTERVAL_MAX_MS + 1);  // Out of range in between
+    TEST_ASSERT_EQUAL_UINT16(0, s.n);
+    advIntervalAdd(s, 20000, 19000);             // Listening restarted after the last one
+    TEST_ASSERT_EQUAL_UINT16(0, s.n);
+    advIntervalAdd(s, 20500, 19000);
+    TEST_ASSERT_EQUAL_UINT16(1, s.n);
+    TEST_ASSERT_TRUE(fabsf(s.mean - 500.0f) < 0.01f);
+}
+
+void test_steady_tolerates_loss_but_not_noise(void) {
+    AdvInterval timer, phone;
+    memset(&timer, 0, sizeof(timer));
+    memset(&phone, 0, sizeof(phone));
+    uint32_t t = 1000, p = 1000;
+    for (int i = 0; i < 300; i++) {
+        // 1 s timer with 20% of advertisements missed
+        t += (nextRandom() % 5 == 0) ? 2000 : 1000;
+        advIntervalAdd(timer, t);
+        // Bursty: anywhere from 20 ms to 5 s
+        p += 20 + nextRandom() % 5000;
+        advIntervalAdd(phone, p);
+    }
+    TEST_ASSERT_TRUE(advIntervalSteady(timer));
+    TEST_ASSERT_FALSE(advIntervalSteady(phone));
+
+    AdvInterval few;
+    memset(&few, 0, sizeof(few));
+    for (int i = 0; i < 8; i++) advIntervalAdd(few, 1000 + i * 100);
+    TEST_ASSERT_FALSE(advIntervalSteady(few));  // 7 gaps
+}
+
+void test_long_runs_stay_bounded(void) {
+    AdvInterval s;
+    memset(&s, 0, sizeof(s));
+    uint32_t t = 1;
+    for (int i = 0; i < 100000; i++) {
+        t += 95 + nextRandom() % 11;
+        advIntervalAdd(s, t);
+    }
+    TEST_ASSERT_EQUAL_UINT16(ADV_INTERVAL_MAX_N, s.n);
+    TEST_ASSERT_TRUE(fabsf(s.mean - 100.0f) < 1.0f);
+    TEST_ASSERT_TRUE(advIntervalStddev(s) < 5.0f);
+    TEST_ASSERT_TRUE(advIntervalSteady(s));
+}
+
+void test_json_is_marked_session_only(void) {
+    AdvInterval s;
+    memset(&s, 0, sizeof(s));
+    for (int i = 0; i < 10; i++) advIntervalAdd(s, 1000 + i * 100);
+    StringPrint out;
+    advIntervalPrintJSON(out, s);
+    TEST_ASSERT_EQUAL_STRING(
+        "{\"scope\":\"session\",\"n\":9,\"mean\":100.0,\"sd\":0.0,\"mode\":64,\"steady\":true,"
+        "\"hist\":[0,0,9,0,0,0,0,0,0,0]}", out.text.c_str());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_mean_and_spread);
+    RUN_TEST(test_repeats_and_gaps_are_not_counted);
+    RUN_TEST(test_steady_tolerates_loss_but_not_noise);
+    RUN_TEST(test_long_runs_stay_bounded);
+    RUN_TEST(test_json_is_marked_session_only);
+    return UNITY_END();
+}
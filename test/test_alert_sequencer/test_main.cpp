@@ -0,0 +1,163 @@
+/*
+ * Alert sequencer on the host shims: alertPlay() must return in
+ * microseconds whatever the sequencer is doing, and the task must drive
+ * the buzzer and LED as the pattern describes.
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <Arduino.h>
+#include "alert_sequencer.h"
+
+#define TEST_BUZZER_PIN 3
+#define TEST_LED_PIN    21
+#define TEST_CHANNEL    0
+
+static void waitIdle() {
+    for (int i = 0; i < 500 && alertBusy(); i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    TEST_ASSERT_FALSE(alertBusy());
+}
+
+static std::vector<ShimEvent> eventsOf(const std::vector<ShimEvent>& log, ShimOutput what) {
+    std::vector<ShimEvent> out;
+    for (const ShimEvent& e : log) {
+        if (e.what == what) out.push_back(e);
+    }
+    return out;
+}
+
+void setUp(void) {
+    waitIdle();
+    shimEvents(true);
+}
+
+void tearDown(void) {}
+
+void test_play_before_begin_is_rejected(void) {
+    static const AlertStep beep[] = {{2000, 0, 20, 0, 1}};
+    TEST_ASSERT_FALSE(alertPlay(beep));
+    TEST_ASSERT_FALSE(alertBusy());
+}
+
+void test_beep_drives_buzzer_and_led(void) {
+    static const AlertStep beep[] = {{2000, 0, 40, 0, 1}, {0, 0, 20, 0, 0}, {1500, 0, 40, 0, 1}};
+    TEST_ASSERT_TRUE(alertPlay(beep));
+    TEST_ASSERT_TRUE(alertBusy());
+    waitIdle();
+
+    std::vector<ShimEvent> log = shimEvents();
+    std::vector<ShimEvent> tones = eventsOf(log, SHIM_LEDC_TONE);
+    TEST_ASSERT_EQUAL_size_t(2, tones.size());
+    TEST_ASSERT_EQUAL_INT(2000, tones[0].value);
+    TEST_ASSERT_EQUAL_INT(1500, tones[1].value);
+    TEST_ASSERT_UINT32_WITHIN(30, 60, tones[1].ms - tones[0].ms);
+
+    // Silenced at the end, LED back off (active low: HIGH)
+    std::vector<ShimEvent> duty = eventsOf(log, SHIM_LEDC_DUTY);
+    TEST_ASSERT_TRUE(duty.size() >= 2);
+    TEST_ASSERT_EQUAL_INT(0, duty.back().value);
+    std::vector<ShimEvent> led = eventsOf(log, SHIM_DIGITAL_WRITE);
+    TEST_ASSERT_EQUAL_INT(TEST_LED_PIN, led.front().target);
+    TEST_ASSERT_EQUAL_INT(LOW, led.front().value);
+    TEST_ASSERT_EQUAL_INT(HIGH, led.back().value);
+}
+
+void test_sweep_steps_frequency(void) {
+    static const AlertStep caw[] = {{1000, 2000, 80, 0, 0}};
+    TEST_ASSERT_TRUE(alertPlay(caw));
+    waitIdle();
+
+    std::vector<ShimEvent> tones = eventsOf(shimEvents(), SHIM_LEDC_TONE);
+    TEST_ASSERT_EQUAL_size_t(80 / 8, tones.size());
+    TEST_ASSERT_EQUAL_INT(1000, tones.front().value);
+    for (size_t i = 1; i < tones.size(); i++) {
+        TEST_ASSERT_TRUE(tones[i].value > tones[i - 1].value);
+    }
+    TEST_ASSERT_TRUE(tones.back().value < 2000);
+}
+
+void test_masks_sound_and_led(void) {
+    static const AlertStep beep[] = {{2000, 0, 20, 0, 1}};
+    TEST_ASSERT_TRUE(alertPlay(beep, false, true));
+    waitIdle();
+    std::vector<ShimEvent> log = shimEvents(true);
+    TEST_ASSERT_EQUAL_size_t(0, eventsOf(log, SHIM_LEDC_TONE).size());
+    TEST_ASSERT_TRUE(eventsOf(log, SHIM_DIGITAL_WRITE).size() > 0);
+
+    TEST_ASSERT_TRUE(alertPlay(beep, true, false));
+    waitIdle();
+    log = shimEvents();
+    TEST_ASSERT_EQUAL_size_t(1, eventsOf(log, SHIM_LEDC_TONE).size());
+    TEST_ASSERT_EQUAL_size_t(0, eventsOf(log, SHIM_DIGITAL_WRITE).size());
+
+    // Both masked: accepted, nothing queued
+    TEST_ASSERT_TRUE(alertPlay(beep, false, false));
+    TEST_ASSERT_FALSE(alertBusy());
+}
+
+void test_queue_depth_bounds_backlog(void) {
+    static const AlertStep beep[] = {{2000, 0, 30, 0, 0}};
+    int accepted = 0;
+    for (int i = 0; i < ALERT_QUEUE_DEPTH + 6; i++) accepted += alertPlay(beep) ? 1 : 0;
+    // The task may already hold one pattern, so at most one extra fits
+    TEST_ASSERT_TRUE(accepted >= ALERT_QUEUE_DEPTH && accepted <= ALERT_QUEUE_DEPTH + 1);
+    waitIdle();
+    TEST_ASSERT_EQUAL_size_t((size_t)accepted, eventsOf(shimEvents(), SHIM_LEDC_TONE).size());
+}
+
+void test_long_pattern_is_truncated(void) {
+    AlertStep steps[ALERT_MAX_STEPS + 4];
+    for (size_t i = 0; i < ALERT_MAX_STEPS + 4; i++) steps[i] = {(uint16_t)(1000 + i), 0, 2, 0, 0};
+    TEST_ASSERT_TRUE(alertPlay(steps));
+    waitIdle();
+    TEST_ASSERT_EQUAL_size_t(ALERT_MAX_STEPS, eventsOf(shimEvents(), SHIM_LEDC_TONE).size());
+}
+
+// What the NimBLE callback pays: time spent in alertPlay() while the task
+// is playing, with the queue both filling and full
+void test_play_returns_in_microseconds(void) {
+    static const AlertStep threeBeeps[] = {
+        {2000, 0, 50, 0, 1}, {0, 0, 20, 0, 0},
+        {2000, 0, 50, 0, 1}, {0, 0, 20, 0, 0},
+        {2000, 0, 50, 0, 1}
+    };
+    const int calls = 2000;
+    std::vector<double> us;
+    us.reserve(calls);
+    for (int i = 0; i < calls; i++) {
+        auto start = std::chrono::steady_clock::now();
+        alertPlay(threeBeeps);
+        us.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+    }
+    std::sort(us.begin(), us.end());
+    double median = us[calls / 2], p99 = us[calls * 99 / 100], worst = us.back();
+
+    char line[120];
+    snprintf(line, sizeof(line), "alertPlay: median %.2f us, p99 %.2f us, max %.2f us", median, p99, worst);
+    TEST_MESSAGE(line);
+
+    // A blocking beep is 200 ms per tone; anything near a millisecond means
+    // the caller waited on the player
+    TEST_ASSERT_TRUE(median < 50);
+    TEST_ASSERT_TRUE(p99 < 500);
+    waitIdle();
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_play_before_begin_is_rejected);
+    alertBegin(TEST_BUZZER_PIN, TEST_LED_PIN, true, TEST_CHANNEL);
+    RUN_TEST(test_beep_drives_buzzer_and_led);
+    RUN_TEST(test_sweep_steps_frequency);
+    RUN_TEST(test_masks_sound_and_led);
+    RUN_TEST(test_queue_depth_bounds_backlog);
+    RUN_TEST(test_long_pattern_is_truncated);
+    RUN_TEST(test_play_returns_in_microseconds);
+    return UNITY_END();
+}
@@ -0,0 +1,289 @@
+/*
+ * DeviceTable behaviour, and the Detector advertisement microbenchmark:
+ * heap allocations and time per advertisement for the original String
+ * path (modelled with std::string) against the native-address path.
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <chrono>
+#include <new>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <array>
+#include "device_table.h"
+#include "mac_watchlist.h"
+
+// Count every heap allocation made by the code under test
+static size_t allocCount = 0;
+
+void* operator new(size_t size) {
+    allocCount++;
+    void* p = malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+struct TestEntry {
+    uint64_t macKey;
+    unsigned long lastSeen;
+};
+
+static uint64_t rngState = 0x2545F4914F6CDD1DULL;
+
+static uint64_t nextRandom() {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 7;
+    rngState ^= rngState << 17;
+    return rngState;
+}
+
+static std::vector<uint8_t> tableMemory;
+
+static void attachTable(DeviceTable<TestEntry>& table, size_t capacity) {
+    tableMemory.assign(DeviceTable<TestEntry>::bytesFor(capacity), 0);
+    TEST_ASSERT_TRUE(table.attach(tableMemory.data(), capacity));
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_attach_rejects_bad_capacity(void) {
+    DeviceTable<TestEntry> table;
+    uint8_t mem[64];
+    TEST_ASSERT_FALSE(table.attach(nullptr, 4));
+    TEST_ASSERT_FALSE(table.attach(mem, 0));
+    TEST_ASSERT_FALSE(table.attach(mem, DEVICE_SLOT_NONE));
+    TEST_ASSERT_NULL(table.find(1));
+    TEST_ASSERT_NULL(table.insert(1));
+}
+
+void test_insert_find_and_recency(void) {
+    DeviceTable<TestEntry> table;
+    attachTable(table, 4);
+    for (uint64_t mac = 1; mac <= 3; mac++) table.insert(mac);
+    TEST_ASSERT_EQUAL_size_t(3, table.size());
+    TEST_ASSERT_EQUAL_HEX64(2, table.find(2)->macKey);
+    TEST_ASSERT_NULL(table.find(4));
+
+    table.touch(table.find(1));
+    const uint64_t expected[] = {1, 3, 2};
+    size_t i = 0;
+    for (TestEntry* e = table.newest(); e; e = table.older(e)) {
+        TEST_ASSERT_EQUAL_HEX64(expected[i++], e->macKey);
+    }
+    TEST_ASSERT_EQUAL_size_t(3, i);
+}
+
+void test_full_table_evicts_least_recent(void) {
+    DeviceTable<TestEntry> table;
+    attachTable(table, 3);
+    table.insert(10);
+    table.insert(20);
+    table.insert(30);
+    table.touch(table.find(10));
+    table.insert(40);  // Evicts 20
+    TEST_ASSERT_EQUAL_size_t(3, table.size());
+    TEST_ASSERT_EQUAL_UINT32(1, table.evicted());
+    TEST_ASSERT_NULL(table.find(20));
+    TEST_ASSERT_NOT_NULL(table.find(10));
+    TEST_ASSERT_NOT_NULL(table.find(30));
+    TEST_ASSERT_NOT_NULL(table.find(40));
+}
+
+// Random churn against a reference map and recency list: eviction must
+// keep every probe chain intact
+void test_churn_matches_reference(void) {
+    const size_t capacity = 64;
+    DeviceTable<TestEntry> table;
+    attachTable(table, capacity);
+    std::vector<uint64_t> lru;  // Front = newest
+
+    for (int step = 0; step < 20000; step++) {
+        uint64_t mac = nextRandom() % 160 + 1;
+        TestEntry* e = table.find(mac);
+        auto it = std::find(lru.begin(), lru.end(), mac);
+        TEST_ASSERT_EQUAL(it != lru.end(), e != nullptr);
+        if (e) {
+            table.touch(e);
+            lru.erase(it);
+        } else {
+            table.insert(mac);
+            if (lru.size() == capacity) lru.pop_back();
+        }
+        lru.insert(lru.begin(), mac);
+    }
+
+    TEST_ASSERT_EQUAL_size_t(lru.size(), table.size());
+    size_t i = 0;
+    for (TestEntry* e = table.newest(); e; e = table.older(e)) {
+        TEST_ASSERT_EQUAL_HEX64(lru[i++], e->macKey);
+    }
+    for (uint64_t mac = 1; mac <= 160; mac++) {
+        bool listed = std::find(lru.begin(), lru.end(), mac) != lru.end();
+        TEST_ASSERT_EQUAL(listed, table.find(mac) != nullptr);
+    }
+}
+
+// ---- Benchmark -----------------------------------------------------------
+
+#define BENCH_FILTERS 50
+#define BENCH_DEVICES 300
+#define BENCH_ADVERTS 200000
+
+struct BenchFilter {
+    std::string identifier;
+    bool isFullMAC;
+    std::string description;
+};
+
+// Original code: String address, per-filter normalization, linear device scan
+struct LegacyDevice {
+    std::string macAddress;
+    unsigned long lastSeen;
+    std::string filterDescription;
+};
+
+static std::vector<BenchFilter> benchFilters;
+static std::vector<LegacyDevice> legacyDevices;
+static std::string detectedMAC, matchedFilter, matchType;
+
+static std::string toStringNative(const uint8_t* native) {
+    char text[18];
+    formatMACKey(macKeyFromNative(native), text, sizeof(text));
+    return std::string(text);
+}
+
+static void normalizeMAC(std::string& mac) {
+    for (char& c : mac) {
+        c = (char)tolower((unsigned char)c);
+        if (c == '-') c = ':';
+    }
+}
+
+static bool legacyMatch(const std::string& deviceMAC, std::string& description) {
+    std::string normalized = deviceMAC;
+    normalizeMAC(normalized);
+    for (const BenchFilter& f : benchFilters) {
+        std::string id = f.identifier;
+        normalizeMAC(id);
+        bool hit = f.isFullMAC ? normalized == id : normalized.compare(0, id.size(), id) == 0;
+        if (hit) {
+            description = f.description;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void legacyOnResult(const uint8_t* native, unsigned long now) {
+    std::string mac = toStringNative(native);
+    std::string description;
+    if (!legacyMatch(mac, description)) return;
+    for (LegacyDevice& dev : legacyDevices) {
+        if (dev.macAddress == mac) {
+            if (now - dev.lastSeen >= 3000) {
+                detectedMAC = mac;
+                matchedFilter = description;
+                matchType = "RE-3s";
+            }
+            dev.lastSeen = now;
+            return;
+        }
+    }
+    legacyDevices.push_back({mac, now, description});
+    detectedMAC = mac;
+    matchedFilter = description;
+    matchType = "NEW";
+}
+
+// Current code: integer key, compiled watchlist, hashed table, event struct
+static MacWatchlist benchWatchlist;
+static DeviceTable<TestEntry> benchTable;
+static uint64_t lastEventKey;
+
+static void nativeOnResult(const uint8_t* native, unsigned long now) {
+    const uint64_t mac = macKeyFromNative(native);
+    if (benchWatchlist.find(mac) == MAC_WATCHLIST_NONE) return;
+    TestEntry* dev = benchTable.find(mac);
+    if (dev) {
+        benchTable.touch(dev);
+        if (now - dev->lastSeen >= 3000) lastEventKey = mac;
+        dev->lastSeen = now;
+        return;
+    }
+    dev = benchTable.insert(mac);
+    dev->lastSeen = now;
+    lastEventKey = mac;
+}
+
+struct BenchResult {
+    double nsPerAdvert;
+    size_t allocations;
+};
+
+template <typename Fn>
+static BenchResult runBench(Fn onResult, const std::vector<std::array<uint8_t, 6>>& adverts) {
+    size_t before = allocCount;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < BENCH_ADVERTS; i++) {
+        onResult(adverts[i % adverts.size()].data(), (unsigned long)i);
+    }
+    double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return {s * 1e9 / BENCH_ADVERTS, allocCount - before};
+}
+
+void test_benchmark_advert_paths(void) {
+    // Half the filters are OUIs, half full MACs; a quarter of the traffic
+    // comes from listed devices, the rest is background noise
+    std::vector<uint64_t> listed;
+    char text[18];
+    for (size_t i = 0; i < BENCH_FILTERS; i++) {
+        uint64_t mac = nextRandom() & 0xFFFFFFFFFFFFULL;
+        formatMACKey(mac, text, sizeof(text));
+        bool full = i & 1;
+        benchFilters.push_back({full ? std::string(text) : std::string(text, 8), full, "Filter " + std::to_string(i)});
+        benchWatchlist.add(benchFilters.back().identifier.c_str(), full, i);
+        for (int d = 0; d < (full ? 1 : BENCH_DEVICES / BENCH_FILTERS); d++) {
+            listed.push_back(full ? mac : (mac & 0xFFFFFF000000ULL) | (nextRandom() & 0xFFFFFF));
+        }
+    }
+    benchWatchlist.build();
+    attachTable(benchTable, 2048);
+
+    std::vector<std::array<uint8_t, 6>> adverts(4096);
+    for (size_t i = 0; i < adverts.size(); i++) {
+        uint64_t mac = (i % 4 == 0) ? listed[nextRandom() % listed.size()] : (nextRandom() & 0xFFFFFFFFFFFFULL);
+        for (int b = 0; b < 6; b++) adverts[i][b] = (uint8_t)(mac >> (8 * b));
+    }
+
+    BenchResult legacy = runBench(legacyOnResult, adverts);
+    BenchResult current = runBench(nativeOnResult, adverts);
+
+    char line[160];
+    snprintf(line, sizeof(line), "String path: %.0f ns/advert, %.2f allocations/advert",
+             legacy.nsPerAdvert, (double)legacy.allocations / BENCH_ADVERTS);
+    TEST_MESSAGE(line);
+    snprintf(line, sizeof(line), "Native path: %.0f ns/advert, %.2f allocations/advert",
+             current.nsPerAdvert, (double)current.allocations / BENCH_ADVERTS);
+    TEST_MESSAGE(line);
+
+    TEST_ASSERT_EQUAL_size_t(0, current.allocations);
+    TEST_ASSERT_GREATER_THAN(BENCH_ADVERTS, legacy.allocations);
+    TEST_ASSERT_EQUAL_size_t(legacyDevices.size(), benchTable.size());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_attach_rejects_bad_capacity);
+    RUN_TEST(test_insert_find_and_recency);
+    RUN_TEST(test_full_table_evicts_least_recent);
+    RUN_TEST(test_churn_matches_reference);
+    RUN_TEST(test_benchmark_advert_paths);
+    return UNITY_END();
+}
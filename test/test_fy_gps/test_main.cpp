@@ -0,0 +1,219 @@
+/*
+ * GPS fixes: NMEA through TinyGPS++ into FYFix, and SeqLock publication.
+ * A writer feeds a recorded-style 10 Hz GGA+RMC stream in UART-sized
+ * chunks while readers poll the seqlock the way the BLE callback does.
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include "fy_gps.h"
+
+#define HDOP_SCALE 5.0f
+#define UART_CHUNK 120  // Bytes per UART FIFO-threshold burst
+
+static std::string nmea(const char* body) {
+    uint8_t sum = 0;
+    for (const char* p = body; *p; p++) sum ^= (uint8_t)*p;
+    char tail[8];
+    snprintf(tail, sizeof(tail), "*%02X\r\n", sum);
+    return std::string("$") + body + tail;
+}
+
+static void nmeaCoord(double deg, bool isLat, char* out, size_t n, char* hemi) {
+    *hemi = isLat ? (deg < 0 ? 'S' : 'N') : (deg < 0 ? 'W' : 'E');
+    deg = fabs(deg);
+    int whole = (int)deg;
+    snprintf(out, n, isLat ? "%02d%08.5f" : "%03d%08.5f", whole, (deg - whole) * 60);
+}
+
+// One 10 Hz epoch: GGA then RMC for the same position
+static std::string nmeaEpoch(int tenths, double lat, double lon, float hdop) {
+    char la[20], lo[20], ns, ew, body[128];
+    nmeaCoord(lat, true, la, sizeof(la), &ns);
+    nmeaCoord(lon, false, lo, sizeof(lo), &ew);
+    int s = tenths / 10;
+    char hms[16];
+    snprintf(hms, sizeof(hms), "%02d%02d%02d.%d0", 12 + s / 3600, s / 60 % 60, s % 60, tenths % 10);
+    snprintf(body, sizeof(body), "GNGGA,%s,%s,%c,%s,%c,1,09,%.1f,12.0,M,-34.0,M,,", hms, la, ns, lo, ew, hdop);
+    std::string out = nmea(body);
+    snprintf(body, sizeof(body), "GNRMC,%s,A,%s,%c,%s,%c,33.5,45.0,161026,,,A", hms, la, ns, lo, ew);
+    return out + nmea(body);
+}
+
+// Feeds text the way fyGPSTask does; returns fixes published
+static int feed(TinyGPSPlus& gps, FYFixLock& lock, const std::string& text) {
+    int published = 0;
+    for (size_t off = 0; off < text.size(); off += UART_CHUNK) {
+        size_t n = std::min((size_t)UART_CHUNK, text.size() - off);
+        for (size_t i = 0; i < n; i++) {
+            if (!gps.encode(text[off + i])) continue;
+            FYFix f;
+            if (fyGPSTakeFix(gps, HDOP_SCALE, f)) {
+                lock.write(f);
+                published++;
+            }
+        }
+    }
+    return published;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_seqlock_empty_then_latest(void) {
+    FYFixLock lock;
+    FYFix f;
+    TEST_ASSERT_FALSE(lock.read(f));
+    TEST_ASSERT_EQUAL_UINT32(0, lock.writes());
+    FYFix a = {40.5, -74.25, 3.5f, 1234, true};
+    lock.write(a);
+    a.lat = 41.0;
+    lock.write(a);
+    TEST_ASSERT_TRUE(lock.read(f));
+    TEST_ASSERT_EQUAL_UINT32(2, lock.writes());
+    TEST_ASSERT_TRUE(f.lat == 41.0 && f.lon == -74.25 && f.acc == 3.5f && f.ms == 1234 && f.hw);
+}
+
+void test_fix_from_gga(void) {
+    TinyGPSPlus gps;
+    FYFixLock lock;
+    TEST_ASSERT_EQUAL_INT(2, feed(gps, lock, nmeaEpoch(0, 40.7128, -74.0060, 1.2f)));
+    FYFix f;
+    TEST_ASSERT_TRUE(lock.read(f));
+    TEST_ASSERT_TRUE(fabs(f.lat - 40.7128) < 1e-6);
+    TEST_ASSERT_TRUE(fabs(f.lon + 74.0060) < 1e-6);
+    TEST_ASSERT_TRUE(fabs(f.acc - 6.0f) < 1e-3);
+    TEST_ASSERT_TRUE(f.hw);
+    TEST_ASSERT_TRUE(millis() - f.ms < 50);
+
+    // The flag is consumed: no second fix without a new sentence
+    TEST_ASSERT_FALSE(fyGPSTakeFix(gps, HDOP_SCALE, f));
+}
+
+void test_no_fix_and_bad_checksum_publish_nothing(void) {
+    TinyGPSPlus gps;
+    FYFixLock lock;
+    std::string text = nmea("GNGGA,120000.00,,,,,0,00,99.9,,M,,M,,") +
+                       nmea("GNRMC,120000.00,V,,,,,,,161026,,,N");
+    std::string good = nmeaEpoch(0, 51.5, -0.12, 0.9f);
+    std::string bad = good;
+    bad[good.find('*') - 1] ^= 0x01;  // Last character of the GGA body
+    text += bad.substr(0, good.find('\n') + 1);
+    TEST_ASSERT_EQUAL_INT(0, feed(gps, lock, text));
+    FYFix f;
+    TEST_ASSERT_FALSE(lock.read(f));
+    TEST_ASSERT_EQUAL_UINT32(1, gps.failedChecksum());
+}
+
+void test_10hz_stream_is_published_promptly(void) {
+    const int epochs = 30;  // 3 s of real time
+    TinyGPSPlus gps;
+    FYFixLock lock;
+    std::atomic<bool> done{false};
+    std::atomic<uint32_t> fedAt[epochs];
+    for (auto& a : fedAt) a.store(0);
+
+    // Reader: polls like the BLE callback, records how long after an epoch
+    // was fed its fix became visible
+    uint32_t worstMs = 0, seen = 0;
+    std::thread reader([&] {
+        double lastLat = 0;
+        while (!done.load()) {
+            FYFix f;
+            if (lock.read(f) && f.lat != lastLat) {
+                lastLat = f.lat;
+                int epoch = (int)lround((f.lat - 40.0) / 1e-4);
+                if (epoch >= 0 && epoch < epochs) {
+                    uint32_t lag = millis() - fedAt[epoch].load();
+                    if (lag > worstMs) worstMs = lag;
+                    seen++;
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    });
+
+    int published = 0;
+    auto next = std::chrono::steady_clock::now();
+    for (int i = 0; i < epochs; i++) {
+        std::this_thread::sleep_until(next);
+        next += std::chrono::milliseconds(100);
+        fedAt[i].store(millis());
+        published += feed(gps, lock, nmeaEpoch(i, 40.0 + i * 1e-4, -74.0 - i * 1e-4, 1.0f));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    done.store(true);
+    reader.join();
+
+    FYFix f;
+    TEST_ASSERT_TRUE(lock.read(f));
+    TEST_ASSERT_TRUE(fabs(f.lat - (40.0 + (epochs - 1) * 1e-4)) < 1e-6);
+    TEST_ASSERT_EQUAL_INT(epochs * 2, published);
+    TEST_ASSERT_EQUAL_UINT32(epochs * 2, lock.writes());
+    char line[96];
+    snprintf(line, sizeof(line), "10 Hz: %u/%d epochs seen, worst fed-to-visible %u ms",
+             (unsigned)seen, epochs, (unsigned)worstMs);
+    TEST_MESSAGE(line);
+    TEST_ASSERT_TRUE(seen >= epochs - 1);
+    TEST_ASSERT_TRUE(worstMs < 50);  // The old loop() poll could lag 100 ms
+}
+
+void test_readers_never_see_a_torn_fix(void) {
+    FYFixLock lock;
+    std::atomic<bool> done{false};
+    std::atomic<uint32_t> torn{0}, backwards{0}, reads{0}, started{0};
+
+    auto reader = [&] {
+        unsigned long last = 0;
+        started++;
+        while (!done.load()) {
+            FYFix f;
+            if (!lock.read(f)) continue;
+            // Every field is derived from the same counter
+            if (f.lat != f.ms * 1e-6 || f.lon != -(double)f.ms || f.acc != (float)(f.ms % 1000) ||
+                f.hw != (f.ms & 1)) {
+                torn++;
+            }
+            if (f.ms < last) backwards++;
+            last = f.ms;
+            reads++;
+        }
+    };
+    std::thread r1(reader), r2(reader);
+    while (started.load() < 2) std::this_thread::yield();
+    // Keep writing until the readers have raced plenty of writes
+    uint32_t writes = 0;
+    while (writes < 200000 || (reads.load() < 100000 && writes < 50000000)) {
+        writes++;
+        FYFix f = {writes * 1e-6, -(double)writes, (float)(writes % 1000), writes, (writes & 1) != 0};
+        lock.write(f);
+    }
+    done.store(true);
+    r1.join();
+    r2.join();
+
+    char line[96];
+    snprintf(line, sizeof(line), "%u writes, %u concurrent reads", (unsigned)writes, (unsigned)reads.load());
+    TEST_MESSAGE(line);
+    TEST_ASSERT_EQUAL_UINT32(0, torn.load());
+    TEST_ASSERT_EQUAL_UINT32(0, backwards.load());
+    TEST_ASSERT_EQUAL_UINT32(writes, lock.writes());
+    TEST_ASSERT_TRUE(reads.load() >= 100000);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_seqlock_empty_then_latest);
+    RUN_TEST(test_fix_from_gga);
+    RUN_TEST(test_no_fix_and_bad_checksum_publish_nothing);
+    RUN_TEST(test_10hz_stream_is_published_promptly);
+    RUN_TEST(test_readers_never_see_a_torn_fix);
+    return UNITY_END();
+}
@@ -0,0 +1,154 @@
+/*
+ * JSON splitter: element boundaries with strings, escapes and nesting,
+ * objects split across reads, oversize objects, and a 5 MB legacy session
+ * file streamed through the fixed working set.
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "fy_json_split.h"
+
+// Memory source that returns at most `step` bytes per read, so objects
+// straddle chunk boundaries at every offset
+struct MemSource {
+    const std::string* text;
+    size_t pos;
+    size_t step;
+};
+
+static size_t memRead(void* ctx, uint8_t* buf, size_t len) {
+    MemSource* src = (MemSource*)ctx;
+    size_t n = src->text->size() - src->pos;
+    if (n > len) n = len;
+    if (n > src->step) n = src->step;
+    memcpy(buf, src->text->data() + src->pos, n);
+    src->pos += n;
+    return n;
+}
+
+static FYJsonSplitter* newSplitter(MemSource& src) {
+    FYJsonSplitter* s = (FYJsonSplitter*)calloc(1, sizeof(FYJsonSplitter));
+    s->read = memRead;
+    s->ctx = &src;
+    return s;
+}
+
+static std::vector<std::string> splitAll(const std::string& text, size_t step, uint32_t* skipped = NULL) {
+    MemSource src = {&text, 0, step};
+    FYJsonSplitter* s = newSplitter(src);
+    std::vector<std::string> out;
+    while (fyJsonNextObject(*s)) {
+        TEST_ASSERT_EQUAL_size_t(strlen(s->obj), s->objLen);
+        out.push_back(s->obj);
+    }
+    if (skipped) *skipped = s->skipped;
+    free(s);
+    return out;
+}
+
+// One element the way older firmware wrote /session.json
+static std::string legacyEntry(unsigned i) {
+    char buf[400];
+    snprintf(buf, sizeof(buf),
+             "{\"mac\":\"58:8e:81:%02x:%02x:%02x\",\"name\":\"Penguin-%u \\\"{[\\\\\",\"rssi\":%d,"
+             "\"method\":\"mac_prefix\",\"first\":%u,\"last\":%u,\"count\":%u,\"raven\":%s,\"fw\":\"%s\","
+             "\"gps\":{\"lat\":40.%06u,\"lon\":-74.%06u,\"acc\":%u.5}}",
+             (i >> 16) & 0xFF, (i >> 8) & 0xFF, i & 0xFF, i, -30 - (int)(i % 60),
+             i * 10, i * 10 + 5000, i % 500 + 1, (i & 1) ? "true" : "false", (i & 1) ? "1.3.x" : "",
+             i % 1000000, (i * 7) % 1000000, i % 20);
+    return buf;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_empty_and_blank_input(void) {
+    TEST_ASSERT_EQUAL_size_t(0, splitAll("", 512).size());
+    TEST_ASSERT_EQUAL_size_t(0, splitAll("[]", 512).size());
+    TEST_ASSERT_EQUAL_size_t(0, splitAll(" \n[ \n ] \n", 512).size());
+}
+
+void test_elements_with_tricky_strings(void) {
+    const std::string text =
+        "[\n  {\"a\":\"}\"},\n  {\"b\":\"\\\"}{\\\\\"},{\"c\":[1,{\"d\":2}],\"e\":{}}\n]";
+    for (size_t step = 1; step <= 8; step++) {
+        std::vector<std::string> objs = splitAll(text, step);
+        TEST_ASSERT_EQUAL_size_t(3, objs.size());
+        TEST_ASSERT_EQUAL_STRING("{\"a\":\"}\"}", objs[0].c_str());
+        TEST_ASSERT_EQUAL_STRING("{\"b\":\"\\\"}{\\\\\"}", objs[1].c_str());
+        TEST_ASSERT_EQUAL_STRING("{\"c\":[1,{\"d\":2}],\"e\":{}}", objs[2].c_str());
+    }
+}
+
+void test_oversize_object_skipped(void) {
+    std::string big = "{\"name\":\"" + std::string(FY_JSON_OBJ_MAX, 'x') + "\"}";
+    std::string text = "[" + legacyEntry(1) + "," + big + "," + legacyEntry(2) + "]";
+    uint32_t skipped = 0;
+    std::vector<std::string> objs = splitAll(text, FY_JSON_CHUNK, &skipped);
+    TEST_ASSERT_EQUAL_UINT32(1, skipped);
+    TEST_ASSERT_EQUAL_size_t(2, objs.size());
+    TEST_ASSERT_EQUAL_STRING(legacyEntry(1).c_str(), objs[0].c_str());
+    TEST_ASSERT_EQUAL_STRING(legacyEntry(2).c_str(), objs[1].c_str());
+}
+
+void test_largest_object_that_fits(void) {
+    std::string prefix = "{\"n\":\"", suffix = "\"}";
+    std::string fits = prefix + std::string(FY_JSON_OBJ_MAX - 1 - prefix.size() - suffix.size(), 'y') + suffix;
+    std::vector<std::string> objs = splitAll("[" + fits + "]", 100);
+    TEST_ASSERT_EQUAL_size_t(1, objs.size());
+    TEST_ASSERT_EQUAL_size_t(FY_JSON_OBJ_MAX - 1, objs[0].size());
+}
+
+void test_truncated_file_drops_partial_element(void) {
+    std::string text = "[" + legacyEntry(1) + "," + legacyEntry(2);
+    text.resize(text.size() - 10);
+    std::vector<std::string> objs = splitAll(text, FY_JSON_CHUNK);
+    TEST_ASSERT_EQUAL_size_t(1, objs.size());
+}
+
+void test_5mb_session_file(void) {
+    std::string text = "[\n";
+    unsigned entries = 0;
+    while (text.size() < 5u * 1024 * 1024) {
+        if (entries) text += ",\n";
+        text += legacyEntry(entries++);
+    }
+    text += "\n]\n";
+
+    MemSource src = {&text, 0, FY_JSON_CHUNK};
+    FYJsonSplitter* s = newSplitter(src);
+    unsigned seen = 0, mismatched = 0;
+    auto start = std::chrono::steady_clock::now();
+    while (fyJsonNextObject(*s)) {
+        if (legacyEntry(seen) != s->obj) mismatched++;
+        seen++;
+    }
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    char line[160];
+    snprintf(line, sizeof(line), "%.1f MB, %u entries, %u-byte working set, %.0f MB/s on the host",
+             text.size() / 1048576.0, seen, (unsigned)sizeof(FYJsonSplitter), text.size() / secs / 1048576.0);
+    TEST_MESSAGE(line);
+
+    TEST_ASSERT_EQUAL_UINT32(entries, seen);
+    TEST_ASSERT_EQUAL_UINT32(0, mismatched);
+    TEST_ASSERT_EQUAL_UINT32(0, s->skipped);
+    TEST_ASSERT_TRUE(sizeof(FYJsonSplitter) < 2048);
+    free(s);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_and_blank_input);
+    RUN_TEST(test_elements_with_tricky_strings);
+    RUN_TEST(test_oversize_object_skipped);
+    RUN_TEST(test_largest_object_that_fits);
+    RUN_TEST(test_truncated_file_drops_partial_element);
+    RUN_TEST(test_5mb_session_file);
+    return UNITY_END();
+}
@@ -0,0 +1,135 @@
+/*
+ * Raven services: UUID parse/format round trip, the binary service lookup
+ * and every firmware-estimation branch.
+ */
+
+#include <unity.h>
+#include <string.h>
+#include <vector>
+#include "fy_raven.h"
+
+static std::vector<FYSigService> services;
+
+// Native bytes of a role's UUID, as NimBLE hands them over
+static void nativeOf(int role, uint8_t* out) {
+    TEST_ASSERT_TRUE(fyParseUUID128(raven_service_uuids[role], out));
+}
+
+static uint32_t maskOf(const int* roles, size_t count) {
+    uint32_t mask = 0;
+    uint8_t uuid[16];
+    for (size_t i = 0; i < count; i++) {
+        nativeOf(roles[i], uuid);
+        mask |= fyServiceBit(services, uuid);
+    }
+    return mask;
+}
+
+void setUp(void) {
+    fyRavenServices(services);
+}
+
+void tearDown(void) {}
+
+void test_parse_is_least_significant_first(void) {
+    uint8_t uuid[16];
+    TEST_ASSERT_TRUE(fyParseUUID128("0000180A-0000-1000-8000-00805F9B34FB", uuid));
+    TEST_ASSERT_EQUAL_HEX8(0xfb, uuid[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x34, uuid[1]);
+    TEST_ASSERT_EQUAL_HEX8(0x0a, uuid[12]);
+    TEST_ASSERT_EQUAL_HEX8(0x18, uuid[13]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, uuid[15]);
+}
+
+void test_parse_rejects_malformed(void) {
+    uint8_t uuid[16];
+    TEST_ASSERT_FALSE(fyParseUUID128("", uuid));
+    TEST_ASSERT_FALSE(fyParseUUID128("0000180a-0000-1000-8000-00805f9b34f", uuid));    // 31 digits
+    TEST_ASSERT_FALSE(fyParseUUID128("0000180a-0000-1000-8000-00805f9b34fb0", uuid));  // 33 digits
+    TEST_ASSERT_FALSE(fyParseUUID128("0000180g-0000-1000-8000-00805f9b34fb", uuid));
+    TEST_ASSERT_TRUE(fyParseUUID128("0000180a00001000800000805f9b34fb", uuid));        // No dashes
+}
+
+void test_format_round_trip(void) {
+    for (int s = 0; s < FY_SVC_COUNT; s++) {
+        uint8_t uuid[16], back[16];
+        char text[37];
+        nativeOf(s, uuid);
+        fyFormatUUID128(uuid, text);
+        TEST_ASSERT_EQUAL_STRING(raven_service_uuids[s], text);
+        TEST_ASSERT_TRUE(fyParseUUID128(text, back));
+        TEST_ASSERT_EQUAL_MEMORY(uuid, back, 16);
+    }
+}
+
+void test_builtin_table_sorted_and_complete(void) {
+    TEST_ASSERT_EQUAL_size_t(FY_SVC_COUNT, services.size());
+    uint32_t bits = 0;
+    for (size_t i = 0; i < services.size(); i++) {
+        if (i > 0) TEST_ASSERT_TRUE(fySigServiceLess(services[i - 1], services[i]));
+        bits |= FY_SVC_BIT(services[i].bit);
+    }
+    TEST_ASSERT_EQUAL_HEX32(FY_SVC_BIT(FY_SVC_COUNT) - 1, bits);
+}
+
+void test_service_bit_lookup(void) {
+    uint8_t uuid[16];
+    for (int s = 0; s < FY_SVC_COUNT; s++) {
+        nativeOf(s, uuid);
+        TEST_ASSERT_EQUAL_HEX32(FY_SVC_BIT(s), fyServiceBit(services, uuid));
+    }
+    // Same 16-bit alias on another base, and an unrelated service
+    TEST_ASSERT_TRUE(fyParseUUID128("0000180a-0000-1000-8000-00805f9b34fc", uuid));
+    TEST_ASSERT_EQUAL_HEX32(0, fyServiceBit(services, uuid));
+    TEST_ASSERT_TRUE(fyParseUUID128("6e400001-b5a3-f393-e0a9-e50e24dcca9e", uuid));
+    TEST_ASSERT_EQUAL_HEX32(0, fyServiceBit(services, uuid));
+    TEST_ASSERT_EQUAL_HEX32(0, fyServiceBit(std::vector<FYSigService>(), uuid));
+}
+
+void test_firmware_1_1(void) {
+    const int oldUnit[] = {FY_SVC_DEVICE_INFO, FY_SVC_OLD_HEALTH, FY_SVC_OLD_LOCATION};
+    TEST_ASSERT_EQUAL_STRING("1.1.x", estimateRavenFW(maskOf(oldUnit, 3)));
+    const int locOnly[] = {FY_SVC_OLD_LOCATION};
+    TEST_ASSERT_EQUAL_STRING("1.1.x", estimateRavenFW(maskOf(locOnly, 1)));
+    // Old location plus power but no new GPS is still 1.1
+    const int locPower[] = {FY_SVC_OLD_LOCATION, FY_SVC_POWER};
+    TEST_ASSERT_EQUAL_STRING("1.1.x", estimateRavenFW(maskOf(locPower, 2)));
+}
+
+void test_firmware_1_2(void) {
+    const int unit[] = {FY_SVC_DEVICE_INFO, FY_SVC_GPS, FY_SVC_NETWORK, FY_SVC_UPLOAD};
+    TEST_ASSERT_EQUAL_STRING("1.2.x", estimateRavenFW(maskOf(unit, 4)));
+    // New GPS wins over a leftover old location service
+    const int mixed[] = {FY_SVC_GPS, FY_SVC_OLD_LOCATION};
+    TEST_ASSERT_EQUAL_STRING("1.2.x", estimateRavenFW(maskOf(mixed, 2)));
+}
+
+void test_firmware_1_3(void) {
+    const int unit[] = {FY_SVC_DEVICE_INFO, FY_SVC_GPS, FY_SVC_POWER, FY_SVC_NETWORK,
+                        FY_SVC_UPLOAD, FY_SVC_ERROR};
+    TEST_ASSERT_EQUAL_STRING("1.3.x", estimateRavenFW(maskOf(unit, 6)));
+    const int all[] = {0, 1, 2, 3, 4, 5, 6, 7};
+    TEST_ASSERT_EQUAL_STRING("1.3.x", estimateRavenFW(maskOf(all, FY_SVC_COUNT)));
+}
+
+void test_firmware_unknown(void) {
+    TEST_ASSERT_EQUAL_STRING("?", estimateRavenFW(0));
+    const int noLocation[] = {FY_SVC_DEVICE_INFO, FY_SVC_POWER, FY_SVC_NETWORK, FY_SVC_ERROR};
+    TEST_ASSERT_EQUAL_STRING("?", estimateRavenFW(maskOf(noLocation, 4)));
+    // Uploaded services with no firmware role do not change the estimate
+    TEST_ASSERT_EQUAL_STRING("?", estimateRavenFW(FY_SVC_BIT(FY_SVC_OTHER) | FY_SVC_BIT(31)));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_parse_is_least_significant_first);
+    RUN_TEST(test_parse_rejects_malformed);
+    RUN_TEST(test_format_round_trip);
+    RUN_TEST(test_builtin_table_sorted_and_complete);
+    RUN_TEST(test_service_bit_lookup);
+    RUN_TEST(test_firmware_1_1);
+    RUN_TEST(test_firmware_1_2);
+    RUN_TEST(test_firmware_1_3);
+    RUN_TEST(test_firmware_unknown);
+    return UNITY_END();
+}
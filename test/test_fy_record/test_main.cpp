@@ -0,0 +1,326 @@
+/*
+ * Session record log: sealing, validation, and replay of a log whose
+ * final write was torn or whose middle was corrupted; budget planning
+ * when a compacted copy does not fit.
+ */
+
+#include <unity.h>
+#include <string.h>
+#include <stdio.h>
+#include <vector>
+#include "fy_record.h"
+
+// A log held in memory, read in whatever sizes replay asks for
+struct MemLog {
+    const std::vector<uint8_t>* bytes;
+    size_t pos;
+};
+
+static size_t memRead(void* ctx, uint8_t* buf, size_t len) {
+    MemLog* log = (MemLog*)ctx;
+    size_t n = log->bytes->size() - log->pos;
+    if (n > len) n = len;
+    memcpy(buf, log->bytes->data() + log->pos, n);
+    log->pos += n;
+    return n;
+}
+
+static void collect(void* ctx, const FYSessionRecord& r) {
+    ((std::vector<FYSessionRecord>*)ctx)->push_back(r);
+}
+
+static FYSessionRecord makeRecord(uint32_t i) {
+    FYSessionRecord r;
+    memset(&r, 0, sizeof(r));
+    r.macKey = 0xAABBCC000000ULL + i;
+    r.firstSeen = 1000 * i;
+    r.lastSeen = 1000 * i + 500;
+    r.count = i + 1;
+    r.rssi = -40 - (int)i;
+    r.flags = (i & 1) ? FY_REC_RAVEN : FY_REC_GPS;
+    r.gpsLat = 40.0 + i * 1e-4;
+    r.gpsLon = -74.0 - i * 1e-4;
+    snprintf(r.name, sizeof(r.name), "Penguin-%u", (unsigned)i);
+    snprintf(r.method, sizeof(r.method), "mac_prefix");
+    fyRecordSeal(r);
+    return r;
+}
+
+static std::vector<uint8_t> makeLog(uint32_t records) {
+    std::vector<uint8_t> bytes;
+    for (uint32_t i = 0; i < records; i++) {
+        FYSessionRecord r = makeRecord(i);
+        const uint8_t* p = (const uint8_t*)&r;
+        bytes.insert(bytes.end(), p, p + sizeof(r));
+    }
+    return bytes;
+}
+
+static uint32_t replay(const std::vector<uint8_t>& bytes, std::vector<FYSessionRecord>* out = NULL) {
+    std::vector<FYSessionRecord> sink;
+    MemLog log = {&bytes, 0};
+    return fyRecordReplay(memRead, &log, collect, out ? out : &sink);
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_crc32_known_value(void) {
+    // Standard check value for CRC-32/ISO-HDLC
+    const char* text = "123456789";
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, fyCrc32(0, (const uint8_t*)text, 9));
+    // Chained over two pieces equals one pass
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, fyCrc32(fyCrc32(0, (const uint8_t*)text, 4), (const uint8_t*)text + 4, 5));
+}
+
+void test_sealed_record_is_valid(void) {
+    FYSessionRecord r = makeRecord(7);
+    TEST_ASSERT_EQUAL_HEX32(FY_REC_MAGIC, r.magic);
+    TEST_ASSERT_TRUE(fyRecordValid(r));
+}
+
+void test_unsealed_record_is_invalid(void) {
+    FYSessionRecord r;
+    memset(&r, 0, sizeof(r));
+    TEST_ASSERT_FALSE(fyRecordValid(r));
+    r.magic = FY_REC_MAGIC;
+    TEST_ASSERT_FALSE(fyRecordValid(r));
+}
+
+void test_any_flipped_bit_invalidates(void) {
+    FYSessionRecord good = makeRecord(3);
+    for (size_t byte = 0; byte < sizeof(good); byte++) {
+        for (int bit = 0; bit < 8; bit++) {
+            FYSessionRecord r = good;
+            ((uint8_t*)&r)[byte] ^= (uint8_t)(1 << bit);
+            TEST_ASSERT_FALSE(fyRecordValid(r));
+        }
+    }
+}
+
+void test_replay_whole_log_in_order(void) {
+    std::vector<FYSessionRecord> out;
+    TEST_ASSERT_EQUAL_UINT32(0, replay(std::vector<uint8_t>()));
+    TEST_ASSERT_EQUAL_UINT32(50, replay(makeLog(50), &out));
+    TEST_ASSERT_EQUAL_size_t(50, out.size());
+    for (uint32_t i = 0; i < 50; i++) {
+        TEST_ASSERT_EQUAL_HEX64(0xAABBCC000000ULL + i, out[i].macKey);
+        TEST_ASSERT_EQUAL_STRING(makeRecord(i).name, out[i].name);
+    }
+}
+
+void test_torn_tail_keeps_every_whole_record(void) {
+    // A reset can cut the last append anywhere
+    std::vector<uint8_t> full = makeLog(10);
+    for (size_t cut = 1; cut < sizeof(FYSessionRecord); cut++) {
+        std::vector<uint8_t> torn(full.begin(), full.end() - cut);
+        TEST_ASSERT_EQUAL_UINT32(9, replay(torn));
+    }
+}
+
+void test_torn_tail_with_garbage(void) {
+    // Flash erased to 0xFF, or a partly programmed record of the right size
+    std::vector<uint8_t> log = makeLog(4);
+    log.insert(log.end(), sizeof(FYSessionRecord), 0xFF);
+    TEST_ASSERT_EQUAL_UINT32(4, replay(log));
+
+    log = makeLog(5);
+    memset(log.data() + 4 * sizeof(FYSessionRecord) + 60, 0xFF, sizeof(FYSessionRecord) - 60);
+    TEST_ASSERT_EQUAL_UINT32(4, replay(log));
+}
+
+void test_corrupt_record_stops_replay(void) {
+    std::vector<uint8_t> log = makeLog(20);
+    log[7 * sizeof(FYSessionRecord) + offsetof(FYSessionRecord, count)] ^= 0x01;
+    std::vector<FYSessionRecord> out;
+    TEST_ASSERT_EQUAL_UINT32(7, replay(log, &out));
+    TEST_ASSERT_EQUAL_HEX64(0xAABBCC000006ULL, out.back().macKey);
+}
+
+void test_field_offsets_are_stable(void) {
+    // Older logs must still parse: these offsets are the on-flash format
+    TEST_ASSERT_EQUAL_size_t(8, offsetof(FYSessionRecord, macKey));
+    TEST_ASSERT_EQUAL_size_t(48, offsetof(FYSessionRecord, rssi));
+    TEST_ASSERT_EQUAL_size_t(52, offsetof(FYSessionRecord, name));
+    TEST_ASSERT_EQUAL_size_t(100, offsetof(FYSessionRecord, method));
+    TEST_ASSERT_EQUAL_size_t(140, offsetof(FYSessionRecord, crc));
+}
+
+// ---------------------------------------------------------------------------
+// Log budgeting
+// ---------------------------------------------------------------------------
+
+static FYLogState logState(uint32_t budget, uint32_t records) {
+    FYLogState s = {budget, records, false, 0, 0};
+    return s;
+}
+
+void test_log_appends_while_little_is_stale(void) {
+    FYLogState s = logState(1000, 120);
+    uint32_t room;
+    TEST_ASSERT_EQUAL_INT(FY_LOG_APPEND, fyLogPlan(s, 100, 10, 0, &room));
+    TEST_ASSERT_EQUAL_UINT32(880, room);
+}
+
+void test_log_compacts_when_stale_and_copy_fits(void) {
+    uint32_t room;
+    // Stale records past 2x live + slack
+    FYLogState s = logState(2000, 2 * 100 + FY_LOG_SLACK + 1);
+    TEST_ASSERT_EQUAL_INT(FY_LOG_COMPACT, fyLogPlan(s, 100, 0, 0, &room));
+    // Pending appends would leave no room for the copy later
+    s = logState(1000, 500);
+    TEST_ASSERT_EQUAL_INT(FY_LOG_COMPACT, fyLogPlan(s, 400, 150, 0, &room));
+    fyLogCompacted(s, 400);
+    TEST_ASSERT_EQUAL_INT(FY_LOG_APPEND, fyLogPlan(s, 400, 150, 0, &room));
+    TEST_ASSERT_EQUAL_UINT32(600, room);
+}
+
+void test_log_keeps_appending_when_copy_cannot_fit(void) {
+    // 700 records + 600 live > 1000: the copy cannot sit beside the old log
+    FYLogState s = logState(1000, 700);
+    uint32_t room;
+    TEST_ASSERT_EQUAL_INT(FY_LOG_APPEND, fyLogPlan(s, 600, 50, 0, &room));
+    TEST_ASSERT_EQUAL_UINT32(300, room);
+
+    // Checkpoint every 15 s: appends fill the budget, then the log stops
+    // growing, and no tick tries a compaction
+    uint32_t compactions = 0, appended = 0;
+    for (uint32_t now = 0; now < 3600000; now += 15000) {
+        FYLogAction act = fyLogPlan(s, 600, 50, now, &room);
+        if (act == FY_LOG_COMPACT) compactions++;
+        if (act == FY_LOG_APPEND) {
+            uint32_t n = room < 50 ? room : 50;
+            s.records += n;
+            appended += n;
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, compactions);
+    TEST_ASSERT_EQUAL_UINT32(300, appended);
+    TEST_ASSERT_EQUAL_UINT32(1000, s.records);
+    TEST_ASSERT_EQUAL_INT(FY_LOG_FULL, fyLogPlan(s, 600, 50, 0, &room));
+    TEST_ASSERT_EQUAL_UINT32(0, room);
+}
+
+void test_log_torn_tail_waits_for_a_copy_that_fits(void) {
+    // Nothing may follow a torn record, and the rewrite cannot fit yet
+    FYLogState s = logState(1000, 700);
+    s.compact = true;
+    uint32_t room;
+    TEST_ASSERT_EQUAL_INT(FY_LOG_FULL, fyLogPlan(s, 600, 5, 0, &room));
+    TEST_ASSERT_EQUAL_UINT32(0, room);
+    // Flash freed elsewhere raises the budget
+    s.budget = 1300;
+    TEST_ASSERT_EQUAL_INT(FY_LOG_COMPACT, fyLogPlan(s, 600, 5, 0, &room));
+}
+
+void test_log_cleared_pool_always_compacts(void) {
+    FYLogState s = logState(1000, 1000);
+    s.compact = true;
+    uint32_t room;
+    TEST_ASSERT_EQUAL_INT(FY_LOG_COMPACT, fyLogPlan(s, 0, 0, 0, &room));
+}
+
+void test_log_failed_compaction_backs_off(void) {
+    FYLogState s = logState(2000, 900);
+    uint32_t room, attempts = 0;
+    // Stale enough to compact, but every attempt fails: over an hour of 15 s
+    // checkpoints it is retried a handful of times, not 240
+    for (uint32_t now = 1; now < 3600000; now += 15000) {
+        FYLogAction act = fyLogPlan(s, 100, 0, now, &room);
+        if (act == FY_LOG_COMPACT) {
+            attempts++;
+            fyLogCompactFailed(s, now);
+        } else {
+            TEST_ASSERT_EQUAL_INT(FY_LOG_APPEND, act);
+        }
+    }
+    TEST_ASSERT_TRUE(attempts >= 4 && attempts <= 7);
+    TEST_ASSERT_TRUE(s.backoffMs <= FY_LOG_BACKOFF_MAX);
+
+    // Capped, and reset by a success
+    for (int i = 0; i < 20; i++) fyLogCompactFailed(s, 0);
+    TEST_ASSERT_EQUAL_UINT32(FY_LOG_BACKOFF_MAX, s.backoffMs);
+    fyLogCompacted(s, 100);
+    TEST_ASSERT_EQUAL_UINT32(0, s.backoffMs);
+    TEST_ASSERT_EQUAL_UINT32(100, s.records);
+}
+
+void test_log_backoff_survives_millis_wrap(void) {
+    FYLogState s = logState(2000, 900);
+    uint32_t room;
+    uint32_t now = 0xFFFFFFFFUL - 10000;
+    fyLogCompactFailed(s, now);
+    TEST_ASSERT_EQUAL_INT(FY_LOG_APPEND, fyLogPlan(s, 100, 0, now + 30000, &room));
+    TEST_ASSERT_EQUAL_INT(FY_LOG_COMPACT, fyLogPlan(s, 100, 0, now + FY_LOG_BACKOFF_MS, &room));
+}
+
+void test_storage_plan_splits_partition(void) {
+    // 1 MB of records: the pool gets a quarter, the log 3x plus slack
+    FYStoragePlan p = fyStoragePlan(1024 * 1024, 20000);
+    uint32_t records = 1024 * 1024 / sizeof(FYSessionRecord);
+    TEST_ASSERT_EQUAL_UINT32((records - 2 * FY_LOG_SLACK) / 4, p.capacity);
+    TEST_ASSERT_EQUAL_UINT32(3 * p.capacity + 2 * FY_LOG_SLACK, p.logRecords);
+    TEST_ASSERT_EQUAL_UINT32(records, p.logRecords + p.histRecords);
+    TEST_ASSERT_TRUE(p.histRecords >= p.capacity);
+
+    // A smaller maximum leaves the rest to the history ring
+    p = fyStoragePlan(1024 * 1024, 1000);
+    TEST_ASSERT_EQUAL_UINT32(1000, p.capacity);
+    TEST_ASSERT_EQUAL_UINT32(records - 3000 - 2 * FY_LOG_SLACK, p.histRecords);
+
+    p = fyStoragePlan(2 * FY_LOG_SLACK * sizeof(FYSessionRecord), 20000);
+    TEST_ASSERT_EQUAL_UINT32(0, p.capacity);
+    TEST_ASSERT_EQUAL_UINT32(0, p.logRecords);
+}
+
+void test_storage_plan_pool_never_fills_log(void) {
+    // A filling, then full, pool whose devices keep changing: every
+    // compaction fits, nothing is ever held back, and a full pool is not
+    // rewritten more often than every capacity / 2 appends
+    FYStoragePlan p = fyStoragePlan(600 * 1024, 20000);
+    FYLogState s = {p.logRecords, 0, false, 0, 0};
+    uint32_t live = 0, compactions = 0, appended = 0, seed = 1;
+    for (uint32_t tick = 0; tick < 5000; tick++) {
+        uint32_t pending = (seed = seed * 1103515245 + 12345) % 400;
+        if (live < p.capacity) live += pending / 4;
+        if (live > p.capacity) live = p.capacity;
+        if (pending > live) pending = live;
+        uint32_t room;
+        FYLogAction act = fyLogPlan(s, live, pending, tick * 15000, &room);
+        TEST_ASSERT_NOT_EQUAL(FY_LOG_FULL, act);
+        if (act == FY_LOG_COMPACT) {
+            TEST_ASSERT_TRUE(s.records + live <= s.budget);
+            fyLogCompacted(s, live);
+            compactions++;
+        } else {
+            TEST_ASSERT_TRUE(room >= pending);
+            s.records += pending;
+            appended += pending;
+        }
+    }
+    TEST_ASSERT_TRUE(compactions > 0);
+    TEST_ASSERT_TRUE(compactions <= appended / (p.capacity / 2) + 1);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_crc32_known_value);
+    RUN_TEST(test_sealed_record_is_valid);
+    RUN_TEST(test_unsealed_record_is_invalid);
+    RUN_TEST(test_any_flipped_bit_invalidates);
+    RUN_TEST(test_replay_whole_log_in_order);
+    RUN_TEST(test_torn_tail_keeps_every_whole_record);
+    RUN_TEST(test_torn_tail_with_garbage);
+    RUN_TEST(test_corrupt_record_stops_replay);
+    RUN_TEST(test_field_offsets_are_stable);
+    RUN_TEST(test_log_appends_while_little_is_stale);
+    RUN_TEST(test_log_compacts_when_stale_and_copy_fits);
+    RUN_TEST(test_log_keeps_appending_when_copy_cannot_fit);
+    RUN_TEST(test_log_torn_tail_waits_for_a_copy_that_fits);
+    RUN_TEST(test_log_cleared_pool_always_compacts);
+    RUN_TEST(test_log_failed_compaction_backs_off);
+    RUN_TEST(test_log_backoff_survives_millis_wrap);
+    RUN_TEST(test_storage_plan_splits_partition);
+    RUN_TEST(test_storage_plan_pool_never_fills_log);
+    return UNITY_END();
+}
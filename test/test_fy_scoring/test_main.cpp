@@ -0,0 +1,294 @@
+/*
+ * Detection scoring: labelled advertisement fixtures run through the raw
+ * AD parser and the compiled rule table, plus parser edge cases and a
+ * fuzz pass over random payloads.
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include "fy_scoring.h"
+
+// Same shape as the built-in Flock-You signatures
+static std::vector<uint32_t> ouis = {0x588E81, 0xCCCCCC, 0xEC1BBD, 0x70C94E, 0x3C9180};
+static std::vector<uint16_t> mfrIds = {0x09C8};
+static const char* const namePatterns[] = {"FS Ext Battery", "Penguin", "Flock", "Pigvision"};
+static std::vector<FYSigService> services;
+static NameMatcher names;
+static std::vector<FYRule> rules;
+
+typedef std::vector<uint8_t> Bytes;
+
+static Bytes ad(uint8_t type, const Bytes& data) {
+    Bytes out = {(uint8_t)(data.size() + 1), type};
+    out.insert(out.end(), data.begin(), data.end());
+    return out;
+}
+
+static Bytes adText(uint8_t type, const char* text) {
+    return ad(type, Bytes(text, text + strlen(text)));
+}
+
+static Bytes adMfr(uint16_t company, const Bytes& rest = {}) {
+    Bytes data = {(uint8_t)company, (uint8_t)(company >> 8)};
+    data.insert(data.end(), rest.begin(), rest.end());
+    return ad(0xFF, data);
+}
+
+static Bytes adUuid128(uint8_t type, std::initializer_list<const char*> uuids) {
+    Bytes data;
+    for (const char* u : uuids) {
+        uint8_t native[16];
+        fyParseUUID128(u, native);
+        data.insert(data.end(), native, native + 16);
+    }
+    return ad(type, data);
+}
+
+static Bytes cat(std::initializer_list<Bytes> parts) {
+    Bytes out;
+    for (const Bytes& p : parts) out.insert(out.end(), p.begin(), p.end());
+    return out;
+}
+
+static const Bytes FLAGS = ad(0x01, {0x06});
+
+struct Fixture {
+    const char* label;
+    bool flock;           // Expected verdict
+    uint8_t signals;      // Expected FY_SIG_BIT()s
+    uint8_t mac[6];       // Display order
+    Bytes payload;
+};
+
+static std::vector<Fixture> fixtures() {
+    const uint8_t RANDOM[6] = {0x5A, 0x11, 0x22, 0x33, 0x44, 0x55};
+    const uint8_t FLOCK_OUI[6] = {0x58, 0x8E, 0x81, 0x01, 0x02, 0x03};
+    const uint8_t NEAR_OUI[6] = {0x58, 0x8E, 0x80, 0x01, 0x02, 0x03};
+    auto mac = [](const uint8_t* m, Fixture f) { memcpy(f.mac, m, 6); return f; };
+    uint8_t ravenGpsTweaked[16];
+    fyParseUUID128(RAVEN_GPS_SERVICE, ravenGpsTweaked);
+    ravenGpsTweaked[15] ^= 0x01;
+
+    return {
+        // ---- Positives ----
+        mac(FLOCK_OUI, {"FS Ext Battery OUI, empty payload", true,
+            FY_SIG_BIT(FY_SIG_MAC_OUI), {}, {}}),
+        mac(FLOCK_OUI, {"FS Ext Battery OUI and name", true,
+            FY_SIG_BIT(FY_SIG_MAC_OUI) | FY_SIG_BIT(FY_SIG_NAME), {},
+            cat({FLAGS, adText(0x09, "FS Ext Battery")})}),
+        mac(RANDOM, {"Penguin camera, complete name", true,
+            FY_SIG_BIT(FY_SIG_NAME), {}, cat({FLAGS, adText(0x09, "Penguin-4F2A")})}),
+        mac(RANDOM, {"Lower-case flock in a shortened name", true,
+            FY_SIG_BIT(FY_SIG_NAME), {}, cat({FLAGS, adText(0x08, "flock-cam")})}),
+        mac(RANDOM, {"XUNTONG manufacturer data", true,
+            FY_SIG_BIT(FY_SIG_MFR_ID), {}, cat({FLAGS, adMfr(0x09C8, {0x01, 0x02, 0x03})})}),
+        mac(RANDOM, {"XUNTONG after an Apple entry", true,
+            FY_SIG_BIT(FY_SIG_MFR_ID), {}, cat({FLAGS, adMfr(0x004C, {0x10, 0x05}), adMfr(0x09C8)})}),
+        mac(RANDOM, {"Raven 1.3 service set", true,
+            FY_SIG_BIT(FY_SIG_RAVEN_SVC) | FY_SIG_BIT(FY_SIG_RAVEN_MULTI), {},
+            cat({FLAGS, adUuid128(0x07, {RAVEN_GPS_SERVICE, RAVEN_POWER_SERVICE, RAVEN_NETWORK_SERVICE})})}),
+        mac(RANDOM, {"Raven service in the scan response after padding", true,
+            FY_SIG_BIT(FY_SIG_RAVEN_SVC), {},
+            cat({FLAGS, Bytes{0x00, 0x00}, adUuid128(0x06, {RAVEN_UPLOAD_SERVICE})})}),
+        mac(RANDOM, {"Pigvision name only in the scan response", true,
+            FY_SIG_BIT(FY_SIG_NAME), {},
+            cat({FLAGS, adMfr(0x0059), adText(0x09, "Pigvision")})}),
+        mac(FLOCK_OUI, {"Everything at once", true,
+            FY_SIG_BIT(FY_SIG_MAC_OUI) | FY_SIG_BIT(FY_SIG_NAME) | FY_SIG_BIT(FY_SIG_MFR_ID) |
+            FY_SIG_BIT(FY_SIG_RAVEN_SVC) | FY_SIG_BIT(FY_SIG_RAVEN_MULTI), {},
+            cat({adText(0x09, "Flock"), adMfr(0x09C8),
+                 adUuid128(0x07, {RAVEN_DEVICE_INFO_SERVICE, RAVEN_OLD_HEALTH_SERVICE})})}),
+
+        // ---- Negatives ----
+        mac(RANDOM, {"iPhone: flags and Apple data", false, 0, {},
+            cat({FLAGS, adMfr(0x004C, {0x10, 0x05, 0x01, 0x18})})}),
+        mac(RANDOM, {"Earbuds named Galaxy Buds", false, 0, {},
+            cat({FLAGS, adText(0x09, "Galaxy Buds2 Pro")})}),
+        mac(RANDOM, {"16-bit Device Information alias", false, 0, {},
+            cat({FLAGS, ad(0x03, {0x0A, 0x18})})}),
+        mac(RANDOM, {"Raven GPS UUID with one byte changed", false, 0, {},
+            cat({FLAGS, ad(0x07, Bytes(ravenGpsTweaked, ravenGpsTweaked + 16))})}),
+        mac(RANDOM, {"Name structure running past the payload", false, 0, {},
+            cat({FLAGS, Bytes{0x14, 0x09, 'F', 'l', 'o', 'c', 'k'}})}),
+        mac(RANDOM, {"One-byte manufacturer data", false, 0, {},
+            cat({FLAGS, ad(0xFF, {0xC8})})}),
+        mac(RANDOM, {"XUNTONG bytes swapped", false, 0, {},
+            cat({FLAGS, adMfr(0xC809)})}),
+        mac(RANDOM, {"Name split across two structures", false, 0, {},
+            cat({adText(0x08, "Flo"), adText(0x09, "ckless Speaker")})}),
+        mac(RANDOM, {"Empty payload", false, 0, {}, {}}),
+        mac(NEAR_OUI, {"Near-miss OUI 58:8e:80", false, 0, {},
+            cat({FLAGS, adText(0x09, "Tracker")})}),
+    };
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_labelled_fixtures(void) {
+    std::vector<Fixture> all = fixtures();
+    int positives = 0, negatives = 0;
+    for (const Fixture& f : all) {
+        FYAdvert a;
+        fyParseAdvert(f.mac, f.payload.data(), f.payload.size(), services, a);
+        uint8_t signals = fyEvalRules(rules, a, ouis, mfrIds, names);
+        bool detected = fyScoreSignals(signals) >= FY_SCORE_DETECT;
+        TEST_ASSERT_EQUAL_HEX8_MESSAGE(f.signals, signals, f.label);
+        TEST_ASSERT_TRUE_MESSAGE(detected == f.flock, f.label);
+        (f.flock ? positives : negatives)++;
+    }
+    char line[64];
+    snprintf(line, sizeof(line), "%d positive and %d negative fixtures", positives, negatives);
+    TEST_MESSAGE(line);
+}
+
+void test_score_and_method(void) {
+    TEST_ASSERT_EQUAL_UINT8(0, fyScoreSignals(0));
+    TEST_ASSERT_EQUAL_UINT8(90, fyScoreSignals(FY_SIG_BIT(FY_SIG_MAC_OUI) | FY_SIG_BIT(FY_SIG_NAME)));
+    TEST_ASSERT_EQUAL_UINT8(FY_SCORE_MAX, fyScoreSignals(0xFF));
+    TEST_ASSERT_EQUAL_STRING("device_name", fySignalMethod(FY_SIG_BIT(FY_SIG_MAC_OUI) | FY_SIG_BIT(FY_SIG_NAME)));
+    TEST_ASSERT_EQUAL_STRING("", fySignalMethod(0));
+
+    // Each of the first four signals is a detection alone; the others never are
+    for (int s = 0; s < FY_SIG_COUNT; s++) {
+        bool alone = fyScoreSignals(FY_SIG_BIT(s)) >= FY_SCORE_DETECT;
+        TEST_ASSERT_TRUE(alone == (s <= FY_SIG_RAVEN_SVC));
+    }
+}
+
+void test_compile_drops_empty_tables(void) {
+    std::vector<FYRule> none;
+    fyCompileRules(none, false, false, false, 0);
+    TEST_ASSERT_EQUAL_size_t(0, none.size());
+
+    // One service role cannot make FY_SIG_RAVEN_MULTI
+    std::vector<FYRule> one;
+    fyCompileRules(one, false, false, false, FY_SVC_BIT(FY_SVC_GPS));
+    TEST_ASSERT_EQUAL_size_t(1, one.size());
+    TEST_ASSERT_EQUAL_UINT8(FY_OP_SVC_ANY, one[0].op);
+
+    // With no name rule a matching name is never looked at
+    std::vector<FYRule> noNames;
+    fyCompileRules(noNames, true, false, true, 0);
+    const uint8_t mac[6] = {0x5A, 0, 0, 0, 0, 1};
+    Bytes p = adText(0x09, "Flock");
+    FYAdvert a;
+    fyParseAdvert(mac, p.data(), p.size(), services, a);
+    TEST_ASSERT_EQUAL_HEX8(0, fyEvalRules(noNames, a, ouis, mfrIds, names));
+}
+
+void test_parse_fields(void) {
+    const uint8_t mac[6] = {1, 2, 3, 4, 5, 6};
+    FYAdvert a;
+
+    // Complete name wins whichever order the structures come in
+    Bytes p = cat({adText(0x09, "Complete"), adText(0x08, "Short")});
+    fyParseAdvert(mac, p.data(), p.size(), services, a);
+    TEST_ASSERT_EQUAL_STRING("Complete", a.name);
+    p = cat({adText(0x08, "Short"), adText(0x09, "Complete")});
+    fyParseAdvert(mac, p.data(), p.size(), services, a);
+    TEST_ASSERT_EQUAL_STRING("Complete", a.name);
+    TEST_ASSERT_EQUAL_PTR(mac, a.mac);
+
+    // Long names are cut to the buffer
+    std::string longName(40, 'x');
+    p = adText(0x09, longName.c_str());
+    fyParseAdvert(mac, p.data(), p.size(), services, a);
+    TEST_ASSERT_EQUAL_size_t(FY_ADV_NAME_MAX - 1, strlen(a.name));
+
+    // At most FY_ADV_MAX_MFR company IDs, in order
+    p = cat({adMfr(1), adMfr(2), adMfr(3), adMfr(4), adMfr(5)});
+    fyParseAdvert(mac, p.data(), p.size(), services, a);
+    TEST_ASSERT_EQUAL_UINT8(FY_ADV_MAX_MFR, a.mfrCount);
+    TEST_ASSERT_EQUAL_UINT16(1, a.mfr[0]);
+    TEST_ASSERT_EQUAL_UINT16(4, a.mfr[3]);
+
+    // Several UUIDs in one structure; a trailing partial UUID is ignored
+    p = adUuid128(0x07, {RAVEN_GPS_SERVICE, RAVEN_ERROR_SERVICE});
+    p[0] += 3;
+    p.insert(p.end(), {0xAA, 0xBB, 0xCC});
+    fyParseAdvert(mac, p.data(), p.size(), services, a);
+    TEST_ASSERT_EQUAL_HEX32(FY_SVC_BIT(FY_SVC_GPS) | FY_SVC_BIT(FY_SVC_ERROR), a.svcMask);
+
+    fyParseAdvert(mac, nullptr, 0, services, a);
+    TEST_ASSERT_EQUAL_STRING("", a.name);
+    TEST_ASSERT_EQUAL_UINT8(0, a.mfrCount);
+    TEST_ASSERT_EQUAL_HEX32(0, a.svcMask);
+}
+
+static uint64_t rngState = 0x9E3779B97F4A7C15ULL;
+
+static uint32_t nextRandom() {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 7;
+    rngState ^= rngState << 17;
+    return (uint32_t)rngState;
+}
+
+// Random bytes, and random AD structures with lying lengths: the parser
+// must stay inside the buffer (run under -fsanitize=address to check)
+void test_fuzz_stays_in_bounds(void) {
+    const uint8_t mac[6] = {0x58, 0x8E, 0x81, 0, 0, 0};
+    static const uint8_t types[] = {0x01, 0x06, 0x07, 0x08, 0x09, 0xFF, 0x03};
+    for (int iter = 0; iter < 100000; iter++) {
+        size_t len = nextRandom() % 63;
+        Bytes p(len);
+        for (size_t i = 0; i < len; i++) p[i] = (uint8_t)nextRandom();
+        if (iter & 1) {
+            for (size_t i = 0; i + 1 < len; i += 1 + p[i]) {
+                p[i] = (uint8_t)(nextRandom() % 24);
+                p[i + 1] = types[nextRandom() % sizeof(types)];
+            }
+        }
+        // Exact-size heap copy so any overrun is caught
+        std::unique_ptr<uint8_t[]> exact(new uint8_t[len ? len : 1]);
+        memcpy(exact.get(), p.data(), len);
+        FYAdvert a;
+        fyParseAdvert(mac, exact.get(), len, services, a);
+        TEST_ASSERT_TRUE(strlen(a.name) < FY_ADV_NAME_MAX);
+        TEST_ASSERT_TRUE(a.mfrCount <= FY_ADV_MAX_MFR);
+        fyEvalRules(rules, a, ouis, mfrIds, names);
+    }
+}
+
+void test_bench_parse_and_eval(void) {
+    std::vector<Fixture> all = fixtures();
+    const int rounds = 20000;
+    unsigned sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (const Fixture& f : all) {
+            FYAdvert a;
+            fyParseAdvert(f.mac, f.payload.data(), f.payload.size(), services, a);
+            sink += fyEvalRules(rules, a, ouis, mfrIds, names);
+        }
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    char line[96];
+    snprintf(line, sizeof(line), "parse + evaluate: %.0f ns per advertisement (sink %u)",
+             ns / (rounds * all.size()), sink);
+    TEST_MESSAGE(line);
+}
+
+int main(int argc, char** argv) {
+    fyRavenServices(services);
+    names.build(namePatterns, sizeof(namePatterns) / sizeof(namePatterns[0]));
+    uint32_t svcBits = 0;
+    for (const FYSigService& s : services) svcBits |= FY_SVC_BIT(s.bit);
+    fyCompileRules(rules, true, true, true, svcBits);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_labelled_fixtures);
+    RUN_TEST(test_score_and_method);
+    RUN_TEST(test_compile_drops_empty_tables);
+    RUN_TEST(test_parse_fields);
+    RUN_TEST(test_fuzz_stays_in_bounds);
+    RUN_TEST(test_bench_parse_and_eval);
+    return UNITY_END();
+}
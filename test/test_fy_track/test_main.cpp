@@ -0,0 +1,236 @@
+/*
+ * Track blocks: varint and zigzag coding, block encode/decode round trips
+ * for a simulated drive, CRC coverage and damaged data.
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include "fy_track.h"
+
+struct Point {
+    uint32_t t;
+    int32_t lat, lon;
+};
+
+static uint64_t rngState = 0x9E3779B97F4A7C15ULL;
+
+static uint32_t nextRandom() {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 7;
+    rngState ^= rngState << 17;
+    return (uint32_t)rngState;
+}
+
+// 1 Hz fixes at ~15 m/s with gentle turns, skipping a few seconds now and then
+static std::vector<Point> simulateDrive(size_t count) {
+    std::vector<Point> pts;
+    double lat = 40.712800, lon = -74.006000, heading = 0.3;
+    uint32_t t = 120;
+    for (size_t i = 0; i < count; i++) {
+        pts.push_back({t, (int32_t)lround(lat * FY_TRACK_SCALE), (int32_t)lround(lon * FY_TRACK_SCALE)});
+        heading += ((int)(nextRandom() % 21) - 10) * 0.01;
+        double metres = 10 + nextRandom() % 10;
+        lat += metres * cos(heading) / 111320.0;
+        lon += metres * sin(heading) / (111320.0 * cos(lat * M_PI / 180.0));
+        t += (nextRandom() % 8 == 0) ? 2 + nextRandom() % 5 : 1;
+    }
+    return pts;
+}
+
+// Pack points into as many blocks as they need, the way fyTrackSample() does
+static std::vector<FYTrackBlock> encode(const std::vector<Point>& pts) {
+    std::vector<FYTrackBlock> blocks;
+    FYTrackBlock b;
+    memset(&b, 0, sizeof(b));
+    for (size_t i = 0; i < pts.size(); i++) {
+        const Point& p = pts[i];
+        if (i == 0 || !fyTrackBlockAppend(b, p.t - pts[i - 1].t, p.lat - pts[i - 1].lat, p.lon - pts[i - 1].lon)) {
+            if (b.count > 0) {
+                b.crc = fyTrackCrc(b);
+                blocks.push_back(b);
+            }
+            fyTrackBlockStart(b, (uint32_t)blocks.size() + 1, 7, p.t, p.lat, p.lon);
+        }
+    }
+    if (b.count > 0) {
+        b.crc = fyTrackCrc(b);
+        blocks.push_back(b);
+    }
+    return blocks;
+}
+
+static std::vector<Point> decode(const std::vector<FYTrackBlock>& blocks) {
+    std::vector<Point> pts;
+    for (const FYTrackBlock& b : blocks) {
+        TEST_ASSERT_TRUE(fyTrackValid(b));
+        FYTrackReader r;
+        memset(&r, 0, sizeof(r));
+        while (fyTrackBlockNext(b, r)) pts.push_back({r.t, r.lat, r.lon});
+    }
+    return pts;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_varint_round_trip_and_lengths(void) {
+    const uint32_t values[] = {0, 1, 127, 128, 16383, 16384, 2097151, 2097152, 268435455, 268435456, 0xFFFFFFFF};
+    const int lengths[]     = {1, 1, 1,   2,   2,     3,     3,       4,       4,         5,         5};
+    uint8_t buf[5 * 11];
+    uint16_t len = 0;
+    for (int i = 0; i < 11; i++) {
+        int n = fyPutVarint(buf + len, values[i]);
+        TEST_ASSERT_EQUAL_INT(lengths[i], n);
+        len += n;
+    }
+    uint16_t pos = 0;
+    for (int i = 0; i < 11; i++) {
+        uint32_t v;
+        TEST_ASSERT_TRUE(fyGetVarint(buf, len, pos, v));
+        TEST_ASSERT_EQUAL_HEX32(values[i], v);
+    }
+    TEST_ASSERT_EQUAL_UINT16(len, pos);
+}
+
+void test_varint_rejects_truncated_and_overlong(void) {
+    uint8_t buf[6];
+    int n = fyPutVarint(buf, 300000);
+    uint16_t pos = 0;
+    uint32_t v;
+    TEST_ASSERT_FALSE(fyGetVarint(buf, (uint16_t)(n - 1), pos, v));
+    memset(buf, 0x80, sizeof(buf));  // Continuation bit never clears
+    pos = 0;
+    TEST_ASSERT_FALSE(fyGetVarint(buf, sizeof(buf), pos, v));
+}
+
+void test_zigzag(void) {
+    TEST_ASSERT_EQUAL_UINT32(0, fyZigzag(0));
+    TEST_ASSERT_EQUAL_UINT32(1, fyZigzag(-1));
+    TEST_ASSERT_EQUAL_UINT32(2, fyZigzag(1));
+    TEST_ASSERT_EQUAL_UINT32(0xFFFFFFFF, fyZigzag(INT32_MIN));
+    TEST_ASSERT_EQUAL_UINT32(0xFFFFFFFE, fyZigzag(INT32_MAX));
+    const int32_t values[] = {0, -1, 1, -64, 64, 123456, -123456, INT32_MIN, INT32_MAX};
+    for (int32_t v : values) TEST_ASSERT_EQUAL_INT32(v, fyUnzigzag(fyZigzag(v)));
+}
+
+void test_single_point_block(void) {
+    FYTrackBlock b;
+    fyTrackBlockStart(b, 1, 3, 42, 4071280, -7400600);
+    b.crc = fyTrackCrc(b);
+    TEST_ASSERT_TRUE(fyTrackValid(b));
+    FYTrackReader r;
+    memset(&r, 0, sizeof(r));
+    TEST_ASSERT_TRUE(fyTrackBlockNext(b, r));
+    TEST_ASSERT_EQUAL_UINT32(42, r.t);
+    TEST_ASSERT_EQUAL_INT32(4071280, r.lat);
+    TEST_ASSERT_EQUAL_INT32(-7400600, r.lon);
+    TEST_ASSERT_FALSE(fyTrackBlockNext(b, r));
+}
+
+void test_drive_round_trip_and_density(void) {
+    std::vector<Point> pts = simulateDrive(20000);
+    std::vector<FYTrackBlock> blocks = encode(pts);
+    std::vector<Point> back = decode(blocks);
+
+    TEST_ASSERT_EQUAL_size_t(pts.size(), back.size());
+    for (size_t i = 0; i < pts.size(); i++) {
+        TEST_ASSERT_EQUAL_UINT32(pts[i].t, back[i].t);
+        TEST_ASSERT_EQUAL_INT32(pts[i].lat, back[i].lat);
+        TEST_ASSERT_EQUAL_INT32(pts[i].lon, back[i].lon);
+    }
+
+    size_t data = 0;
+    for (const FYTrackBlock& b : blocks) {
+        TEST_ASSERT_TRUE(b.len <= sizeof(b.data));
+        data += b.len;
+    }
+    double perPoint = (double)data / (pts.size() - blocks.size());
+    double flashPerPoint = (double)blocks.size() * FY_TRACK_BLOCK / pts.size();
+    char line[120];
+    snprintf(line, sizeof(line), "%u points in %u blocks: %.2f data bytes/point, %.2f flash bytes/point",
+             (unsigned)pts.size(), (unsigned)blocks.size(), perPoint, flashPerPoint);
+    TEST_MESSAGE(line);
+    TEST_ASSERT_TRUE(perPoint <= 5.0);
+}
+
+void test_large_jumps_still_round_trip(void) {
+    // A GPS glitch across the globe, and a long gap in time
+    std::vector<Point> pts = {
+        {0, 0, 0}, {1, 9000000, 18000000}, {2, -9000000, -18000000}, {100000, 1, -1}, {0xFFFFFFF0, 5, 5}
+    };
+    std::vector<Point> back = decode(encode(pts));
+    TEST_ASSERT_EQUAL_size_t(pts.size(), back.size());
+    for (size_t i = 0; i < pts.size(); i++) {
+        TEST_ASSERT_EQUAL_UINT32(pts[i].t, back[i].t);
+        TEST_ASSERT_EQUAL_INT32(pts[i].lat, back[i].lat);
+        TEST_ASSERT_EQUAL_INT32(pts[i].lon, back[i].lon);
+    }
+}
+
+void test_crc_covers_header_and_used_data(void) {
+    std::vector<FYTrackBlock> blocks = encode(simulateDrive(50));
+    FYTrackBlock b = blocks[0];
+    TEST_ASSERT_TRUE(fyTrackValid(b));
+
+    FYTrackBlock bad = b;
+    bad.lat0++;
+    TEST_ASSERT_FALSE(fyTrackValid(bad));
+    bad = b;
+    bad.data[b.len - 1] ^= 0x01;
+    TEST_ASSERT_FALSE(fyTrackValid(bad));
+    bad = b;
+    bad.len = sizeof(bad.data) + 1;
+    TEST_ASSERT_FALSE(fyTrackValid(bad));
+    bad = b;
+    bad.count = 0;
+    TEST_ASSERT_FALSE(fyTrackValid(bad));
+
+    // Bytes past len are not part of the block
+    bad = b;
+    bad.data[sizeof(bad.data) - 1] ^= 0xFF;
+    TEST_ASSERT_TRUE(fyTrackValid(bad));
+}
+
+void test_damaged_data_stops_the_block(void) {
+    std::vector<FYTrackBlock> blocks = encode(simulateDrive(30));
+    FYTrackBlock b = blocks[0];
+    b.len = 7;  // Cut mid-point: only the first two points decode
+    FYTrackReader r;
+    memset(&r, 0, sizeof(r));
+    int points = 0;
+    while (fyTrackBlockNext(b, r)) points++;
+    TEST_ASSERT_TRUE(points >= 2 && points < b.count);
+    TEST_ASSERT_FALSE(fyTrackBlockNext(b, r));
+}
+
+void test_full_block_refuses_points(void) {
+    FYTrackBlock b;
+    fyTrackBlockStart(b, 1, 1, 0, 0, 0);
+    int added = 0;
+    while (fyTrackBlockAppend(b, 0xFFFFFFFF, INT32_MIN, INT32_MIN)) added++;
+    TEST_ASSERT_EQUAL_INT((int)(sizeof(b.data) / FY_TRACK_POINT_MAX), added);
+    uint16_t len = b.len;
+    TEST_ASSERT_FALSE(fyTrackBlockAppend(b, 1, 1, 1));
+    TEST_ASSERT_EQUAL_UINT16(len, b.len);
+
+    FYTrackBlock empty;
+    memset(&empty, 0, sizeof(empty));
+    TEST_ASSERT_FALSE(fyTrackBlockAppend(empty, 1, 1, 1));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_varint_round_trip_and_lengths);
+    RUN_TEST(test_varint_rejects_truncated_and_overlong);
+    RUN_TEST(test_zigzag);
+    RUN_TEST(test_single_point_block);
+    RUN_TEST(test_drive_round_trip_and_density);
+    RUN_TEST(test_large_jumps_still_round_trip);
+    RUN_TEST(test_crc_covers_header_and_used_data);
+    RUN_TEST(test_damaged_data_stops_the_block);
+    RUN_TEST(test_full_block_refuses_points);
+    return UNITY_END();
+}
@@ -0,0 +1,169 @@
+/*
+ * MacWatchlist: parsing, precedence and lookup throughput at 10, 1k and
+ * 50k filters (pio test -e native -v shows the benchmark lines).
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "mac_watchlist.h"
+
+static uint64_t rngState = 0x9E3779B97F4A7C15ULL;
+
+static uint64_t nextRandom() {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 7;
+    rngState ^= rngState << 17;
+    return rngState;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_parse_mac_key(void) {
+    uint64_t key;
+    TEST_ASSERT_EQUAL_INT(3, parseMACKey("58:8E:81", key));
+    TEST_ASSERT_EQUAL_HEX64(0x588E81ULL, key);
+    TEST_ASSERT_EQUAL_INT(6, parseMACKey("aa-bb-cc-dd-ee-ff", key));
+    TEST_ASSERT_EQUAL_HEX64(0xAABBCCDDEEFFULL, key);
+    TEST_ASSERT_EQUAL_INT(6, parseMACKey("aa bb cc dd ee 0f", key));
+    TEST_ASSERT_EQUAL_HEX64(0xAABBCCDDEE0FULL, key);
+    TEST_ASSERT_EQUAL_INT(0, parseMACKey("aa:bb", key));
+    TEST_ASSERT_EQUAL_INT(0, parseMACKey("aa:bb:cc:dd", key));
+    TEST_ASSERT_EQUAL_INT(0, parseMACKey("aa:bb:cc:dd:ee:ff:00", key));
+    TEST_ASSERT_EQUAL_INT(0, parseMACKey("zz:bb:cc", key));
+    TEST_ASSERT_EQUAL_INT(0, parseMACKey("", key));
+}
+
+void test_native_and_format_round_trip(void) {
+    // NimBLE keeps the last octet first
+    const uint8_t native[6] = {0xff, 0xee, 0xdd, 0xcc, 0xbb, 0xaa};
+    uint64_t key = macKeyFromNative(native);
+    TEST_ASSERT_EQUAL_HEX64(0xAABBCCDDEEFFULL, key);
+    char text[18];
+    formatMACKey(key, text, sizeof(text));
+    TEST_ASSERT_EQUAL_STRING("aa:bb:cc:dd:ee:ff", text);
+    uint64_t back;
+    TEST_ASSERT_EQUAL_INT(6, parseMACKey(text, back));
+    TEST_ASSERT_EQUAL_HEX64(key, back);
+}
+
+void test_oui_and_full_mac_match(void) {
+    MacWatchlist w;
+    TEST_ASSERT_TRUE(w.add("58:8e:81", false, 0));
+    TEST_ASSERT_TRUE(w.add("11:22:33:44:55:66", true, 1));
+    w.build();
+    TEST_ASSERT_EQUAL_size_t(0, w.find(0x588E81000001ULL));
+    TEST_ASSERT_EQUAL_size_t(0, w.find(0x588E81FFFFFFULL));
+    TEST_ASSERT_EQUAL_size_t(1, w.find(0x112233445566ULL));
+    TEST_ASSERT_EQUAL_size_t(MAC_WATCHLIST_NONE, w.find(0x112233445567ULL));
+    TEST_ASSERT_EQUAL_size_t(MAC_WATCHLIST_NONE, w.find(0x588E80FFFFFFULL));
+}
+
+void test_first_configured_filter_wins(void) {
+    MacWatchlist w;
+    w.add("aa:bb:cc:00:00:01", true, 0);
+    w.add("aa:bb:cc", false, 1);
+    w.add("dd:ee:ff", false, 2);
+    w.add("dd:ee:ff:00:00:01", true, 3);
+    w.add("dd:ee:ff", false, 4);   // Duplicate OUI, later filter
+    w.build();
+    TEST_ASSERT_EQUAL_size_t(0, w.find(0xAABBCC000001ULL));
+    TEST_ASSERT_EQUAL_size_t(1, w.find(0xAABBCC000002ULL));
+    TEST_ASSERT_EQUAL_size_t(2, w.find(0xDDEEFF000001ULL));
+    TEST_ASSERT_EQUAL_size_t(2, w.find(0xDDEEFF123456ULL));
+}
+
+void test_full_mac_in_oui_list_matches_exactly(void) {
+    MacWatchlist w;
+    TEST_ASSERT_TRUE(w.add("aa:bb:cc:dd:ee:ff", false, 0));
+    w.build();
+    TEST_ASSERT_EQUAL_size_t(1, w.macCount());
+    TEST_ASSERT_EQUAL_size_t(0, w.ouiCount());
+    TEST_ASSERT_EQUAL_size_t(0, w.find(0xAABBCCDDEEFFULL));
+    TEST_ASSERT_EQUAL_size_t(MAC_WATCHLIST_NONE, w.find(0xAABBCCDDEE00ULL));
+}
+
+void test_rejected_identifiers(void) {
+    MacWatchlist w;
+    TEST_ASSERT_FALSE(w.add("aa:bb:cc", true, 0));      // OUI in the full-MAC list
+    TEST_ASSERT_FALSE(w.add("not a mac", false, 1));
+    TEST_ASSERT_FALSE(w.add("aa:bb:cc", false, MAC_WATCHLIST_MAX));
+    w.build();
+    TEST_ASSERT_EQUAL_size_t(0, w.macCount() + w.ouiCount());
+    TEST_ASSERT_EQUAL_size_t(MAC_WATCHLIST_NONE, w.find(0xAABBCC000000ULL));
+}
+
+void test_clear_and_rebuild(void) {
+    MacWatchlist w;
+    w.add("aa:bb:cc", false, 0);
+    w.build();
+    w.clear();
+    w.add("11:22:33", false, 0);
+    w.build();
+    TEST_ASSERT_EQUAL_size_t(MAC_WATCHLIST_NONE, w.find(0xAABBCC000000ULL));
+    TEST_ASSERT_EQUAL_size_t(0, w.find(0x112233000000ULL));
+}
+
+// Half OUIs, half full MACs; half the lookups are addresses on the list
+static void benchmarkFilters(size_t filters) {
+    std::vector<std::string> ids;
+    std::vector<uint64_t> listed;
+    char text[18];
+    for (size_t i = 0; i < filters; i++) {
+        uint64_t mac = nextRandom() & 0xFFFFFFFFFFFFULL;
+        formatMACKey(mac, text, sizeof(text));
+        if (i & 1) {
+            ids.push_back(text);
+        } else {
+            ids.push_back(std::string(text, 8));
+            mac = (mac & 0xFFFFFF000000ULL) | (nextRandom() & 0xFFFFFF);
+        }
+        listed.push_back(mac);
+    }
+
+    MacWatchlist w;
+    for (size_t i = 0; i < ids.size(); i++) w.add(ids[i].c_str(), (i & 1) != 0, i);
+    w.build();
+
+    const size_t lookups = 2000000;
+    std::vector<uint64_t> queries(4096);
+    for (size_t i = 0; i < queries.size(); i++) {
+        queries[i] = (i & 1) ? listed[nextRandom() % listed.size()] : (nextRandom() & 0xFFFFFFFFFFFFULL);
+    }
+
+    size_t hits = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < lookups; i++) {
+        if (w.find(queries[i & (queries.size() - 1)]) != MAC_WATCHLIST_NONE) hits++;
+    }
+    double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    char line[120];
+    snprintf(line, sizeof(line), "%6u filters: %.1f M lookups/s (%u hits)",
+             (unsigned)filters, lookups / s / 1e6, (unsigned)hits);
+    TEST_MESSAGE(line);
+    // Every listed address must be found
+    TEST_ASSERT_GREATER_OR_EQUAL(lookups / 2, hits);
+}
+
+void test_benchmark_10_filters(void) { benchmarkFilters(10); }
+void test_benchmark_1k_filters(void) { benchmarkFilters(1000); }
+void test_benchmark_50k_filters(void) { benchmarkFilters(50000); }
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_parse_mac_key);
+    RUN_TEST(test_native_and_format_round_trip);
+    RUN_TEST(test_oui_and_full_mac_match);
+    RUN_TEST(test_first_configured_filter_wins);
+    RUN_TEST(test_full_mac_in_oui_list_matches_exactly);
+    RUN_TEST(test_rejected_identifiers);
+    RUN_TEST(test_clear_and_rebuild);
+    RUN_TEST(test_benchmark_10_filters);
+    RUN_TEST(test_benchmark_1k_filters);
+    RUN_TEST(test_benchmark_50k_filters);
+    return UNITY_END();
+}
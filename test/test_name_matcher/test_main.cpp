@@ -0,0 +1,196 @@
+/*
+ * NameMatcher: every contained pattern is reported, case-folded, matching
+ * a strcasestr() reference; plus a 500-pattern benchmark over a corpus of
+ * BLE advertised names against the per-pattern strcasestr() loop.
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "name_matcher.h"
+
+static uint64_t rngState = 0xD1B54A32D192ED03ULL;
+
+static uint64_t nextRandom() {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 7;
+    rngState ^= rngState << 17;
+    return rngState;
+}
+
+// Sorted indices of the patterns strcasestr() finds in name
+static std::vector<uint16_t> referenceMatch(const std::vector<const char*>& patterns, const char* name) {
+    std::vector<uint16_t> hits;
+    for (size_t i = 0; i < patterns.size(); i++) {
+        if (patterns[i] && patterns[i][0] && strcasestr(name, patterns[i])) hits.push_back((uint16_t)i);
+    }
+    return hits;
+}
+
+static std::vector<uint16_t> automatonMatch(const NameMatcher& m, const char* name) {
+    uint16_t hits[1024];
+    int n = m.match(name, hits, 1024);
+    std::vector<uint16_t> out(hits, hits + n);
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+static void assertSameHits(const std::vector<uint16_t>& expected, const std::vector<uint16_t>& actual, const char* name) {
+    char msg[160];
+    snprintf(msg, sizeof(msg), "name \"%s\"", name);
+    TEST_ASSERT_EQUAL_size_t_MESSAGE(expected.size(), actual.size(), msg);
+    for (size_t i = 0; i < expected.size(); i++) TEST_ASSERT_EQUAL_UINT16_MESSAGE(expected[i], actual[i], msg);
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_empty_matcher_matches_nothing(void) {
+    NameMatcher m;
+    uint16_t hit;
+    TEST_ASSERT_TRUE(m.empty());
+    TEST_ASSERT_EQUAL_INT(0, m.match("Flock", &hit, 1));
+}
+
+void test_builtin_patterns_case_folded(void) {
+    const char* patterns[] = {"FS Ext Battery", "Penguin", "Flock", "Pigvision"};
+    NameMatcher m;
+    TEST_ASSERT_TRUE(m.build(patterns, 4) > 1);
+    uint16_t hits[4];
+    TEST_ASSERT_EQUAL_INT(1, m.match("fs ext battery", hits, 4));
+    TEST_ASSERT_EQUAL_UINT16(0, hits[0]);
+    TEST_ASSERT_EQUAL_INT(1, m.match("PENGUIN-0042", hits, 4));
+    TEST_ASSERT_EQUAL_UINT16(1, hits[0]);
+    TEST_ASSERT_EQUAL_INT(1, m.match("my-flock-cam", hits, 4));
+    TEST_ASSERT_EQUAL_UINT16(2, hits[0]);
+    TEST_ASSERT_EQUAL_INT(0, m.match("Pig vision", hits, 4));
+    TEST_ASSERT_EQUAL_INT(0, m.match("", hits, 4));
+    TEST_ASSERT_EQUAL_INT(0, m.match(NULL, hits, 4));
+}
+
+void test_overlapping_patterns_all_reported(void) {
+    // The textbook set: suffix and dict links both matter
+    std::vector<const char*> patterns = {"he", "she", "his", "hers", "", NULL, "s", "she"};
+    NameMatcher m;
+    m.build(patterns.data(), patterns.size());
+    const char* names[] = {"ushers", "SHE", "ahishers", "xyz", "hhhhers"};
+    for (const char* name : names) assertSameHits(referenceMatch(patterns, name), automatonMatch(m, name), name);
+}
+
+void test_max_hits_stops_early(void) {
+    const char* patterns[] = {"a", "ab", "abc"};
+    NameMatcher m;
+    m.build(patterns, 3);
+    uint16_t hits[3];
+    TEST_ASSERT_EQUAL_INT(1, m.match("abc", hits, 1));
+    TEST_ASSERT_EQUAL_INT(0, m.match("abc", hits, 0));
+    TEST_ASSERT_EQUAL_INT(3, m.match("xxabcxx", hits, 3));
+}
+
+void test_random_patterns_match_reference(void) {
+    // Small alphabet so patterns overlap heavily
+    std::vector<std::string> storage;
+    for (int i = 0; i < 200; i++) {
+        std::string p;
+        int len = 1 + nextRandom() % 5;
+        for (int c = 0; c < len; c++) p += "abcAB"[nextRandom() % 5];
+        storage.push_back(p);
+    }
+    std::vector<const char*> patterns;
+    for (const std::string& s : storage) patterns.push_back(s.c_str());
+    NameMatcher m;
+    m.build(patterns.data(), patterns.size());
+
+    for (int t = 0; t < 500; t++) {
+        std::string name;
+        int len = nextRandom() % 24;
+        for (int c = 0; c < len; c++) name += "abcABx"[nextRandom() % 6];
+        assertSameHits(referenceMatch(patterns, name.c_str()), automatonMatch(m, name.c_str()), name.c_str());
+    }
+}
+
+// ---- Benchmark -----------------------------------------------------------
+
+static const char* const corpusNames[] = {
+    "JBL Flip 5", "Galaxy Buds2 Pro", "[TV] Samsung 7 Series (55)", "Tile", "Apple Watch",
+    "LE-Bose QC35 II", "Mi Smart Band 6", "Charge 5", "FS Ext Battery", "Penguin-1A2B",
+    "Flock-Cam-7781", "Pigvision 2", "WH-1000XM4", "Jabra Elite 75t", "Forerunner 245",
+    "HUAWEI WATCH GT 2", "Govee_H6159_3A1C", "ELK-BLEDOM", "Echo Dot-7QK", "Polar H10 8F2A1C2B",
+    "Nest Cam", "SoundLink Micro", "Oral-B Toothbrush", "AirPods Pro", "Pixel Buds",
+    "OnePlus Buds Z2", "Blink-Mini-55", "Ring Doorbell", "Wyze Cam v3", "TY", "LG WebOS TV",
+    "Xbox Wireless Controller", "DualSense Wireless Controller", "Logi MX Master 3", "K380",
+    "MJ_HT_V1", "ATC_8A1B2C", "SwitchBot", "Eufy T9146", "LED BLE", "Triones-3F", "BT05", "HC-08",
+    "ESP32-BLE", "Nordic_UART", "TP-LINK Tapo", "Tesla Model 3", "Kia Connect", "iBeacon", "",
+};
+#define CORPUS_SIZE (sizeof(corpusNames) / sizeof(corpusNames[0]))
+#define BENCH_PATTERNS 500
+#define BENCH_ROUNDS 2000
+
+void test_benchmark_500_patterns(void) {
+    // The built-in four plus vendor-like fragments: real words, digits and
+    // punctuation, lengths 3-12
+    static const char* const stems[] = {
+        "cam", "lpr", "plate", "vision", "guard", "eye", "watch", "sense", "track", "patrol",
+        "node", "relay", "hub", "link", "scan", "ops", "det", "alpr", "mesh", "ctrl"
+    };
+    std::vector<std::string> storage = {"FS Ext Battery", "Penguin", "Flock", "Pigvision"};
+    while (storage.size() < BENCH_PATTERNS) {
+        char p[16];
+        snprintf(p, sizeof(p), "%s%c%s%u", stems[nextRandom() % 20], "-_ "[nextRandom() % 3],
+                 stems[nextRandom() % 20], (unsigned)(nextRandom() % 100));
+        storage.push_back(p);
+    }
+    std::vector<const char*> patterns;
+    for (const std::string& s : storage) patterns.push_back(s.c_str());
+
+    NameMatcher m;
+    size_t nodes = m.build(patterns.data(), patterns.size());
+
+    // Same answers before timing anything
+    for (size_t i = 0; i < CORPUS_SIZE; i++) {
+        assertSameHits(referenceMatch(patterns, corpusNames[i]), automatonMatch(m, corpusNames[i]), corpusNames[i]);
+    }
+
+    volatile size_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        for (size_t i = 0; i < CORPUS_SIZE; i++) {
+            for (const char* p : patterns) {
+                if (strcasestr(corpusNames[i], p)) { sink = sink + 1; break; }
+            }
+        }
+    }
+    double linear = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        for (size_t i = 0; i < CORPUS_SIZE; i++) {
+            uint16_t hit;
+            sink = sink + m.match(corpusNames[i], &hit, 1);
+        }
+    }
+    double automaton = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const double names = (double)BENCH_ROUNDS * CORPUS_SIZE;
+    char line[160];
+    snprintf(line, sizeof(line), "%u patterns (%u nodes): strcasestr loop %.0f ns/name, automaton %.0f ns/name (%.0fx)",
+             BENCH_PATTERNS, (unsigned)nodes, linear * 1e9 / names, automaton * 1e9 / names, linear / automaton);
+    TEST_MESSAGE(line);
+    TEST_ASSERT_TRUE(automaton < linear);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_matcher_matches_nothing);
+    RUN_TEST(test_builtin_patterns_case_folded);
+    RUN_TEST(test_overlapping_patterns_all_reported);
+    RUN_TEST(test_max_hits_stops_early);
+    RUN_TEST(test_random_patterns_match_reference);
+    RUN_TEST(test_benchmark_500_patterns);
+    return UNITY_END();
+}
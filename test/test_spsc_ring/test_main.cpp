@@ -0,0 +1,135 @@
+/*
+ * SpscRing: ordering, overflow accounting and a two-thread stress test
+ * at 10k events/s, the producer paced like a busy NimBLE host task.
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <chrono>
+#include <atomic>
+#include <thread>
+#include "spsc_ring.h"
+
+struct TestEvent {
+    uint64_t seq;
+    uint64_t check;  // Derived from seq, catches torn slot copies
+    int8_t rssi;
+};
+
+static TestEvent makeEvent(uint64_t seq) {
+    return {seq, seq * 0x9E3779B97F4A7C15ULL, (int8_t)(-(int)(seq % 100))};
+}
+
+static bool eventIntact(const TestEvent& e) {
+    return e.check == e.seq * 0x9E3779B97F4A7C15ULL && e.rssi == (int8_t)(-(int)(e.seq % 100));
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_fifo_order_and_batches(void) {
+    SpscRing<TestEvent, 8> ring;
+    TestEvent out[8];
+    TEST_ASSERT_EQUAL_size_t(0, ring.popBatch(out, 8));
+    for (uint64_t i = 0; i < 5; i++) TEST_ASSERT_TRUE(ring.push(makeEvent(i)));
+    TEST_ASSERT_EQUAL_size_t(3, ring.popBatch(out, 3));
+    TEST_ASSERT_EQUAL_UINT64(0, out[0].seq);
+    TEST_ASSERT_EQUAL_UINT64(2, out[2].seq);
+    TEST_ASSERT_EQUAL_size_t(2, ring.popBatch(out, 8));
+    TEST_ASSERT_EQUAL_UINT64(3, out[0].seq);
+    TEST_ASSERT_EQUAL_UINT64(4, out[1].seq);
+}
+
+void test_full_ring_counts_overflow(void) {
+    SpscRing<TestEvent, 4> ring;
+    for (uint64_t i = 0; i < 4; i++) TEST_ASSERT_TRUE(ring.push(makeEvent(i)));
+    TEST_ASSERT_FALSE(ring.push(makeEvent(4)));
+    TEST_ASSERT_FALSE(ring.push(makeEvent(5)));
+    TEST_ASSERT_EQUAL_UINT32(2, ring.overflows());
+
+    // Dropped events never appear; the ring keeps the oldest
+    TestEvent out[4];
+    TEST_ASSERT_EQUAL_size_t(4, ring.popBatch(out, 4));
+    TEST_ASSERT_EQUAL_UINT64(3, out[3].seq);
+    TEST_ASSERT_TRUE(ring.push(makeEvent(6)));
+    TEST_ASSERT_EQUAL_size_t(1, ring.popBatch(out, 4));
+    TEST_ASSERT_EQUAL_UINT64(6, out[0].seq);
+}
+
+void test_counters_wrap(void) {
+    // Free-running 32-bit indices: run well past a few wraps of the mask
+    SpscRing<TestEvent, 4> ring;
+    TestEvent out[4];
+    for (uint64_t i = 0; i < 100000; i++) {
+        TEST_ASSERT_TRUE(ring.push(makeEvent(i)));
+        TEST_ASSERT_EQUAL_size_t(1, ring.popBatch(out, 4));
+        TEST_ASSERT_EQUAL_UINT64(i, out[0].seq);
+    }
+}
+
+// Producer pushes `rate` events/s for `seconds`; the consumer drains up
+// to `batch` events every `drainEvery`. Every event must either arrive
+// intact and in order or be counted as an overflow.
+static void stress(unsigned rate, double seconds, size_t batch, std::chrono::microseconds drainEvery) {
+    SpscRing<TestEvent, 64> ring;
+
+    const uint64_t total = (uint64_t)(rate * seconds);
+    std::atomic<bool> done{false};
+    uint64_t received = 0, lastSeq = 0, corrupt = 0, outOfOrder = 0;
+
+    std::thread consumer([&] {
+        TestEvent out[64];
+        bool first = true;
+        for (;;) {
+            bool finished = done.load(std::memory_order_acquire);
+            size_t n = ring.popBatch(out, batch);
+            for (size_t i = 0; i < n; i++) {
+                if (!eventIntact(out[i])) corrupt++;
+                if (!first && out[i].seq <= lastSeq) outOfOrder++;
+                lastSeq = out[i].seq;
+                first = false;
+            }
+            received += n;
+            if (finished && n == 0) break;
+            std::this_thread::sleep_for(drainEvery);
+        }
+    });
+
+    // Paced in 1 ms bursts, the way adverts arrive in clumps per scan window
+    auto start = std::chrono::steady_clock::now();
+    const unsigned perMs = rate / 1000;
+    for (uint64_t seq = 0; seq < total;) {
+        for (unsigned i = 0; i < perMs && seq < total; i++) ring.push(makeEvent(seq++));
+        std::this_thread::sleep_until(start + std::chrono::microseconds(seq * 1000000ULL / rate));
+    }
+    done.store(true, std::memory_order_release);
+    consumer.join();
+
+    char line[160];
+    snprintf(line, sizeof(line), "%u/s, drain %zu per %lld us: %llu received, %u dropped",
+             rate, batch, (long long)drainEvery.count(), (unsigned long long)received, ring.overflows());
+    TEST_MESSAGE(line);
+
+    TEST_ASSERT_EQUAL_UINT64(0, corrupt);
+    TEST_ASSERT_EQUAL_UINT64(0, outOfOrder);
+    TEST_ASSERT_EQUAL_UINT64(total, received + ring.overflows());
+}
+
+void test_stress_10k_per_second_fast_consumer(void) {
+    stress(10000, 2.0, 64, std::chrono::microseconds(500));
+}
+
+void test_stress_10k_per_second_loop_cadence(void) {
+    // Detector's loop(): 16 events per ~100 ms iteration, so most overflow
+    stress(10000, 1.0, 16, std::chrono::microseconds(100000));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_fifo_order_and_batches);
+    RUN_TEST(test_full_ring_counts_overflow);
+    RUN_TEST(test_counters_wrap);
+    RUN_TEST(test_stress_10k_per_second_fast_consumer);
+    RUN_TEST(test_stress_10k_per_second_loop_cadence);
+    return UNITY_END();
+}